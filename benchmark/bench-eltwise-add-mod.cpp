@@ -5,12 +5,14 @@
 
 #include <vector>
 
+#include "bench-util.hpp"
 #include "eltwise/eltwise-add-mod-avx512.hpp"
 #include "eltwise/eltwise-add-mod-internal.hpp"
 #include "hexl/eltwise/eltwise-add-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/streaming-stores.hpp"
 
 namespace intel {
 namespace hexl {
@@ -29,6 +31,7 @@ static void BM_EltwiseVectorVectorAddModNative(
     EltwiseAddModNative(output.data(), input1.data(), input2.data(), input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseVectorVectorAddModNative)
@@ -54,6 +57,7 @@ static void BM_EltwiseVectorVectorAddModAVX512(
     EltwiseAddModAVX512(output.data(), input1.data(), input2.data(), input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseVectorVectorAddModAVX512)
@@ -78,6 +82,7 @@ static void BM_EltwiseVectorScalarAddModNative(
     EltwiseAddModNative(output.data(), input1.data(), input2, input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseVectorScalarAddModNative)
@@ -103,6 +108,7 @@ static void BM_EltwiseVectorScalarAddModAVX512(
     EltwiseAddModAVX512(output.data(), input1.data(), input2, input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseVectorScalarAddModAVX512)
@@ -112,5 +118,33 @@ BENCHMARK(BM_EltwiseVectorScalarAddModAVX512)
     ->Args({16384});
 #endif
 
+//=================================================================
+
+// state[0] is the degree; large enough that the operands exceed the caches
+// state[1] is 1 to write the result with streaming stores, else 0
+// Reports the effective memory bandwidth of the two inputs and the output
+static void BM_EltwiseAddModStreaming(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  bool stream = state.range(1) != 0;
+  uint64_t modulus = 0xffffffffffc0001ULL;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 0);
+
+  SetStreamingStoreThreshold(stream ? input_size : 0);
+  state.SetLabel(stream ? "streaming" : "regular");
+  for (auto _ : state) {
+    EltwiseAddMod(output.data(), input1.data(), input2.data(), input_size,
+                  modulus);
+  }
+  SetStreamingStoreThreshold(0);
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseAddModStreaming)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1 << 20, 1 << 22, 1 << 24}, {0, 1}});
+
 }  // namespace hexl
 }  // namespace intel
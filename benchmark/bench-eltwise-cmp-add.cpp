@@ -6,6 +6,7 @@
 #include <random>
 #include <vector>
 
+#include "bench-util.hpp"
 #include "eltwise/eltwise-cmp-add-avx512.hpp"
 #include "eltwise/eltwise-cmp-add-internal.hpp"
 #include "hexl/eltwise/eltwise-cmp-add.hpp"
@@ -37,6 +38,7 @@ static void BM_EltwiseCmpAddNative(benchmark::State& state) {  //  NOLINT
     EltwiseCmpAddNative(input1.data(), input1.data(), input_size, CMPINT::NLT,
                         bound, diff);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseCmpAddNative)
@@ -68,6 +70,7 @@ static void BM_EltwiseCmpAddAVX512(benchmark::State& state) {  //  NOLINT
     EltwiseCmpAddAVX512(input1.data(), input1.data(), input_size, CMPINT::NLT,
                         bound, diff);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseCmpAddAVX512)
@@ -6,6 +6,7 @@
 #include <random>
 #include <vector>
 
+#include "bench-util.hpp"
 #include "eltwise/eltwise-cmp-sub-mod-avx512.hpp"
 #include "eltwise/eltwise-cmp-sub-mod-internal.hpp"
 #include "hexl/eltwise/eltwise-cmp-sub-mod.hpp"
@@ -38,6 +39,7 @@ static void BM_EltwiseCmpSubModNative(benchmark::State& state) {  //  NOLINT
     EltwiseCmpSubModNative(input1.data(), input1.data(), input_size, modulus,
                            CMPINT::NLT, bound, diff);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseCmpSubModNative)
@@ -70,6 +72,7 @@ static void BM_EltwiseCmpSubModAVX512(benchmark::State& state) {  //  NOLINT
     EltwiseCmpSubModAVX512(input1.data(), input1.data(), input_size, modulus,
                            CMPINT::NLT, bound, diff);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseCmpSubModAVX512)
@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "bench-util.hpp"
 #include "eltwise/eltwise-fma-mod-avx512.hpp"
 #include "eltwise/eltwise-fma-mod-internal.hpp"
 #include "hexl/eltwise/eltwise-fma-mod.hpp"
@@ -17,6 +18,64 @@ namespace hexl {
 
 //=================================================================
 
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is 1 to add a third operand, 0 to compute only the product
+// Sweeps the degree and modulus, labelling each run with the selected kernel
+static void BM_EltwiseFMAModSweep(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  bool add = state.range(2) != 0;
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> op1(input_size, 1);
+  uint64_t op2 = 1;
+  AlignedVector64<uint64_t> op3(input_size, 2);
+  const uint64_t* arg3 = add ? op3.data() : nullptr;
+
+  state.SetLabel(KernelVariantName(EltwiseFMAModKernel(modulus, 1)));
+  for (auto _ : state) {
+    EltwiseFMAMod(op1.data(), op1.data(), op2, arg3, op1.size(), modulus, 1);
+  }
+  SetEltwiseCounters(state, op1.size(), add ? 2 : 1);
+}
+
+BENCHMARK(BM_EltwiseFMAModSweep)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 17, 2),
+                   {20, 30, 40, 49, 50, 51, 52, 60},
+                   {0, 1}});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the output_mod_factor
+static void BM_EltwiseFMAModLazyOutput(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  size_t output_mod_factor = state.range(2);
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> op1(input_size, 1);
+  uint64_t op2 = 1;
+  AlignedVector64<uint64_t> op3(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  state.SetLabel(KernelVariantName(EltwiseFMAModKernel(modulus, 1)));
+  for (auto _ : state) {
+    EltwiseFMAMod(output.data(), op1.data(), op2, op3.data(), op1.size(),
+                  modulus, 1, output_mod_factor);
+  }
+  SetEltwiseCounters(state, op1.size(), 2);
+}
+
+BENCHMARK(BM_EltwiseFMAModLazyOutput)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{4096, 16384}, {30, 48, 60}, {1, 2}});
+
+//=================================================================
+
 // state[0] is the degree
 static void BM_EltwiseFMAModNative(benchmark::State& state) {  //  NOLINT
   size_t input_size = state.range(0);
@@ -30,6 +89,7 @@ static void BM_EltwiseFMAModNative(benchmark::State& state) {  //  NOLINT
     EltwiseFMAMod(op1.data(), op1.data(), op2, op3.data(), op1.size(), modulus,
                   1);
   }
+  SetEltwiseCounters(state, op1.size(), 2);
 }
 
 BENCHMARK(BM_EltwiseFMAModNative)
@@ -54,6 +114,7 @@ static void BM_EltwiseFMAModAVX512DQ(benchmark::State& state) {  //  NOLINT
     EltwiseFMAModAVX512<64, 1>(input1.data(), input1.data(), input2,
                                input3.data(), input_size, modulus);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseFMAModAVX512DQ)
@@ -79,6 +140,7 @@ static void BM_EltwiseFMAModAVX512IFMA(benchmark::State& state) {  //  NOLINT
     EltwiseFMAModAVX512<52, 1>(input1.data(), input1.data(), input2,
                                input3.data(), input_size, modulus);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseFMAModAVX512IFMA)
@@ -5,12 +5,15 @@
 
 #include <vector>
 
+#include "bench-util.hpp"
 #include "eltwise/eltwise-mult-mod-avx512.hpp"
 #include "eltwise/eltwise-mult-mod-internal.hpp"
 #include "hexl/eltwise/eltwise-mult-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/isa-tier.hpp"
+#include "hexl/util/streaming-stores.hpp"
 
 namespace intel {
 namespace hexl {
@@ -32,6 +35,7 @@ static void BM_EltwiseMultMod(benchmark::State& state) {  //  NOLINT
     EltwiseMultMod(output.data(), input1.data(), input2.data(), input_size,
                    modulus, input_mod_factor);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseMultMod)
@@ -40,6 +44,209 @@ BENCHMARK(BM_EltwiseMultMod)
 
 //=================================================================
 
+// state[0] is the degree
+// state[1] is the bit-width of the modulus. 49 to 52 straddle the bound of
+// the IFMA kernel
+// Sweeps the degree and modulus, labelling each run with the selected kernel
+static void BM_EltwiseMultModSweep(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  state.SetLabel(KernelVariantName(EltwiseMultModKernel(modulus, 1)));
+  for (auto _ : state) {
+    EltwiseMultMod(output.data(), input1.data(), input2.data(), input_size,
+                   modulus, 1);
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModSweep)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 17, 2),
+                   {20, 30, 40, 49, 50, 51, 52, 60}});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the input_mod_factor
+// state[3] is 1 to overwrite the first input, 0 to write a separate output
+static void BM_EltwiseMultModInPlace(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  size_t input_mod_factor = state.range(2);
+  bool in_place = state.range(3) != 0;
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+  uint64_t* result = in_place ? input1.data() : output.data();
+
+  state.SetLabel(
+      KernelVariantName(EltwiseMultModKernel(modulus, input_mod_factor)));
+  for (auto _ : state) {
+    EltwiseMultMod(result, input1.data(), input2.data(), input_size, modulus,
+                   input_mod_factor);
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModInPlace)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{4096, 16384}, {30, 50, 60}, {1, 2, 4}, {0, 1}});
+
+//=================================================================
+
+// state[0] is the degree; large enough that the operands exceed the caches
+// state[1] is the bit-width of the modulus
+// state[2] is 1 to write the result with streaming stores, else 0
+// Reports the effective memory bandwidth of the two inputs and the output
+static void BM_EltwiseMultModStreaming(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  bool stream = state.range(2) != 0;
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  SetStreamingStoreThreshold(stream ? input_size : 0);
+  state.SetLabel(stream ? "streaming" : "regular");
+  for (auto _ : state) {
+    EltwiseMultMod(output.data(), input1.data(), input2.data(), input_size,
+                   modulus, 1);
+  }
+  SetStreamingStoreThreshold(0);
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModStreaming)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1 << 20, 1 << 22, 1 << 24}, {30, 60}, {0, 1}});
+
+//=================================================================
+
+// state[0] is the vector length; short and not always a multiple of 8, as for
+// RNS digits or sparsely-packed plaintexts
+// state[1] is the bit-width of the modulus
+// state[2] is the element offset of the operands from a 64-byte boundary
+static void BM_EltwiseMultModShort(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  size_t offset = state.range(2);
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size + offset, 1);
+  AlignedVector64<uint64_t> input2(input_size + offset, 2);
+  AlignedVector64<uint64_t> output(input_size + offset, 2);
+
+  for (auto _ : state) {
+    EltwiseMultMod(output.data() + offset, input1.data() + offset,
+                   input2.data() + offset, input_size, modulus, 1);
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModShort)
+    ->Unit(benchmark::kNanosecond)
+    ->ArgsProduct({{7, 15, 60, 63, 100, 1000, 1023}, {30, 60}, {0, 1}});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the output_mod_factor
+static void BM_EltwiseMultModLazyOutput(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  size_t output_mod_factor = state.range(2);
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  state.SetLabel(KernelVariantName(EltwiseMultModKernel(modulus, 1)));
+  for (auto _ : state) {
+    EltwiseMultMod(output.data(), input1.data(), input2.data(), input_size,
+                   modulus, 1, output_mod_factor);
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModLazyOutput)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{4096, 16384}, {30, 48, 60}, {1, 2}});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the maximum ISATier, compared side by side in one binary
+static void BM_EltwiseMultModByISATier(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  ISATier tier = static_cast<ISATier>(state.range(2));
+  if (tier > DetectedISATier()) {
+    state.SkipWithError("ISA tier not supported");
+    return;
+  }
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  ScopedMaxISATier max_tier(tier);
+  state.SetLabel(KernelVariantName(EltwiseMultModKernel(modulus, 1)));
+  for (auto _ : state) {
+    EltwiseMultMod(output.data(), input1.data(), input2.data(), input_size,
+                   modulus, 1);
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModByISATier)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1024, 16384}, {48, 60}, {0, 2, 3}});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the input_mod_factor
+// Calls the kernel returned by GetEltwiseMultModKernel, bypassing dispatch
+static void BM_EltwiseMultModKernelPtr(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  size_t input_mod_factor = state.range(2);
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  EltwiseMultModFnPtr kernel =
+      GetEltwiseMultModKernel(modulus, input_mod_factor);
+  for (auto _ : state) {
+    kernel(output.data(), input1.data(), input2.data(), input_size, modulus);
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModKernelPtr)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1024, 8192, 16384}, {48, 60}, {1, 2, 4}});
+
+//=================================================================
+
 // state[0] is the degree
 static void BM_EltwiseMultModNative(benchmark::State& state) {  //  NOLINT
   size_t input_size = state.range(0);
@@ -53,6 +260,7 @@ static void BM_EltwiseMultModNative(benchmark::State& state) {  //  NOLINT
     EltwiseMultModNative<1>(output.data(), input1.data(), input2.data(),
                             input_size, modulus);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseMultModNative)
@@ -91,6 +299,7 @@ static void BM_EltwiseMultModAVX512Float(benchmark::State& state) {  //  NOLINT
         break;
     }
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseMultModAVX512Float)
@@ -136,6 +345,7 @@ static void BM_EltwiseMultModAVX512Int(benchmark::State& state) {  //  NOLINT
         break;
     }
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseMultModAVX512Int)
@@ -153,5 +363,88 @@ BENCHMARK(BM_EltwiseMultModAVX512Int)
 
 //=================================================================
 
+#ifdef HEXL_HAS_AVX512IFMA
+// state[0] is the degree
+// state[1] is the input_mod_factor
+static void BM_EltwiseMultModAVX512IFMA(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t input_mod_factor = state.range(1);
+  size_t modulus = 100;
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  for (auto _ : state) {
+    switch (input_mod_factor) {
+      case 1:
+        EltwiseMultModAVX512IFMA<1>(output.data(), input1.data(),
+                                    input2.data(), input_size, modulus);
+        break;
+      case 2:
+        EltwiseMultModAVX512IFMA<2>(output.data(), input1.data(),
+                                    input2.data(), input_size, modulus);
+        break;
+      case 4:
+        EltwiseMultModAVX512IFMA<4>(output.data(), input1.data(),
+                                    input2.data(), input_size, modulus);
+        break;
+    }
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModAVX512IFMA)
+    ->Unit(benchmark::kMicrosecond)
+    ->Args({1024, 1})
+    ->Args({1024, 2})
+    ->Args({1024, 4})
+    ->Args({4096, 1})
+    ->Args({4096, 2})
+    ->Args({4096, 4})
+    ->Args({16384, 1})
+    ->Args({16384, 2})
+    ->Args({16384, 4});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is 0 for the AVX512Float kernel, 1 for the AVX512IFMA kernel
+// Compares the two kernels for moduli below 2^50 on the same inputs
+static void BM_EltwiseMultModIFMAVsFloat(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  size_t bit_width = state.range(1);
+  bool use_ifma = state.range(2) != 0;
+  uint64_t modulus = (1ULL << bit_width) + 7;
+
+  AlignedVector64<uint64_t> input1(input_size);
+  AlignedVector64<uint64_t> input2(input_size);
+  for (size_t i = 0; i < input_size; ++i) {
+    input1[i] = (i * 0x9E3779B97F4A7C15ULL) % modulus;
+    input2[i] = (i * 0xC2B2AE3D27D4EB4FULL) % modulus;
+  }
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  state.SetLabel(use_ifma ? "AVX512IFMA" : "AVX512Float");
+  for (auto _ : state) {
+    if (use_ifma) {
+      EltwiseMultModAVX512IFMA<1>(output.data(), input1.data(), input2.data(),
+                                  input_size, modulus);
+    } else {
+      EltwiseMultModAVX512Float<1>(output.data(), input1.data(),
+                                   input2.data(), input_size, modulus);
+    }
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_EltwiseMultModIFMAVsFloat)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1024, 4096, 16384}, {30, 40, 45, 48}, {0, 1}});
+#endif
+
+//=================================================================
+
 }  // namespace hexl
 }  // namespace intel
@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "bench-util.hpp"
 #include "eltwise/eltwise-reduce-mod-avx512.hpp"
 #include "eltwise/eltwise-reduce-mod-internal.hpp"
 #include "hexl/eltwise/eltwise-reduce-mod.hpp"
@@ -27,6 +28,7 @@ static void BM_EltwiseReduceModInPlace(benchmark::State& state) {  //  NOLINT
     EltwiseReduceMod(input1.data(), input1.data(), input_size, modulus,
                      input_mod_factor, output_mod_factor);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseReduceModInPlace)
@@ -51,6 +53,7 @@ static void BM_EltwiseReduceModCopy(benchmark::State& state) {  //  NOLINT
     EltwiseReduceMod(output.data(), input1.data(), input_size, modulus,
                      input_mod_factor, output_mod_factor);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseReduceModCopy)
@@ -75,6 +78,7 @@ static void BM_EltwiseReduceModNative(benchmark::State& state) {  //  NOLINT
     EltwiseReduceModNative(output.data(), input1.data(), input_size, modulus,
                            input_mod_factor, output_mod_factor);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseReduceModNative)
@@ -100,6 +104,7 @@ static void BM_EltwiseReduceModAVX512(benchmark::State& state) {  //  NOLINT
     EltwiseReduceModAVX512(output.data(), input1.data(), input_size, modulus,
                            input_mod_factor, output_mod_factor);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseReduceModAVX512)
@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "bench-util.hpp"
 #include "eltwise/eltwise-sub-mod-avx512.hpp"
 #include "eltwise/eltwise-sub-mod-internal.hpp"
 #include "hexl/eltwise/eltwise-sub-mod.hpp"
@@ -29,6 +30,7 @@ static void BM_EltwiseVectorVectorSubModNative(
     EltwiseSubModNative(output.data(), input1.data(), input2.data(), input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseVectorVectorSubModNative)
@@ -54,6 +56,7 @@ static void BM_EltwiseVectorVectorSubModAVX512(
     EltwiseSubModAVX512(output.data(), input1.data(), input2.data(), input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 2);
 }
 
 BENCHMARK(BM_EltwiseVectorVectorSubModAVX512)
@@ -78,6 +81,7 @@ static void BM_EltwiseVectorScalarSubModNative(
     EltwiseSubModNative(output.data(), input1.data(), input2, input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseVectorScalarSubModNative)
@@ -103,6 +107,7 @@ static void BM_EltwiseVectorScalarSubModAVX512(
     EltwiseSubModAVX512(output.data(), input1.data(), input2, input_size,
                         modulus);
   }
+  SetEltwiseCounters(state, input_size, 1);
 }
 
 BENCHMARK(BM_EltwiseVectorScalarSubModAVX512)
@@ -3,12 +3,19 @@
 
 #include <benchmark/benchmark.h>
 
+#include <initializer_list>
+#include <memory>
 #include <vector>
 
+#include "bench-util.hpp"
+#include "hexl/eltwise/eltwise-fma-mod.hpp"
+#include "hexl/eltwise/eltwise-mult-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/ntt/ntt.hpp"
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/huge-page-allocator.hpp"
+#include "hexl/util/isa-tier.hpp"
 #include "ntt/fwd-ntt-avx512.hpp"
 #include "ntt/inv-ntt-avx512.hpp"
 #include "ntt/ntt-internal.hpp"
@@ -28,11 +35,13 @@ static void BM_FwdNTTNative(benchmark::State& state) {  //  NOLINT
   AlignedVector64<uint64_t> input(ntt_size, 1);
   NTT ntt(ntt_size, modulus);
 
+  CycleTimer timer;
   for (auto _ : state) {
     ForwardTransformToBitReverse64(
         input.data(), ntt_size, modulus, ntt.GetRootOfUnityPowers().data(),
         ntt.GetPrecon64RootOfUnityPowers().data(), 2, 1);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_FwdNTTNative)
@@ -57,11 +66,13 @@ static void BM_FwdNTT_AVX512IFMA(benchmark::State& state) {  //  NOLINT
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetAVX512Precon52RootOfUnityPowers();
 
+  CycleTimer timer;
   for (auto _ : state) {
     ForwardTransformToBitReverseAVX512<NTT::s_ifma_shift_bits>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), 2, 1);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_FwdNTT_AVX512IFMA)
@@ -86,11 +97,13 @@ static void BM_FwdNTT_AVX512IFMALazy(benchmark::State& state) {  //  NOLINT
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetAVX512Precon52RootOfUnityPowers();
 
+  CycleTimer timer;
   for (auto _ : state) {
     ForwardTransformToBitReverseAVX512<NTT::s_ifma_shift_bits>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), 4, 4);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_FwdNTT_AVX512IFMALazy)
@@ -121,11 +134,13 @@ static void BM_FwdNTT_AVX512DQ_32(benchmark::State& state) {  //  NOLINT
       ntt.GetAVX512RootOfUnityPowers();
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetAVX512Precon32RootOfUnityPowers();
+  CycleTimer timer;
   for (auto _ : state) {
     ForwardTransformToBitReverseAVX512<32>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), 4, output_mod_factor);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_FwdNTT_AVX512DQ_32)
@@ -152,11 +167,13 @@ static void BM_FwdNTT_AVX512DQ_64(benchmark::State& state) {  //  NOLINT
       ntt.GetAVX512RootOfUnityPowers();
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetAVX512Precon64RootOfUnityPowers();
+  CycleTimer timer;
   for (auto _ : state) {
     ForwardTransformToBitReverseAVX512<64>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), 4, output_mod_factor);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_FwdNTT_AVX512DQ_64)
@@ -180,9 +197,11 @@ static void BM_FwdNTTInPlace(benchmark::State& state) {  //  NOLINT
   AlignedVector64<uint64_t> input(ntt_size, 1);
   NTT ntt(ntt_size, modulus);
 
+  CycleTimer timer;
   for (auto _ : state) {
     ntt.ComputeForward(input.data(), input.data(), 1, 1);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_FwdNTTInPlace)
@@ -202,9 +221,11 @@ static void BM_FwdNTTCopy(benchmark::State& state) {  //  NOLINT
   AlignedVector64<uint64_t> output(ntt_size, 1);
   NTT ntt(ntt_size, modulus);
 
+  CycleTimer timer;
   for (auto _ : state) {
     ntt.ComputeForward(input.data(), output.data(), 1, 1);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_FwdNTTCopy)
@@ -215,6 +236,77 @@ BENCHMARK(BM_FwdNTTCopy)
 
 //=================================================================
 
+// state[0] is the degree
+// state[1] is the number of moduli
+// state[2] is 1 to allocate tables and operands with HugePageAllocator
+static void BM_FwdNTTHugePages(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t num_moduli = state.range(1);
+  bool huge_pages = state.range(2);
+  std::vector<uint64_t> moduli = GeneratePrimes(num_moduli, 50, ntt_size);
+
+  std::shared_ptr<AllocatorBase> alloc;
+  if (huge_pages) {
+    alloc = std::make_shared<HugePageAllocator>();
+  }
+  AlignedAllocator<uint64_t, 64> aligned_alloc(alloc);
+
+  std::vector<NTT> ntts;
+  std::vector<AlignedVector64<uint64_t>> inputs;
+  for (const auto modulus : moduli) {
+    ntts.emplace_back(ntt_size, modulus, alloc);
+    inputs.emplace_back(ntt_size, 1, aligned_alloc);
+  }
+
+  CycleTimer timer;
+  for (auto _ : state) {
+    for (size_t i = 0; i < num_moduli; ++i) {
+      ntts[i].ComputeForward(inputs[i].data(), inputs[i].data(), 1, 1);
+    }
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles(), num_moduli);
+}
+
+BENCHMARK(BM_FwdNTTHugePages)
+    ->Unit(benchmark::kMicrosecond)
+    ->Args({1 << 18, 8, 0})
+    ->Args({1 << 18, 8, 1})
+    ->Args({1 << 21, 2, 0})
+    ->Args({1 << 21, 2, 1});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the maximum ISATier, compared side by side in one binary
+static void BM_FwdNTTByISATier(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  ISATier tier = static_cast<ISATier>(state.range(2));
+  if (tier > DetectedISATier()) {
+    state.SkipWithError("ISA tier not supported");
+    return;
+  }
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input(ntt_size, 1);
+  NTT ntt(ntt_size, modulus);
+
+  ScopedMaxISATier max_tier(tier);
+  state.SetLabel(KernelVariantName(ntt.SelectedForwardKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeForward(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_FwdNTTByISATier)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1024, 16384}, {30, 50, 60}, {0, 1, 2, 3}});
+
+//=================================================================
+
 // Inverse transforms
 
 // state[0] is the degree
@@ -228,11 +320,13 @@ static void BM_InvNTTNative(benchmark::State& state) {  //  NOLINT
   const AlignedVector64<uint64_t> root_of_unity = ntt.GetInvRootOfUnityPowers();
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetPrecon64InvRootOfUnityPowers();
+  CycleTimer timer;
   for (auto _ : state) {
     InverseTransformFromBitReverse64(input.data(), ntt_size, modulus,
                                      root_of_unity.data(),
                                      precon_root_of_unity.data(), 1, 1);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_InvNTTNative)
@@ -255,11 +349,13 @@ static void BM_InvNTT_AVX512IFMA(benchmark::State& state) {  //  NOLINT
   const AlignedVector64<uint64_t> root_of_unity = ntt.GetInvRootOfUnityPowers();
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetPrecon52InvRootOfUnityPowers();
+  CycleTimer timer;
   for (auto _ : state) {
     InverseTransformFromBitReverseAVX512<NTT::s_ifma_shift_bits>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), 1, 1);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_InvNTT_AVX512IFMA)
@@ -281,11 +377,13 @@ static void BM_InvNTT_AVX512IFMALazy(benchmark::State& state) {  //  NOLINT
   const AlignedVector64<uint64_t> root_of_unity = ntt.GetInvRootOfUnityPowers();
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetPrecon52InvRootOfUnityPowers();
+  CycleTimer timer;
   for (auto _ : state) {
     InverseTransformFromBitReverseAVX512<NTT::s_ifma_shift_bits>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), 2, 2);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_InvNTT_AVX512IFMALazy)
@@ -312,11 +410,13 @@ static void BM_InvNTT_AVX512DQ_32(benchmark::State& state) {  //  NOLINT
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetPrecon32InvRootOfUnityPowers();
 
+  CycleTimer timer;
   for (auto _ : state) {
     InverseTransformFromBitReverseAVX512<32>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), output_mod_factor, output_mod_factor);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_InvNTT_AVX512DQ_32)
@@ -340,11 +440,13 @@ static void BM_InvNTT_AVX512DQ_64(benchmark::State& state) {  //  NOLINT
   const AlignedVector64<uint64_t> precon_root_of_unity =
       ntt.GetPrecon64InvRootOfUnityPowers();
 
+  CycleTimer timer;
   for (auto _ : state) {
     InverseTransformFromBitReverseAVX512<NTT::s_default_shift_bits>(
         input.data(), ntt_size, modulus, root_of_unity.data(),
         precon_root_of_unity.data(), output_mod_factor, output_mod_factor);
   }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
 }
 
 BENCHMARK(BM_InvNTT_AVX512DQ_64)
@@ -359,5 +461,478 @@ BENCHMARK(BM_InvNTT_AVX512DQ_64)
 
 //=================================================================
 
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the maximum ISATier, compared side by side in one binary
+static void BM_InvNTTByISATier(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  ISATier tier = static_cast<ISATier>(state.range(2));
+  if (tier > DetectedISATier()) {
+    state.SkipWithError("ISA tier not supported");
+    return;
+  }
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input(ntt_size, 1);
+  NTT ntt(ntt_size, modulus);
+
+  ScopedMaxISATier max_tier(tier);
+  state.SetLabel(KernelVariantName(ntt.SelectedInverseKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeInverse(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_InvNTTByISATier)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({{1024, 16384}, {30, 50, 60}, {0, 1, 2, 3}});
+
+//=================================================================
+
+// Parameter sweeps, comparing the selected kernels across degrees and around
+// the modulus bounds of the 32-bit and IFMA kernels
+
+// Bit-widths b of the swept moduli, which lie in (2^b, 2^(b+1)). 29 and 30
+// straddle NTT::s_max_fwd_32_modulus, 30 and 31 NTT::s_max_inv_32_modulus,
+// 49 and 50 NTT::s_max_fwd_ifma_modulus and 50 and 51
+// NTT::s_max_inv_ifma_modulus.
+static const std::vector<int64_t> s_ntt_sweep_modulus_bits{
+    20, 29, 30, 31, 40, 49, 50, 51, 55, 60, 61};
+
+// Returns num_values values in [0, bound)
+static AlignedVector64<uint64_t> NTTSweepInput(uint64_t num_values,
+                                               uint64_t bound) {
+  AlignedVector64<uint64_t> input(num_values);
+  for (size_t i = 0; i < num_values; ++i) {
+    input[i] = (i * 0x9E3779B97F4A7C15ULL) % bound;
+  }
+  return input;
+}
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+static void BM_FwdNTTSweep(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  state.SetLabel(KernelVariantName(ntt.SelectedForwardKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeForward(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_FwdNTTSweep)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 17, 2),
+                   s_ntt_sweep_modulus_bits});
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+static void BM_InvNTTSweep(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  state.SetLabel(KernelVariantName(ntt.SelectedInverseKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeInverse(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_InvNTTSweep)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 17, 2),
+                   s_ntt_sweep_modulus_bits});
+
+#ifdef HEXL_HAS_AVX512DQ
+// Prefetch tuning. The strided stages of transforms larger than the AVX512
+// base case are timed one at a time, so the prefetch distance which minimizes
+// cycles/butterfly can be chosen per microarchitecture
+
+static const std::vector<int64_t> s_ntt_prefetch_distances{0, 2, 4, 8, 16, 32};
+
+// Registers each single stage and each merged pair of stages of degree 2^15
+// and 2^17 transforms, with each prefetch distance
+static void NTTStageArgs(benchmark::internal::Benchmark* b, bool forward) {
+  for (int64_t degree_bits : {15, 17}) {
+    for (int64_t num_stages : {1, 2}) {
+      // Forward passes span t_bits down to t_bits - num_stages + 1, inverse
+      // passes t_bits up to t_bits + num_stages - 1. Both need t >= 8 and
+      // forward t <= n / 2, inverse t <= n / 4
+      int64_t min_t_bits = forward ? 2 + num_stages : 3;
+      int64_t max_t_bits =
+          forward ? degree_bits - 1 : degree_bits - 1 - num_stages;
+      for (int64_t t_bits = max_t_bits; t_bits >= min_t_bits; --t_bits) {
+        for (int64_t prefetch_distance : s_ntt_prefetch_distances) {
+          b->Args({int64_t{1} << degree_bits, t_bits, num_stages,
+                   prefetch_distance});
+        }
+      }
+    }
+  }
+}
+
+// state[0] is the degree
+// state[1] is log2(t), where each first-stage butterfly combines inputs t apart
+// state[2] is the number of stages merged into one pass, 1 or 2
+// state[3] is the prefetch distance in cache lines
+static void BM_FwdNTTStage(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  uint64_t t = 1ULL << state.range(1);
+  uint64_t num_stages = state.range(2);
+  uint64_t prefetch_distance = state.range(3);
+  uint64_t modulus = GeneratePrimes(1, 55, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  const AlignedVector64<uint64_t> root_of_unity =
+      ntt.GetAVX512RootOfUnityPowers();
+  const AlignedVector64<uint64_t> precon_root_of_unity =
+      ntt.GetAVX512Precon64RootOfUnityPowers();
+  CycleTimer timer;
+  for (auto _ : state) {
+    ForwardTransformStageAVX512<NTT::s_default_shift_bits>(
+        input.data(), ntt_size, modulus, root_of_unity.data(),
+        precon_root_of_unity.data(), t, num_stages, prefetch_distance);
+  }
+  SetNTTStageCounters(state, ntt_size, timer.ElapsedCycles(), num_stages);
+}
+
+BENCHMARK(BM_FwdNTTStage)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply([](benchmark::internal::Benchmark* b) { NTTStageArgs(b, true); });
+
+// state[0] is the degree
+// state[1] is log2(t), where each first-stage butterfly combines inputs t apart
+// state[2] is the number of stages merged into one pass, 1 or 2
+// state[3] is the prefetch distance in cache lines
+static void BM_InvNTTStage(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  uint64_t t = 1ULL << state.range(1);
+  uint64_t num_stages = state.range(2);
+  uint64_t prefetch_distance = state.range(3);
+  uint64_t modulus = GeneratePrimes(1, 60, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  const AlignedVector64<uint64_t> root_of_unity = ntt.GetInvRootOfUnityPowers();
+  const AlignedVector64<uint64_t> precon_root_of_unity =
+      ntt.GetPrecon64InvRootOfUnityPowers();
+  CycleTimer timer;
+  for (auto _ : state) {
+    InverseTransformStageAVX512<NTT::s_default_shift_bits>(
+        input.data(), ntt_size, modulus, root_of_unity.data(),
+        precon_root_of_unity.data(), t, num_stages, prefetch_distance);
+  }
+  SetNTTStageCounters(state, ntt_size, timer.ElapsedCycles(), num_stages);
+}
+
+BENCHMARK(BM_InvNTTStage)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply([](benchmark::internal::Benchmark* b) { NTTStageArgs(b, false); });
+
+// state[0] is the degree
+// state[1] is the prefetch distance in cache lines
+static void BM_FwdNTTPrefetch(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  uint64_t modulus = GeneratePrimes(1, 55, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  NTT::SetPrefetchDistance(state.range(1));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeForward(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+  NTT::SetPrefetchDistance(NTT::s_default_prefetch_distance);
+}
+
+BENCHMARK(BM_FwdNTTPrefetch)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 17, 2),
+                   s_ntt_prefetch_distances});
+
+// state[0] is the degree
+// state[1] is the prefetch distance in cache lines
+static void BM_InvNTTPrefetch(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  uint64_t modulus = GeneratePrimes(1, 60, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  NTT::SetPrefetchDistance(state.range(1));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeInverse(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+  NTT::SetPrefetchDistance(NTT::s_default_prefetch_distance);
+}
+
+BENCHMARK(BM_InvNTTPrefetch)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 17, 2),
+                   s_ntt_prefetch_distances});
+
+// Engines. The recursive and four-step transforms are compared side by side
+// for degrees up to well beyond the L2 cache
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the NTT::Engine
+static void BM_FwdNTTEngine(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  ntt.SetEngine(static_cast<NTT::Engine>(state.range(2)));
+  state.SetLabel(KernelVariantName(ntt.SelectedForwardKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeForward(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_FwdNTTEngine)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 16, 1 << 24, 4), {30, 50, 60},
+                   {static_cast<int64_t>(NTT::Engine::Recursive),
+                    static_cast<int64_t>(NTT::Engine::FourStep)}});
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is the NTT::Engine
+static void BM_InvNTTEngine(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  ntt.SetEngine(static_cast<NTT::Engine>(state.range(2)));
+  state.SetLabel(KernelVariantName(ntt.SelectedInverseKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeInverse(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_InvNTTEngine)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 16, 1 << 24, 4), {30, 50, 60},
+                   {static_cast<int64_t>(NTT::Engine::Recursive),
+                    static_cast<int64_t>(NTT::Engine::FourStep)}});
+#endif
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is 1 to multiply with ComputeForwardMultiply, 0 to call
+// ComputeForward followed by EltwiseMultMod
+static void BM_FwdNTTMultiply(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  bool fused = state.range(2) != 0;
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  AlignedVector64<uint64_t> multiplicand = NTTSweepInput(ntt_size, modulus);
+  AlignedVector64<uint64_t> output(ntt_size);
+  NTT ntt(ntt_size, modulus);
+
+  state.SetLabel(KernelVariantName(ntt.SelectedForwardKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    if (fused) {
+      ntt.ComputeForwardMultiply(output.data(), input.data(),
+                                 multiplicand.data(), 1);
+    } else {
+      ntt.ComputeForward(output.data(), input.data(), 1, 1);
+      EltwiseMultMod(output.data(), output.data(), multiplicand.data(),
+                     ntt_size, modulus, 1);
+    }
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_FwdNTTMultiply)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 20, 4), {30, 50, 60},
+                   {0, 1}});
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is 1 to scale with the scalar overload of ComputeInverse, 0 to call
+// ComputeInverse followed by EltwiseFMAMod
+static void BM_InvNTTScalar(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  bool fused = state.range(2) != 0;
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+  uint64_t scalar = modulus / 3;
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  AlignedVector64<uint64_t> output(ntt_size);
+  NTT ntt(ntt_size, modulus);
+
+  state.SetLabel(KernelVariantName(ntt.SelectedInverseKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    if (fused) {
+      ntt.ComputeInverse(output.data(), input.data(), 1, 1, scalar);
+    } else {
+      ntt.ComputeInverse(output.data(), input.data(), 1, 1);
+      EltwiseFMAMod(output.data(), output.data(), scalar, nullptr, ntt_size,
+                    modulus, 1);
+    }
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_InvNTTScalar)
+    ->Unit(benchmark::kMicrosecond)
+    ->ArgsProduct({benchmark::CreateRange(1 << 12, 1 << 20, 4), {30, 50, 60},
+                   {0, 1}});
+
+// Small transforms, whose per-call setup is a significant part of the runtime
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+static void BM_InvNTTSmall(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input = NTTSweepInput(ntt_size, modulus);
+  NTT ntt(ntt_size, modulus);
+
+  state.SetLabel(KernelVariantName(ntt.SelectedInverseKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeInverse(input.data(), input.data(), 1, 1);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_InvNTTSmall)
+    ->Unit(benchmark::kNanosecond)
+    ->ArgsProduct({benchmark::CreateRange(16, 1024, 4), {30, 50, 60}});
+
+// Registers every supported combination of in-place and out-of-place
+// transforms with the given input and output mod factors. In-place transforms
+// feed each output back as the next input, so require
+// output_mod_factor <= input_mod_factor.
+static void NTTModFactorArgs(
+    benchmark::internal::Benchmark* b,
+    std::initializer_list<int64_t> input_mod_factors,
+    std::initializer_list<int64_t> output_mod_factors) {
+  for (int64_t ntt_size : {4096, 16384}) {
+    for (int64_t modulus_bits : {29, 49, 60}) {
+      for (int64_t in_place : {0, 1}) {
+        for (int64_t input_mod_factor : input_mod_factors) {
+          for (int64_t output_mod_factor : output_mod_factors) {
+            if (in_place && output_mod_factor > input_mod_factor) {
+              continue;
+            }
+            b->Args({ntt_size, modulus_bits, in_place, input_mod_factor,
+                     output_mod_factor});
+          }
+        }
+      }
+    }
+  }
+}
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is 1 for an in-place transform, 0 for out-of-place
+// state[3] is the input mod factor
+// state[4] is the output mod factor
+static void BM_FwdNTTModFactors(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  bool in_place = state.range(2) != 0;
+  uint64_t input_mod_factor = state.range(3);
+  uint64_t output_mod_factor = state.range(4);
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input =
+      NTTSweepInput(ntt_size, input_mod_factor * modulus);
+  AlignedVector64<uint64_t> output(ntt_size);
+  uint64_t* result = in_place ? input.data() : output.data();
+  NTT ntt(ntt_size, modulus);
+
+  state.SetLabel(KernelVariantName(ntt.SelectedForwardKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeForward(result, input.data(), input_mod_factor,
+                       output_mod_factor);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_FwdNTTModFactors)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      NTTModFactorArgs(b, {1, 2, 4}, {1, 4});
+    });
+
+// state[0] is the degree
+// state[1] is the bit-width of the modulus
+// state[2] is 1 for an in-place transform, 0 for out-of-place
+// state[3] is the input mod factor
+// state[4] is the output mod factor
+static void BM_InvNTTModFactors(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  bool in_place = state.range(2) != 0;
+  uint64_t input_mod_factor = state.range(3);
+  uint64_t output_mod_factor = state.range(4);
+  uint64_t modulus = GeneratePrimes(1, modulus_bits, ntt_size)[0];
+
+  AlignedVector64<uint64_t> input =
+      NTTSweepInput(ntt_size, input_mod_factor * modulus);
+  AlignedVector64<uint64_t> output(ntt_size);
+  uint64_t* result = in_place ? input.data() : output.data();
+  NTT ntt(ntt_size, modulus);
+
+  state.SetLabel(KernelVariantName(ntt.SelectedInverseKernel()));
+  CycleTimer timer;
+  for (auto _ : state) {
+    ntt.ComputeInverse(result, input.data(), input_mod_factor,
+                       output_mod_factor);
+  }
+  SetNTTCounters(state, ntt_size, timer.ElapsedCycles());
+}
+
+BENCHMARK(BM_InvNTTModFactors)
+    ->Unit(benchmark::kMicrosecond)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      NTTModFactorArgs(b, {1, 2}, {1, 2});
+    });
+
 }  // namespace hexl
 }  // namespace intel
@@ -0,0 +1,135 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "hexl/ntt/ntt.hpp"
+#include "hexl/number-theory/number-theory.hpp"
+
+namespace intel {
+namespace hexl {
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the number of bits in each modulus
+// state[2] is the number of moduli in the chain
+static void BM_MinimalPrimitiveRoot(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  size_t num_moduli = state.range(2);
+  std::vector<uint64_t> moduli =
+      GeneratePrimes(num_moduli, modulus_bits, ntt_size);
+
+  for (auto _ : state) {
+    for (const auto modulus : moduli) {
+      benchmark::DoNotOptimize(MinimalPrimitiveRoot(2 * ntt_size, modulus));
+    }
+  }
+}
+
+BENCHMARK(BM_MinimalPrimitiveRoot)
+    ->Unit(benchmark::kMicrosecond)
+    ->Args({4096, 50, 3})
+    ->Args({16384, 55, 8})
+    ->Args({32768, 60, 16})
+    ->Args({131072, 60, 32});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the number of bits in each modulus
+// state[2] is the number of moduli in the chain
+static void BM_NTTSetup(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  size_t num_moduli = state.range(2);
+  std::vector<uint64_t> moduli =
+      GeneratePrimes(num_moduli, modulus_bits, ntt_size);
+
+  for (auto _ : state) {
+    for (const auto modulus : moduli) {
+      NTT ntt(ntt_size, modulus);
+      benchmark::DoNotOptimize(ntt.GetMinimalRootOfUnity());
+    }
+  }
+}
+
+BENCHMARK(BM_NTTSetup)
+    ->Unit(benchmark::kMillisecond)
+    ->Args({4096, 50, 3})
+    ->Args({16384, 55, 8})
+    ->Args({32768, 60, 16})
+    ->Args({131072, 60, 32});
+
+//=================================================================
+
+// state[0] is the number of bases
+static void BM_PowModVector(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  uint64_t modulus = GeneratePrimes(1, 60, 1024)[0];
+  std::vector<uint64_t> base(input_size);
+  for (size_t i = 0; i < input_size; ++i) {
+    base[i] = (i + 2) % modulus;
+  }
+  std::vector<uint64_t> result(input_size);
+
+  for (auto _ : state) {
+    PowModVector(result.data(), base.data(), modulus - 2, input_size, modulus);
+  }
+}
+
+BENCHMARK(BM_PowModVector)
+    ->Unit(benchmark::kMicrosecond)
+    ->Args({64})
+    ->Args({1024});
+
+//=================================================================
+
+// state[0] is the input size
+static void BM_BatchInverseMod(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+  uint64_t modulus = GeneratePrimes(1, 60, 1024)[0];
+  std::vector<uint64_t> operand(input_size);
+  for (size_t i = 0; i < input_size; ++i) {
+    operand[i] = i + 1;
+  }
+  std::vector<uint64_t> result(input_size);
+
+  for (auto _ : state) {
+    BatchInverseMod(result.data(), operand.data(), input_size, modulus);
+  }
+}
+
+BENCHMARK(BM_BatchInverseMod)
+    ->Unit(benchmark::kMicrosecond)
+    ->Args({1024})
+    ->Args({16384});
+
+//=================================================================
+
+// state[0] is the degree
+// state[1] is the number of bits in each modulus
+// state[2] is the number of moduli in the chain
+static void BM_GeneratePrimes(benchmark::State& state) {  //  NOLINT
+  size_t ntt_size = state.range(0);
+  size_t modulus_bits = state.range(1);
+  size_t num_moduli = state.range(2);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        GeneratePrimes(num_moduli, modulus_bits, ntt_size));
+  }
+}
+
+BENCHMARK(BM_GeneratePrimes)
+    ->Unit(benchmark::kMicrosecond)
+    ->Args({4096, 50, 3})
+    ->Args({16384, 55, 8})
+    ->Args({32768, 60, 16})
+    ->Args({131072, 60, 32});
+
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,64 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "bench-util.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+
+namespace intel {
+namespace hexl {
+
+// STREAM-style memory bandwidth references for the roofline summary. Each
+// reports bytes_per_second over the same buffer sizes as the kernels.
+
+//=================================================================
+
+// state[0] is the number of 64-bit words
+static void BM_StreamCopy(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+
+  AlignedVector64<uint64_t> input(input_size, 1);
+  AlignedVector64<uint64_t> output(input_size, 2);
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < input_size; ++i) {
+      output[i] = input[i];
+    }
+    benchmark::ClobberMemory();
+  }
+  SetEltwiseCounters(state, input_size, 1);
+}
+
+BENCHMARK(BM_StreamCopy)
+    ->Unit(benchmark::kMicrosecond)
+    ->Range(1 << 10, 1 << 22);
+
+//=================================================================
+
+// state[0] is the number of 64-bit words
+static void BM_StreamTriad(benchmark::State& state) {  //  NOLINT
+  size_t input_size = state.range(0);
+
+  AlignedVector64<uint64_t> input1(input_size, 1);
+  AlignedVector64<uint64_t> input2(input_size, 2);
+  AlignedVector64<uint64_t> output(input_size, 3);
+  uint64_t scalar = 3;
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < input_size; ++i) {
+      output[i] = input1[i] + scalar * input2[i];
+    }
+    benchmark::ClobberMemory();
+  }
+  SetEltwiseCounters(state, input_size, 2);
+}
+
+BENCHMARK(BM_StreamTriad)
+    ->Unit(benchmark::kMicrosecond)
+    ->Range(1 << 10, 1 << 22);
+
+}  // namespace hexl
+}  // namespace intel
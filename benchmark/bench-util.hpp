@@ -0,0 +1,74 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <stdint.h>
+
+#include "hexl/number-theory/number-theory.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+namespace intel {
+namespace hexl {
+
+// Counts time-stamp counter cycles, e.g. over the benchmark loop
+class CycleTimer {
+ public:
+  CycleTimer() : m_start(__rdtsc()) {}
+
+  uint64_t ElapsedCycles() const { return __rdtsc() - m_start; }
+
+ private:
+  uint64_t m_start;
+};
+
+// Reports the throughput of an element-wise kernel on n elements per
+// iteration, which reads num_inputs and writes num_outputs 64-bit words per
+// element
+inline void SetEltwiseCounters(benchmark::State& state, uint64_t n,
+                               uint64_t num_inputs, uint64_t num_outputs = 1) {
+  int64_t items = static_cast<int64_t>(state.iterations() * n);
+  state.SetItemsProcessed(items);
+  int64_t words_per_item = static_cast<int64_t>(num_inputs + num_outputs);
+  state.SetBytesProcessed(items * words_per_item *
+                          static_cast<int64_t>(sizeof(uint64_t)));
+}
+
+// Reports the throughput of num_transforms degree-n NTTs per iteration, taking
+// cycles time-stamp counter cycles in total. Each transform performs
+// n/2 log2(n) butterflies and moves at least 4n words: the operand is read and
+// written once, and the root of unity powers and their pre-conditioned values
+// are each read once.
+inline void SetNTTCounters(benchmark::State& state, uint64_t n, uint64_t cycles,
+                           uint64_t num_transforms = 1) {
+  uint64_t transforms = state.iterations() * num_transforms;
+  uint64_t butterflies = transforms * (n / 2) * Log2(n);
+  state.SetItemsProcessed(static_cast<int64_t>(butterflies));
+  state.SetBytesProcessed(
+      static_cast<int64_t>(transforms * 4 * n * sizeof(uint64_t)));
+  state.counters["butterflies/cycle"] =
+      (cycles == 0) ? 0.0
+                    : static_cast<double>(butterflies) /
+                          static_cast<double>(cycles);
+}
+
+// Reports the throughput of num_stages butterfly stages of a degree-n NTT per
+// iteration, taking cycles time-stamp counter cycles in total
+inline void SetNTTStageCounters(benchmark::State& state, uint64_t n,
+                                uint64_t cycles, uint64_t num_stages = 1) {
+  uint64_t butterflies = state.iterations() * num_stages * (n / 2);
+  state.SetItemsProcessed(static_cast<int64_t>(butterflies));
+  state.counters["cycles/butterfly"] =
+      (butterflies == 0) ? 0.0
+                         : static_cast<double>(cycles) /
+                               static_cast<double>(butterflies);
+}
+
+}  // namespace hexl
+}  // namespace intel
@@ -3,11 +3,191 @@
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
 #include "hexl/logging/logging.hpp"
+#include "hexl/util/isa-tier.hpp"
+
+// Applies and removes the --hexl_max_isa_tier=<tier> flag, which restricts
+// all benchmarks to kernels of at most the given intel::hexl::ISATier.
+// Returns false if the tier is unknown
+bool ParseMaxISATierFlag(int* argc, char** argv) {
+  using intel::hexl::ISATier;
+  const char* prefix = "--hexl_max_isa_tier=";
+  size_t prefix_len = std::strlen(prefix);
+
+  int num_args = 0;
+  for (int i = 0; i < *argc; ++i) {
+    if (std::strncmp(argv[i], prefix, prefix_len) != 0) {
+      argv[num_args++] = argv[i];
+      continue;
+    }
+    const char* name = argv[i] + prefix_len;
+    bool found = false;
+    for (ISATier tier : {ISATier::Native, ISATier::AVX2, ISATier::AVX512DQ,
+                         ISATier::AVX512IFMA}) {
+      if (std::strcmp(name, intel::hexl::ISATierName(tier)) == 0) {
+        intel::hexl::SetMaxISATier(tier);
+        found = true;
+      }
+    }
+    if (!found) {
+      std::cerr << "Unknown ISA tier " << name
+                << "; expected Native, AVX2, AVX512DQ or AVX512IFMA\n";
+      return false;
+    }
+  }
+  *argc = num_args;
+  return true;
+}
+
+// Applies and removes the --hexl_roofline flag. Returns true if it was given
+bool ParseRooflineFlag(int* argc, char** argv) {
+  bool found = false;
+  int num_args = 0;
+  for (int i = 0; i < *argc; ++i) {
+    if (std::strcmp(argv[i], "--hexl_roofline") == 0) {
+      found = true;
+    } else {
+      argv[num_args++] = argv[i];
+    }
+  }
+  *argc = num_args;
+  return found;
+}
+
+// Console reporter which, after all benchmarks have run, prints a roofline
+// summary: the memory throughput of each benchmark, its fraction of the
+// BM_StreamTriad bandwidth at the nearest working-set size and, for NTTs,
+// butterflies per cycle. Comparing at the same size keeps kernels whose data
+// fits in cache from being measured against DRAM bandwidth, and vice versa.
+class RooflineReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& reports) override {
+    for (const Run& run : reports) {
+      if (run.run_type != Run::RT_Iteration || run.iterations == 0) {
+        continue;
+      }
+      auto bytes = run.counters.find("bytes_per_second");
+      if (bytes == run.counters.end()) {
+        continue;
+      }
+      Entry entry;
+      entry.name = run.benchmark_name();
+      entry.bytes_per_second = bytes->second.value;
+      // Rates are per second of CPU time, as no benchmark uses real time
+      entry.bytes_per_iteration = entry.bytes_per_second *
+                                  run.cpu_accumulated_time /
+                                  static_cast<double>(run.iterations);
+      auto butterflies = run.counters.find("butterflies/cycle");
+      entry.butterflies_per_cycle = (butterflies == run.counters.end())
+                                        ? 0.0
+                                        : butterflies->second.value;
+      if (entry.name.compare(0, 14, "BM_StreamTriad") == 0) {
+        m_triads.push_back(entry);
+      }
+      m_entries.push_back(entry);
+    }
+    ConsoleReporter::ReportRuns(reports);
+  }
+
+  void Finalize() override {
+    ConsoleReporter::Finalize();
+    if (m_entries.empty()) {
+      return;
+    }
+    size_t name_width = 9;
+    for (const Entry& entry : m_entries) {
+      name_width = std::max(name_width, entry.name.size());
+    }
+
+    std::ostream& out = GetOutputStream();
+    out << "\nRoofline summary";
+    if (m_triads.empty()) {
+      out << " (run BM_StreamTriad for the bandwidth bound)";
+    }
+    out << "\n"
+        << std::left << std::setw(static_cast<int>(name_width)) << "Benchmark"
+        << std::right << std::setw(10) << "GiB/s" << std::setw(14)
+        << "STREAM GiB/s" << std::setw(10) << "% STREAM" << std::setw(18)
+        << "butterflies/cycle"
+        << "\n";
+    for (const Entry& entry : m_entries) {
+      out << std::left << std::setw(static_cast<int>(name_width)) << entry.name
+          << std::right << std::fixed << std::setprecision(2) << std::setw(10)
+          << entry.bytes_per_second / s_bytes_per_gib;
+      const Entry* triad = NearestTriad(entry.bytes_per_iteration);
+      if (triad != nullptr) {
+        out << std::setw(14) << triad->bytes_per_second / s_bytes_per_gib
+            << std::setw(10)
+            << 100.0 * entry.bytes_per_second / triad->bytes_per_second;
+      } else {
+        out << std::setw(14) << "-" << std::setw(10) << "-";
+      }
+      out << std::setw(18);
+      if (entry.butterflies_per_cycle > 0) {
+        out << entry.butterflies_per_cycle;
+      } else {
+        out << "-";
+      }
+      out << "\n";
+    }
+  }
+
+ private:
+  // Matches the binary prefixes of the bytes_per_second column of the console
+  // output
+  static constexpr double s_bytes_per_gib = 1024.0 * 1024.0 * 1024.0;
+
+  struct Entry {
+    std::string name;
+    double bytes_per_second;
+    // Bytes moved by one iteration, i.e. the working set
+    double bytes_per_iteration;
+    double butterflies_per_cycle;
+  };
+
+  // Returns the BM_StreamTriad run whose working set is nearest to
+  // bytes_per_iteration by ratio, or nullptr if there is none
+  const Entry* NearestTriad(double bytes_per_iteration) const {
+    const Entry* nearest = nullptr;
+    double nearest_distance = 0;
+    for (const Entry& triad : m_triads) {
+      if (triad.bytes_per_iteration <= 0 || bytes_per_iteration <= 0) {
+        continue;
+      }
+      double distance =
+          std::fabs(std::log(triad.bytes_per_iteration / bytes_per_iteration));
+      if (nearest == nullptr || distance < nearest_distance) {
+        nearest = &triad;
+        nearest_distance = distance;
+      }
+    }
+    return nearest;
+  }
+
+  std::vector<Entry> m_entries;
+  std::vector<Entry> m_triads;
+};
 
 int main(int argc, char** argv) {
   START_EASYLOGGINGPP(argc, argv);
 
+  if (!ParseMaxISATierFlag(&argc, argv)) {
+    return 1;
+  }
+  bool roofline = ParseRooflineFlag(&argc, argv);
   benchmark::Initialize(&argc, argv);
-  benchmark::RunSpecifiedBenchmarks();
+  if (roofline) {
+    RooflineReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+  } else {
+    benchmark::RunSpecifiedBenchmarks();
+  }
 }
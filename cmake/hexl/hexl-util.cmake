@@ -26,6 +26,25 @@ function(hexl_check_compile_flag SOURCE_FILE OUTPUT_FLAG)
     endif()
 endfunction()
 
+# Checks if SOURCE_FILE can be compiled with ISA_FLAGS, without running it
+# If so, adds OUTPUT_FLAG to compile definitions
+function(hexl_check_isa_flags SOURCE_FILE ISA_FLAGS OUTPUT_FLAG)
+    try_compile(CAN_COMPILE ${CMAKE_BINARY_DIR}
+        "${SOURCE_FILE}"
+        COMPILE_DEFINITIONS ${ISA_FLAGS}
+        OUTPUT_VARIABLE TRY_COMPILE_OUTPUT
+    )
+    # Uncomment below to debug
+    # message("TRY_COMPILE_OUTPUT ${TRY_COMPILE_OUTPUT}")
+    if (CAN_COMPILE)
+        message(STATUS "Setting ${OUTPUT_FLAG}")
+        add_definitions(-D${OUTPUT_FLAG})
+        set(${OUTPUT_FLAG} 1 PARENT_SCOPE)
+    else()
+        message(STATUS "Compile flag not found: ${OUTPUT_FLAG}")
+    endif()
+endfunction()
+
 function(hexl_check_compiler_version)
     if("${CMAKE_CXX_COMPILER_ID}" STREQUAL "GNU")
       if (CMAKE_CXX_COMPILER_VERSION VERSION_LESS 7.0)
@@ -10,12 +10,15 @@
 #include "hexl/eltwise/eltwise-add-mod.hpp"
 #include "hexl/util/check.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 #ifdef HEXL_HAS_AVX512DQ
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 void EltwiseAddModAVX512(uint64_t* result, const uint64_t* operand1,
                          const uint64_t* operand2, uint64_t n,
                          uint64_t modulus) {
@@ -30,19 +33,12 @@ void EltwiseAddModAVX512(uint64_t* result, const uint64_t* operand1,
   HEXL_CHECK_BOUNDS(operand2, n, modulus,
                     "pre-add value in operand2 exceeds bound " << modulus);
 
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseAddModNative(result, operand1, operand2, n_mod_8, modulus);
-    operand1 += n_mod_8;
-    operand2 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-
   __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
   __m512i* vp_result = reinterpret_cast<__m512i*>(result);
   const __m512i* vp_operand1 = reinterpret_cast<const __m512i*>(operand1);
   const __m512i* vp_operand2 = reinterpret_cast<const __m512i*>(operand2);
+  bool stream = result != operand1 && result != operand2 &&
+                UseStreamingStores(result, n);
 
   HEXL_LOOP_UNROLL_4
   for (size_t i = n / 8; i > 0; --i) {
@@ -52,13 +48,28 @@ void EltwiseAddModAVX512(uint64_t* result, const uint64_t* operand1,
     __m512i v_result =
         _mm512_hexl_small_add_mod_epi64(v_operand1, v_operand2, v_modulus);
 
-    _mm512_storeu_si512(vp_result, v_result);
+    _mm512_hexl_store_si512(vp_result, v_result, stream);
 
     ++vp_result;
     ++vp_operand1;
     ++vp_operand2;
   }
 
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+    __m512i v_operand2 = _mm512_maskz_loadu_epi64(tail, vp_operand2);
+    __m512i v_result =
+        _mm512_hexl_small_add_mod_epi64(v_operand1, v_operand2, v_modulus);
+    _mm512_mask_storeu_epi64(vp_result, tail, v_result);
+  }
+  if (stream) {
+    // Order the streaming stores before any subsequent stores
+    _mm_sfence();
+  }
+
   HEXL_CHECK_BOUNDS(result, n, modulus, "result exceeds bound " << modulus);
 }
 
@@ -74,18 +85,11 @@ void EltwiseAddModAVX512(uint64_t* result, const uint64_t* operand1,
                     "pre-add value in operand1 exceeds bound " << modulus);
   HEXL_CHECK(operand2 < modulus, "Require operand2 < modulus");
 
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseAddModNative(result, operand1, operand2, n_mod_8, modulus);
-    operand1 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-
   __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
   __m512i* vp_result = reinterpret_cast<__m512i*>(result);
   const __m512i* vp_operand1 = reinterpret_cast<const __m512i*>(operand1);
   const __m512i v_operand2 = _mm512_set1_epi64(static_cast<int64_t>(operand2));
+  bool stream = result != operand1 && UseStreamingStores(result, n);
 
   HEXL_LOOP_UNROLL_4
   for (size_t i = n / 8; i > 0; --i) {
@@ -94,15 +98,31 @@ void EltwiseAddModAVX512(uint64_t* result, const uint64_t* operand1,
     __m512i v_result =
         _mm512_hexl_small_add_mod_epi64(v_operand1, v_operand2, v_modulus);
 
-    _mm512_storeu_si512(vp_result, v_result);
+    _mm512_hexl_store_si512(vp_result, v_result, stream);
 
     ++vp_result;
     ++vp_operand1;
   }
 
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+    __m512i v_result =
+        _mm512_hexl_small_add_mod_epi64(v_operand1, v_operand2, v_modulus);
+    _mm512_mask_storeu_epi64(vp_result, tail, v_result);
+  }
+  if (stream) {
+    // Order the streaming stores before any subsequent stores
+    _mm_sfence();
+  }
+
   HEXL_CHECK_BOUNDS(result, n, modulus, "result exceeds bound " << modulus);
 }
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
 
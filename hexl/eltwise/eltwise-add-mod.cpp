@@ -9,6 +9,7 @@
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 
 namespace intel {
 namespace hexl {
@@ -81,13 +82,15 @@ void EltwiseAddMod(uint64_t* result, const uint64_t* operand1,
                     "pre-add value in operand2 exceeds bound " << modulus);
 
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
+  if (UseAVX512DQ()) {
+    HEXL_PROFILE_KERNEL("EltwiseAddMod/AVX512DQ-64", n);
     EltwiseAddModAVX512(result, operand1, operand2, n, modulus);
     return;
   }
 #endif
 
   HEXL_VLOG(3, "Calling EltwiseAddModNative");
+  HEXL_PROFILE_KERNEL("EltwiseAddMod/Native", n);
   EltwiseAddModNative(result, operand1, operand2, n, modulus);
 }
 
@@ -102,13 +105,15 @@ void EltwiseAddMod(uint64_t* result, const uint64_t* operand1,
   HEXL_CHECK(operand2 < modulus, "Require operand2 < modulus");
 
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
+  if (UseAVX512DQ()) {
+    HEXL_PROFILE_KERNEL("EltwiseAddModScalar/AVX512DQ-64", n);
     EltwiseAddModAVX512(result, operand1, operand2, n, modulus);
     return;
   }
 #endif
 
   HEXL_VLOG(3, "Calling EltwiseAddModNative");
+  HEXL_PROFILE_KERNEL("EltwiseAddModScalar/Native", n);
   EltwiseAddModNative(result, operand1, operand2, n, modulus);
 }
 
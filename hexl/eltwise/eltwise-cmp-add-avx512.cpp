@@ -10,10 +10,13 @@
 #include "hexl/util/check.hpp"
 #include "hexl/util/util.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 void EltwiseCmpAddAVX512(uint64_t* result, const uint64_t* operand1, uint64_t n,
                          CMPINT cmp, uint64_t bound, uint64_t diff) {
@@ -22,14 +25,6 @@ void EltwiseCmpAddAVX512(uint64_t* result, const uint64_t* operand1, uint64_t n,
   HEXL_CHECK(n != 0, "Require n != 0");
   HEXL_CHECK(diff != 0, "Require diff != 0");
 
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseCmpAddNative(result, operand1, n_mod_8, cmp, bound, diff);
-    operand1 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-
   __m512i v_bound = _mm512_set1_epi64(static_cast<int64_t>(bound));
   const __m512i* v_op_ptr = reinterpret_cast<const __m512i*>(operand1);
   __m512i* v_result_ptr = reinterpret_cast<__m512i*>(result);
@@ -42,8 +37,20 @@ void EltwiseCmpAddAVX512(uint64_t* result, const uint64_t* operand1, uint64_t n,
     ++v_result_ptr;
     ++v_op_ptr;
   }
+
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_op = _mm512_maskz_loadu_epi64(tail, v_op_ptr);
+    __m512i v_add_diff = _mm512_hexl_cmp_epi64(v_op, v_bound, cmp, diff);
+    v_op = _mm512_add_epi64(v_op, v_add_diff);
+    _mm512_mask_storeu_epi64(v_result_ptr, tail, v_op);
+  }
 }
 #endif
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
@@ -6,10 +6,13 @@
 #include <stdint.h>
 
 #include "hexl/util/util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 /// @brief Computes element-wise conditional addition.
 /// @param[out] result Stores the result
 /// @param[in] operand1 Vector of elements to compare
@@ -22,5 +25,7 @@ namespace hexl {
 void EltwiseCmpAddAVX512(uint64_t* result, const uint64_t* operand1, uint64_t n,
                          CMPINT cmp, uint64_t bound, uint64_t diff);
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
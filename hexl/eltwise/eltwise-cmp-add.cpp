@@ -9,6 +9,7 @@
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 
 namespace intel {
 namespace hexl {
@@ -21,11 +22,13 @@ void EltwiseCmpAdd(uint64_t* result, const uint64_t* operand1, uint64_t n,
   HEXL_CHECK(diff != 0, "Require diff != 0");
 
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
+  if (UseAVX512DQ()) {
+    HEXL_PROFILE_KERNEL("EltwiseCmpAdd/AVX512DQ-64", n);
     EltwiseCmpAddAVX512(result, operand1, n, cmp, bound, diff);
     return;
   }
 #endif
+  HEXL_PROFILE_KERNEL("EltwiseCmpAdd/Native", n);
   EltwiseCmpAddNative(result, operand1, n, cmp, bound, diff);
 }
 
@@ -10,11 +10,30 @@
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
+// Returns (x cmp bound) ? (x - diff) mod q : x mod q in each 64-bit lane
+inline __m512i EltwiseCmpSubModAVX512Vector(__m512i v_op, __m512i v_modulus,
+                                            __m512i v_mu, CMPINT cmp,
+                                            __m512i v_bound, __m512i v_diff,
+                                            uint64_t modulus) {
+  __mmask8 op_le_cmp = _mm512_hexl_cmp_epu64_mask(v_op, v_bound, Not(cmp));
+
+  v_op = _mm512_hexl_barrett_reduce64(v_op, v_modulus, v_mu);
+
+  __m512i v_to_add = _mm512_hexl_cmp_epi64(v_op, v_diff, CMPINT::LT, modulus);
+  v_to_add = _mm512_sub_epi64(v_to_add, v_diff);
+  v_to_add = _mm512_mask_set1_epi64(v_to_add, op_le_cmp, 0);
+
+  return _mm512_add_epi64(v_op, v_to_add);
+}
+
 void EltwiseCmpSubModAVX512(uint64_t* result, const uint64_t* operand1,
                             uint64_t n, uint64_t modulus, CMPINT cmp,
                             uint64_t bound, uint64_t diff) {
@@ -25,16 +44,6 @@ void EltwiseCmpSubModAVX512(uint64_t* result, const uint64_t* operand1,
   HEXL_CHECK(diff != 0, "Require diff != 0");
   HEXL_CHECK(diff < modulus, "Diff " << diff << " >= modulus " << modulus);
 
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseCmpSubModNative(result, operand1, n_mod_8, modulus, cmp, bound,
-                           diff);
-    operand1 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-  HEXL_CHECK(diff < modulus, "Diff " << diff << " >= modulus " << modulus);
-
   const __m512i* v_op_ptr = reinterpret_cast<const __m512i*>(operand1);
   __m512i* v_result_ptr = reinterpret_cast<__m512i*>(result);
   __m512i v_bound = _mm512_set1_epi64(static_cast<int64_t>(bound));
@@ -46,21 +55,26 @@ void EltwiseCmpSubModAVX512(uint64_t* result, const uint64_t* operand1,
 
   for (size_t i = n / 8; i > 0; --i) {
     __m512i v_op = _mm512_loadu_si512(v_op_ptr);
-    __mmask8 op_le_cmp = _mm512_hexl_cmp_epu64_mask(v_op, v_bound, Not(cmp));
-
-    v_op = _mm512_hexl_barrett_reduce64(v_op, v_modulus, v_mu);
-
-    __m512i v_to_add = _mm512_hexl_cmp_epi64(v_op, v_diff, CMPINT::LT, modulus);
-    v_to_add = _mm512_sub_epi64(v_to_add, v_diff);
-    v_to_add = _mm512_mask_set1_epi64(v_to_add, op_le_cmp, 0);
-
-    v_op = _mm512_add_epi64(v_op, v_to_add);
+    v_op = EltwiseCmpSubModAVX512Vector(v_op, v_modulus, v_mu, cmp, v_bound,
+                                        v_diff, modulus);
     _mm512_storeu_si512(v_result_ptr, v_op);
     ++v_op_ptr;
     ++v_result_ptr;
   }
+
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_op = _mm512_maskz_loadu_epi64(tail, v_op_ptr);
+    v_op = EltwiseCmpSubModAVX512Vector(v_op, v_modulus, v_mu, cmp, v_bound,
+                                        v_diff, modulus);
+    _mm512_mask_storeu_epi64(v_result_ptr, tail, v_op);
+  }
 }
 #endif
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
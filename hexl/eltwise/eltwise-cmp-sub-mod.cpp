@@ -10,6 +10,7 @@
 #include "hexl/util/check.hpp"
 #include "hexl/util/util.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 #include "util/util-internal.hpp"
 
 namespace intel {
@@ -25,11 +26,13 @@ void EltwiseCmpSubMod(uint64_t* result, const uint64_t* operand1, uint64_t n,
   HEXL_CHECK(diff != 0, "Require diff != 0");
 
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
+  if (UseAVX512DQ()) {
+    HEXL_PROFILE_KERNEL("EltwiseCmpSubMod/AVX512DQ-64", n);
     EltwiseCmpSubModAVX512(result, operand1, n, modulus, cmp, bound, diff);
     return;
   }
 #endif
+  HEXL_PROFILE_KERNEL("EltwiseCmpSubMod/Native", n);
   EltwiseCmpSubModNative(result, operand1, n, modulus, cmp, bound, diff);
 }
 
@@ -9,44 +9,115 @@
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512IFMA
-template void EltwiseFMAModAVX512<52, 1>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
-template void EltwiseFMAModAVX512<52, 2>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
-template void EltwiseFMAModAVX512<52, 4>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
-template void EltwiseFMAModAVX512<52, 8>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 1, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 1, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 2, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 2, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 4, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 4, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 8, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<52, 8, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
-template void EltwiseFMAModAVX512<64, 1>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
-template void EltwiseFMAModAVX512<64, 2>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
-template void EltwiseFMAModAVX512<64, 4>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
-template void EltwiseFMAModAVX512<64, 8>(uint64_t* result, const uint64_t* arg1,
-                                         uint64_t arg2, const uint64_t* arg3,
-                                         uint64_t n, uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 1, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 1, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 2, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 2, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 4, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 4, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 8, 1>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
+template void EltwiseFMAModAVX512<64, 8, 2>(uint64_t* result,
+                                            const uint64_t* arg1, uint64_t arg2,
+                                            const uint64_t* arg3, uint64_t n,
+                                            uint64_t modulus);
 
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
 
-template <int BitShift, int InputModFactor>
+// Returns (arg1 * arg2 + arg3) mod q in each 64-bit lane if AddArg3, else
+// (arg1 * arg2) mod q. Assumes arg2 < q; arg1 and arg3 are reduced from
+// [0, InputModFactor * q). The result is in [0, OutputModFactor * q).
+template <int BitShift, int InputModFactor, int OutputModFactor, bool AddArg3>
+inline __m512i EltwiseFMAModAVX512Vector(__m512i varg1, __m512i varg2,
+                                         __m512i varg2_barr, __m512i varg3,
+                                         __m512i vmodulus, __m512i v2_modulus,
+                                         __m512i v4_modulus) {
+  varg1 = _mm512_hexl_small_mod_epu64<InputModFactor>(varg1, vmodulus,
+                                                      &v2_modulus, &v4_modulus);
+
+  __m512i vq = _mm512_hexl_mulhi_epi<BitShift>(varg1, varg2_barr);
+  __m512i vq_times_mod = _mm512_mullo_epi64(vq, vmodulus);
+  __m512i va_times_b = _mm512_hexl_mullo_epi<64>(varg1, varg2);
+  vq = _mm512_sub_epi64(va_times_b, vq_times_mod);
+  if (AddArg3) {
+    varg3 = _mm512_hexl_small_mod_epu64<InputModFactor>(
+        varg3, vmodulus, &v2_modulus, &v4_modulus);
+    // Conditional Barrett subtraction
+    vq = _mm512_hexl_small_mod_epu64(vq, vmodulus);
+    vq = _mm512_add_epi64(vq, varg3);
+  }
+  if (OutputModFactor == 1) {
+    vq = _mm512_hexl_small_mod_epu64(vq, vmodulus);
+  }
+  return vq;
+}
+
+template <int BitShift, int InputModFactor, int OutputModFactor>
 void EltwiseFMAModAVX512(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
                          const uint64_t* arg3, uint64_t n, uint64_t modulus) {
   HEXL_CHECK(modulus < MaximumValue(BitShift),
@@ -64,18 +135,6 @@ void EltwiseFMAModAVX512(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
   HEXL_CHECK(BitShift == 52 || BitShift == 64,
              "Invalid bitshift " << BitShift << "; need 52 or 64");
 
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseFMAModNative<InputModFactor>(result, arg1, arg2, arg3, n_mod_8,
-                                        modulus);
-    arg1 += n_mod_8;
-    if (arg3 != nullptr) {
-      arg3 += n_mod_8;
-    }
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-
   uint64_t twice_modulus = 2 * modulus;
   uint64_t four_times_modulus = 4 * modulus;
   arg2 = ReduceMod<InputModFactor>(arg2, modulus, &twice_modulus,
@@ -94,57 +153,60 @@ void EltwiseFMAModAVX512(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
 
   __m512i* vp_result = reinterpret_cast<__m512i*>(result);
 
+  uint64_t n_mod_8 = n % 8;
   if (arg3) {
     const __m512i* vp_arg3 = reinterpret_cast<const __m512i*>(arg3);
     HEXL_LOOP_UNROLL_4
     for (size_t i = n / 8; i > 0; --i) {
       __m512i varg1 = _mm512_loadu_si512(vp_arg1);
       __m512i varg3 = _mm512_loadu_si512(vp_arg3);
-
-      varg1 = _mm512_hexl_small_mod_epu64<InputModFactor>(
-          varg1, vmodulus, &v2_modulus, &v4_modulus);
-      varg3 = _mm512_hexl_small_mod_epu64<InputModFactor>(
-          varg3, vmodulus, &v2_modulus, &v4_modulus);
-
-      __m512i va_times_b = _mm512_hexl_mullo_epi<64>(varg1, varg2);
-
-      __m512i vq = _mm512_hexl_mulhi_epi<BitShift>(varg1, varg2_barr);
-      __m512i vq_times_mod = _mm512_mullo_epi64(vq, vmodulus);
-      vq = _mm512_sub_epi64(va_times_b, vq_times_mod);
-      // Conditional Barrett subtraction
-      vq = _mm512_hexl_small_mod_epu64(vq, vmodulus);
-
-      vq = _mm512_add_epi64(vq, varg3);
-      vq = _mm512_hexl_small_mod_epu64(vq, vmodulus);
-
+      __m512i vq = EltwiseFMAModAVX512Vector<BitShift, InputModFactor,
+                                             OutputModFactor, true>(
+          varg1, varg2, varg2_barr, varg3, vmodulus, v2_modulus, v4_modulus);
       _mm512_storeu_si512(vp_result, vq);
 
       ++vp_arg1;
       ++vp_result;
       ++vp_arg3;
     }
+    // Handle the n % 8 trailing elements with masked loads and stores
+    if (n_mod_8 != 0) {
+      __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+      __m512i varg1 = _mm512_maskz_loadu_epi64(tail, vp_arg1);
+      __m512i varg3 = _mm512_maskz_loadu_epi64(tail, vp_arg3);
+      __m512i vq = EltwiseFMAModAVX512Vector<BitShift, InputModFactor,
+                                             OutputModFactor, true>(
+          varg1, varg2, varg2_barr, varg3, vmodulus, v2_modulus, v4_modulus);
+      _mm512_mask_storeu_epi64(vp_result, tail, vq);
+    }
   } else {  // arg3 == nullptr
+    __m512i vzero = _mm512_setzero_si512();
     HEXL_LOOP_UNROLL_4
     for (size_t i = n / 8; i > 0; --i) {
       __m512i varg1 = _mm512_loadu_si512(vp_arg1);
-      varg1 = _mm512_hexl_small_mod_epu64<InputModFactor>(
-          varg1, vmodulus, &v2_modulus, &v4_modulus);
-
-      __m512i vq = _mm512_hexl_mulhi_epi<BitShift>(varg1, varg2_barr);
-      __m512i vq_times_mod = _mm512_mullo_epi64(vq, vmodulus);
-      __m512i va_times_b = _mm512_hexl_mullo_epi<64>(varg1, varg2);
-      vq = _mm512_sub_epi64(va_times_b, vq_times_mod);
-      // Conditional Barrett subtraction
-      vq = _mm512_hexl_small_mod_epu64(vq, vmodulus);
+      __m512i vq = EltwiseFMAModAVX512Vector<BitShift, InputModFactor,
+                                             OutputModFactor, false>(
+          varg1, varg2, varg2_barr, vzero, vmodulus, v2_modulus, v4_modulus);
       _mm512_storeu_si512(vp_result, vq);
 
       ++vp_arg1;
       ++vp_result;
     }
+    // Handle the n % 8 trailing elements with masked loads and stores
+    if (n_mod_8 != 0) {
+      __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+      __m512i varg1 = _mm512_maskz_loadu_epi64(tail, vp_arg1);
+      __m512i vq = EltwiseFMAModAVX512Vector<BitShift, InputModFactor,
+                                             OutputModFactor, false>(
+          varg1, varg2, varg2_barr, vzero, vmodulus, v2_modulus, v4_modulus);
+      _mm512_mask_storeu_epi64(vp_result, tail, vq);
+    }
   }
 }
 
 #endif
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
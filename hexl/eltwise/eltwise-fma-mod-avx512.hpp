@@ -6,17 +6,24 @@
 #include <stdint.h>
 
 #include "eltwise/eltwise-fma-mod-internal.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 
-template <int BitShift, int InputModFactor>
+// Output elements are in [0, OutputModFactor * modulus). OutputModFactor must
+// be 1 or 2.
+template <int BitShift, int InputModFactor, int OutputModFactor = 1>
 void EltwiseFMAModAVX512(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
                          const uint64_t* arg3, uint64_t n, uint64_t modulus);
 
 #endif
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
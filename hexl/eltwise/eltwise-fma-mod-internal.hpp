@@ -8,7 +8,9 @@
 namespace intel {
 namespace hexl {
 
-template <int InputModFactor>
+// Output elements are in [0, OutputModFactor * modulus). OutputModFactor must
+// be 1 or 2.
+template <int InputModFactor, int OutputModFactor = 1>
 void EltwiseFMAModNative(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
                          const uint64_t* arg3, uint64_t n, uint64_t modulus) {
   uint64_t twice_modulus = 2 * modulus;
@@ -26,14 +28,20 @@ void EltwiseFMAModNative(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
 
       uint64_t result_val =
           MultiplyMod(arg1_val, arg2, mf.BarrettFactor(), modulus);
-      *result = AddUIntMod(result_val, arg3_val, modulus);
+      *result = (OutputModFactor == 1)
+                    ? AddUIntMod(result_val, arg3_val, modulus)
+                    : result_val + arg3_val;
       result++;
     }
   } else {  // arg3 == nullptr
     for (size_t i = 0; i < n; ++i) {
       uint64_t arg1_val = ReduceMod<InputModFactor>(
           *arg1++, modulus, &twice_modulus, &four_times_modulus);
-      *result++ = MultiplyMod(arg1_val, arg2, mf.BarrettFactor(), modulus);
+      *result++ =
+          (OutputModFactor == 1)
+              ? MultiplyMod(arg1_val, arg2, mf.BarrettFactor(), modulus)
+              : MultiplyModLazy<64>(arg1_val, arg2, mf.BarrettFactor(),
+                                    modulus);
     }
   }
 }
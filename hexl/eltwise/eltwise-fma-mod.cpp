@@ -10,13 +10,41 @@
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 
 namespace intel {
 namespace hexl {
 
+namespace {
+
+// Kernels indexed by [Log2(input_mod_factor)][output_mod_factor - 1]
+const EltwiseFMAModFnPtr s_fma_mod_native_kernels[4][2] = {
+    {EltwiseFMAModNative<1, 1>, EltwiseFMAModNative<1, 2>},
+    {EltwiseFMAModNative<2, 1>, EltwiseFMAModNative<2, 2>},
+    {EltwiseFMAModNative<4, 1>, EltwiseFMAModNative<4, 2>},
+    {EltwiseFMAModNative<8, 1>, EltwiseFMAModNative<8, 2>}};
+
+#ifdef HEXL_HAS_AVX512IFMA
+const EltwiseFMAModFnPtr s_fma_mod_avx512_ifma_kernels[4][2] = {
+    {EltwiseFMAModAVX512<52, 1, 1>, EltwiseFMAModAVX512<52, 1, 2>},
+    {EltwiseFMAModAVX512<52, 2, 1>, EltwiseFMAModAVX512<52, 2, 2>},
+    {EltwiseFMAModAVX512<52, 4, 1>, EltwiseFMAModAVX512<52, 4, 2>},
+    {EltwiseFMAModAVX512<52, 8, 1>, EltwiseFMAModAVX512<52, 8, 2>}};
+#endif
+
+#ifdef HEXL_HAS_AVX512DQ
+const EltwiseFMAModFnPtr s_fma_mod_avx512_dq_kernels[4][2] = {
+    {EltwiseFMAModAVX512<64, 1, 1>, EltwiseFMAModAVX512<64, 1, 2>},
+    {EltwiseFMAModAVX512<64, 2, 1>, EltwiseFMAModAVX512<64, 2, 2>},
+    {EltwiseFMAModAVX512<64, 4, 1>, EltwiseFMAModAVX512<64, 4, 2>},
+    {EltwiseFMAModAVX512<64, 8, 1>, EltwiseFMAModAVX512<64, 8, 2>}};
+#endif
+
+}  // namespace
+
 void EltwiseFMAMod(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
                    const uint64_t* arg3, uint64_t n, uint64_t modulus,
-                   uint64_t input_mod_factor) {
+                   uint64_t input_mod_factor, uint64_t output_mod_factor) {
   HEXL_CHECK(result != nullptr, "Require result != nullptr");
   HEXL_CHECK(arg1 != nullptr, "Require arg1 != nullptr");
   HEXL_CHECK(n != 0, "Require n != 0")
@@ -26,6 +54,8 @@ void EltwiseFMAMod(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
       input_mod_factor == 1 || input_mod_factor == 2 || input_mod_factor == 4 ||
           input_mod_factor == 8,
       "input_mod_factor must be 1, 2, 4, or 8. Got " << input_mod_factor);
+  HEXL_CHECK(output_mod_factor == 1 || output_mod_factor == 2,
+             "output_mod_factor must be 1 or 2. Got " << output_mod_factor);
   HEXL_CHECK(
       arg2 < input_mod_factor * modulus,
       "arg2 " << arg2 << " exceeds bound " << (input_mod_factor * modulus));
@@ -39,65 +69,79 @@ void EltwiseFMAMod(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
              "arg3 value in EltwiseFMAMod exceeds bound "
                  << (input_mod_factor * modulus));
 
+  size_t in = static_cast<size_t>(Log2(input_mod_factor));
+  size_t out = static_cast<size_t>(output_mod_factor - 1);
+
+  switch (EltwiseFMAModKernel(modulus, input_mod_factor)) {
 #ifdef HEXL_HAS_AVX512IFMA
-  if (has_avx512ifma && input_mod_factor * modulus < (1ULL << 52)) {
-    HEXL_VLOG(3, "Calling 52-bit EltwiseFMAModAVX512");
-
-    switch (input_mod_factor) {
-      case 1:
-        EltwiseFMAModAVX512<52, 1>(result, arg1, arg2, arg3, n, modulus);
-        break;
-      case 2:
-        EltwiseFMAModAVX512<52, 2>(result, arg1, arg2, arg3, n, modulus);
-        break;
-      case 4:
-        EltwiseFMAModAVX512<52, 4>(result, arg1, arg2, arg3, n, modulus);
-        break;
-      case 8:
-        EltwiseFMAModAVX512<52, 8>(result, arg1, arg2, arg3, n, modulus);
-        break;
+    case KernelVariant::AVX512IFMA: {
+      HEXL_VLOG(3, "Calling 52-bit EltwiseFMAModAVX512");
+      HEXL_PROFILE_KERNEL("EltwiseFMAMod/AVX512IFMA", n);
+      s_fma_mod_avx512_ifma_kernels[in][out](result, arg1, arg2, arg3, n,
+                                             modulus);
+      return;
     }
-    return;
-  }
 #endif
-
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
-    HEXL_VLOG(3, "Calling 64-bit EltwiseFMAModAVX512");
-
-    switch (input_mod_factor) {
-      case 1:
-        EltwiseFMAModAVX512<64, 1>(result, arg1, arg2, arg3, n, modulus);
-        break;
-      case 2:
-        EltwiseFMAModAVX512<64, 2>(result, arg1, arg2, arg3, n, modulus);
-        break;
-      case 4:
-        EltwiseFMAModAVX512<64, 4>(result, arg1, arg2, arg3, n, modulus);
-        break;
-      case 8:
-        EltwiseFMAModAVX512<64, 8>(result, arg1, arg2, arg3, n, modulus);
-        break;
+    case KernelVariant::AVX512DQ64: {
+      HEXL_VLOG(3, "Calling 64-bit EltwiseFMAModAVX512");
+      HEXL_PROFILE_KERNEL("EltwiseFMAMod/AVX512DQ-64", n);
+      s_fma_mod_avx512_dq_kernels[in][out](result, arg1, arg2, arg3, n,
+                                           modulus);
+      return;
     }
-    return;
-  }
 #endif
+    default:
+      break;
+  }
 
   HEXL_VLOG(3, "Calling EltwiseFMAModNative");
-  switch (input_mod_factor) {
-    case 1:
-      EltwiseFMAModNative<1>(result, arg1, arg2, arg3, n, modulus);
-      break;
-    case 2:
-      EltwiseFMAModNative<2>(result, arg1, arg2, arg3, n, modulus);
-      break;
-    case 4:
-      EltwiseFMAModNative<4>(result, arg1, arg2, arg3, n, modulus);
-      break;
-    case 8:
-      EltwiseFMAModNative<8>(result, arg1, arg2, arg3, n, modulus);
+  HEXL_PROFILE_KERNEL("EltwiseFMAMod/Native", n);
+  s_fma_mod_native_kernels[in][out](result, arg1, arg2, arg3, n, modulus);
+}
+
+KernelVariant EltwiseFMAModKernel(uint64_t modulus, uint64_t input_mod_factor) {
+#ifdef HEXL_HAS_AVX512IFMA
+  if (UseAVX512IFMA() && input_mod_factor * modulus < (1ULL << 52)) {
+    return KernelVariant::AVX512IFMA;
+  }
+#else
+  (void)modulus;           // Avoid unused variable warning
+  (void)input_mod_factor;  // Avoid unused variable warning
+#endif
+#ifdef HEXL_HAS_AVX512DQ
+  if (UseAVX512DQ()) {
+    return KernelVariant::AVX512DQ64;
+  }
+#endif
+  return KernelVariant::Native;
+}
+
+EltwiseFMAModFnPtr GetEltwiseFMAModKernel(uint64_t modulus,
+                                          uint64_t input_mod_factor,
+                                          uint64_t output_mod_factor) {
+  HEXL_CHECK(
+      input_mod_factor == 1 || input_mod_factor == 2 || input_mod_factor == 4 ||
+          input_mod_factor == 8,
+      "input_mod_factor must be 1, 2, 4, or 8. Got " << input_mod_factor);
+  HEXL_CHECK(output_mod_factor == 1 || output_mod_factor == 2,
+             "output_mod_factor must be 1 or 2. Got " << output_mod_factor);
+  size_t in = static_cast<size_t>(Log2(input_mod_factor));
+  size_t out = static_cast<size_t>(output_mod_factor - 1);
+
+  switch (EltwiseFMAModKernel(modulus, input_mod_factor)) {
+#ifdef HEXL_HAS_AVX512IFMA
+    case KernelVariant::AVX512IFMA:
+      return s_fma_mod_avx512_ifma_kernels[in][out];
+#endif
+#ifdef HEXL_HAS_AVX512DQ
+    case KernelVariant::AVX512DQ64:
+      return s_fma_mod_avx512_dq_kernels[in][out];
+#endif
+    default:
       break;
   }
+  return s_fma_mod_native_kernels[in][out];
 }
 
 }  // namespace hexl
@@ -14,43 +14,100 @@
 #include "hexl/util/check.hpp"
 #include "hexl/util/compiler.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 
-template void EltwiseMultModAVX512Float<1>(uint64_t* result,
-                                           const uint64_t* operand1,
-                                           const uint64_t* operand2, uint64_t n,
-                                           uint64_t modulus);
-template void EltwiseMultModAVX512Float<2>(uint64_t* result,
-                                           const uint64_t* operand1,
-                                           const uint64_t* operand2, uint64_t n,
-                                           uint64_t modulus);
-template void EltwiseMultModAVX512Float<4>(uint64_t* result,
-                                           const uint64_t* operand1,
-                                           const uint64_t* operand2, uint64_t n,
-                                           uint64_t modulus);
-
-template void EltwiseMultModAVX512Int<1>(uint64_t* result,
-                                         const uint64_t* operand1,
-                                         const uint64_t* operand2, uint64_t n,
-                                         uint64_t modulus);
-template void EltwiseMultModAVX512Int<2>(uint64_t* result,
-                                         const uint64_t* operand1,
-                                         const uint64_t* operand2, uint64_t n,
-                                         uint64_t modulus);
-template void EltwiseMultModAVX512Int<4>(uint64_t* result,
-                                         const uint64_t* operand1,
-                                         const uint64_t* operand2, uint64_t n,
-                                         uint64_t modulus);
+template void EltwiseMultModAVX512Float<1, 1>(uint64_t* result,
+                                              const uint64_t* operand1,
+                                              const uint64_t* operand2,
+                                              uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Float<1, 2>(uint64_t* result,
+                                              const uint64_t* operand1,
+                                              const uint64_t* operand2,
+                                              uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Float<2, 1>(uint64_t* result,
+                                              const uint64_t* operand1,
+                                              const uint64_t* operand2,
+                                              uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Float<2, 2>(uint64_t* result,
+                                              const uint64_t* operand1,
+                                              const uint64_t* operand2,
+                                              uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Float<4, 1>(uint64_t* result,
+                                              const uint64_t* operand1,
+                                              const uint64_t* operand2,
+                                              uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Float<4, 2>(uint64_t* result,
+                                              const uint64_t* operand1,
+                                              const uint64_t* operand2,
+                                              uint64_t n, uint64_t modulus);
+
+template void EltwiseMultModAVX512Int<1, 1>(uint64_t* result,
+                                            const uint64_t* operand1,
+                                            const uint64_t* operand2,
+                                            uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Int<1, 2>(uint64_t* result,
+                                            const uint64_t* operand1,
+                                            const uint64_t* operand2,
+                                            uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Int<2, 1>(uint64_t* result,
+                                            const uint64_t* operand1,
+                                            const uint64_t* operand2,
+                                            uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Int<2, 2>(uint64_t* result,
+                                            const uint64_t* operand1,
+                                            const uint64_t* operand2,
+                                            uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Int<4, 1>(uint64_t* result,
+                                            const uint64_t* operand1,
+                                            const uint64_t* operand2,
+                                            uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512Int<4, 2>(uint64_t* result,
+                                            const uint64_t* operand1,
+                                            const uint64_t* operand2,
+                                            uint64_t n, uint64_t modulus);
+
+#endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+
+template void EltwiseMultModAVX512IFMA<1, 1>(uint64_t* result,
+                                             const uint64_t* operand1,
+                                             const uint64_t* operand2,
+                                             uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512IFMA<1, 2>(uint64_t* result,
+                                             const uint64_t* operand1,
+                                             const uint64_t* operand2,
+                                             uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512IFMA<2, 1>(uint64_t* result,
+                                             const uint64_t* operand1,
+                                             const uint64_t* operand2,
+                                             uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512IFMA<2, 2>(uint64_t* result,
+                                             const uint64_t* operand1,
+                                             const uint64_t* operand2,
+                                             uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512IFMA<4, 1>(uint64_t* result,
+                                             const uint64_t* operand1,
+                                             const uint64_t* operand2,
+                                             uint64_t n, uint64_t modulus);
+template void EltwiseMultModAVX512IFMA<4, 2>(uint64_t* result,
+                                             const uint64_t* operand1,
+                                             const uint64_t* operand2,
+                                             uint64_t n, uint64_t modulus);
 
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
 
-template <int BitShift, int InputModFactor, int CoeffCount>
+template <int BitShift, int InputModFactor, int OutputModFactor,
+          int CoeffCount>
 void EltwiseMultModAVX512IntLoopUnroll(__m512i* vp_result,
                                        const __m512i* vp_operand1,
                                        const __m512i* vp_operand2,
@@ -270,22 +327,24 @@ void EltwiseMultModAVX512IntLoopUnroll(__m512i* vp_result,
     vr15 = _mm512_sub_epi64(zlo15, vr15);
     vr16 = _mm512_sub_epi64(zlo16, vr16);
 
-    vr1 = _mm512_hexl_small_mod_epu64(vr1, v_modulus);
-    vr2 = _mm512_hexl_small_mod_epu64(vr2, v_modulus);
-    vr3 = _mm512_hexl_small_mod_epu64(vr3, v_modulus);
-    vr4 = _mm512_hexl_small_mod_epu64(vr4, v_modulus);
-    vr5 = _mm512_hexl_small_mod_epu64(vr5, v_modulus);
-    vr6 = _mm512_hexl_small_mod_epu64(vr6, v_modulus);
-    vr7 = _mm512_hexl_small_mod_epu64(vr7, v_modulus);
-    vr8 = _mm512_hexl_small_mod_epu64(vr8, v_modulus);
-    vr9 = _mm512_hexl_small_mod_epu64(vr9, v_modulus);
-    vr10 = _mm512_hexl_small_mod_epu64(vr10, v_modulus);
-    vr11 = _mm512_hexl_small_mod_epu64(vr11, v_modulus);
-    vr12 = _mm512_hexl_small_mod_epu64(vr12, v_modulus);
-    vr13 = _mm512_hexl_small_mod_epu64(vr13, v_modulus);
-    vr14 = _mm512_hexl_small_mod_epu64(vr14, v_modulus);
-    vr15 = _mm512_hexl_small_mod_epu64(vr15, v_modulus);
-    vr16 = _mm512_hexl_small_mod_epu64(vr16, v_modulus);
+    if (OutputModFactor == 1) {
+      vr1 = _mm512_hexl_small_mod_epu64(vr1, v_modulus);
+      vr2 = _mm512_hexl_small_mod_epu64(vr2, v_modulus);
+      vr3 = _mm512_hexl_small_mod_epu64(vr3, v_modulus);
+      vr4 = _mm512_hexl_small_mod_epu64(vr4, v_modulus);
+      vr5 = _mm512_hexl_small_mod_epu64(vr5, v_modulus);
+      vr6 = _mm512_hexl_small_mod_epu64(vr6, v_modulus);
+      vr7 = _mm512_hexl_small_mod_epu64(vr7, v_modulus);
+      vr8 = _mm512_hexl_small_mod_epu64(vr8, v_modulus);
+      vr9 = _mm512_hexl_small_mod_epu64(vr9, v_modulus);
+      vr10 = _mm512_hexl_small_mod_epu64(vr10, v_modulus);
+      vr11 = _mm512_hexl_small_mod_epu64(vr11, v_modulus);
+      vr12 = _mm512_hexl_small_mod_epu64(vr12, v_modulus);
+      vr13 = _mm512_hexl_small_mod_epu64(vr13, v_modulus);
+      vr14 = _mm512_hexl_small_mod_epu64(vr14, v_modulus);
+      vr15 = _mm512_hexl_small_mod_epu64(vr15, v_modulus);
+      vr16 = _mm512_hexl_small_mod_epu64(vr16, v_modulus);
+    }
 
     _mm512_storeu_si512(vp_result++, vr1);
     _mm512_storeu_si512(vp_result++, vr2);
@@ -308,91 +367,162 @@ void EltwiseMultModAVX512IntLoopUnroll(__m512i* vp_result,
 
 // Algorithm 1 from
 // https://hal.archives-ouvertes.fr/hal-01215845/document
-template <int BitShift, int InputModFactor>
+template <int BitShift, int InputModFactor, int OutputModFactor>
+inline __m512i EltwiseMultModAVX512IntVector(__m512i v_operand1,
+                                             __m512i v_operand2,
+                                             __m512i vbarr_lo,
+                                             __m512i v_modulus,
+                                             __m512i v_twice_mod) {
+  (void)v_twice_mod;  // Avoid unused variable
+  v_operand1 = _mm512_hexl_small_mod_epu64<InputModFactor>(
+      v_operand1, v_modulus, &v_twice_mod);
+
+  v_operand2 = _mm512_hexl_small_mod_epu64<InputModFactor>(
+      v_operand2, v_modulus, &v_twice_mod);
+
+  __m512i vprod_hi = _mm512_hexl_mulhi_epi<64>(v_operand1, v_operand2);
+  __m512i vprod_lo = _mm512_hexl_mullo_epi<64>(v_operand1, v_operand2);
+
+  __m512i c1 = _mm512_hexl_shrdi_epi64<BitShift - 1>(vprod_lo, vprod_hi);
+  __m512i c3 = _mm512_hexl_mulhi_epi<64>(c1, vbarr_lo);
+  __m512i vresult = _mm512_hexl_mullo_epi<64>(c3, v_modulus);
+  vresult = _mm512_sub_epi64(vprod_lo, vresult);
+  if (OutputModFactor == 1) {
+    vresult = _mm512_hexl_small_mod_epu64(vresult, v_modulus);
+  }
+  return vresult;
+}
+
+// As EltwiseMultModAVX512IntVector, with fully-reduced inputs and a run-time
+// modulus bit width N
+template <int OutputModFactor>
+inline __m512i EltwiseMultModAVX512IntVector(__m512i v_operand1,
+                                             __m512i v_operand2,
+                                             __m512i vbarr_lo,
+                                             __m512i v_modulus, uint64_t N) {
+  // Compute product
+  __m512i vprod_hi = _mm512_hexl_mulhi_epi<64>(v_operand1, v_operand2);
+  __m512i vprod_lo = _mm512_hexl_mullo_epi<64>(v_operand1, v_operand2);
+
+  __m512i c1 = _mm512_hexl_shrdi_epi64(vprod_lo, vprod_hi,
+                                       static_cast<unsigned int>(N - 1));
+
+  // L - N + 1 == 64, so we only need high 64 bits
+  __m512i c3 = _mm512_hexl_mulhi_epi<64>(c1, vbarr_lo);
+
+  // C4 = prod_lo - (p * c3)_lo
+  __m512i vresult = _mm512_hexl_mullo_epi<64>(c3, v_modulus);
+  vresult = _mm512_sub_epi64(vprod_lo, vresult);
+
+  // Conditional subtraction
+  if (OutputModFactor == 1) {
+    vresult = _mm512_hexl_small_mod_epu64(vresult, v_modulus);
+  }
+  return vresult;
+}
+
+template <int BitShift, int InputModFactor, int OutputModFactor>
 void EltwiseMultModAVX512IntLoopDefault(__m512i* vp_result,
                                         const __m512i* vp_operand1,
                                         const __m512i* vp_operand2,
                                         __m512i vbarr_lo, __m512i v_modulus,
-                                        __m512i v_twice_mod, uint64_t n) {
-  (void)v_twice_mod;  // Avoid unused variable
+                                        __m512i v_twice_mod, uint64_t n,
+                                        bool stream) {
   HEXL_LOOP_UNROLL_4
   for (size_t i = n / 8; i > 0; --i) {
     __m512i v_operand1 = _mm512_loadu_si512(vp_operand1);
     __m512i v_operand2 = _mm512_loadu_si512(vp_operand2);
-
-    v_operand1 = _mm512_hexl_small_mod_epu64<InputModFactor>(
-        v_operand1, v_modulus, &v_twice_mod);
-
-    v_operand2 = _mm512_hexl_small_mod_epu64<InputModFactor>(
-        v_operand2, v_modulus, &v_twice_mod);
-
-    __m512i vprod_hi = _mm512_hexl_mulhi_epi<64>(v_operand1, v_operand2);
-    __m512i vprod_lo = _mm512_hexl_mullo_epi<64>(v_operand1, v_operand2);
-
-    __m512i c1 = _mm512_hexl_shrdi_epi64<BitShift - 1>(vprod_lo, vprod_hi);
-    __m512i c3 = _mm512_hexl_mulhi_epi<64>(c1, vbarr_lo);
-    __m512i vresult = _mm512_hexl_mullo_epi<64>(c3, v_modulus);
-    vresult = _mm512_sub_epi64(vprod_lo, vresult);
-    vresult = _mm512_hexl_small_mod_epu64(vresult, v_modulus);
-    _mm512_storeu_si512(vp_result, vresult);
+    __m512i vresult =
+        EltwiseMultModAVX512IntVector<BitShift, InputModFactor,
+                                      OutputModFactor>(
+            v_operand1, v_operand2, vbarr_lo, v_modulus, v_twice_mod);
+    _mm512_hexl_store_si512(vp_result, vresult, stream);
 
     ++vp_operand1;
     ++vp_operand2;
     ++vp_result;
   }
+
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+    __m512i v_operand2 = _mm512_maskz_loadu_epi64(tail, vp_operand2);
+    __m512i vresult =
+        EltwiseMultModAVX512IntVector<BitShift, InputModFactor,
+                                      OutputModFactor>(
+            v_operand1, v_operand2, vbarr_lo, v_modulus, v_twice_mod);
+    _mm512_mask_storeu_epi64(vp_result, tail, vresult);
+  }
 }
 
-template <int BitShift, int InputModFactor>
+template <int BitShift, int InputModFactor, int OutputModFactor>
 void EltwiseMultModAVX512IntLoop(__m512i* vp_result, const __m512i* vp_operand1,
                                  const __m512i* vp_operand2, __m512i vbarr_lo,
                                  __m512i v_modulus, __m512i v_twice_mod,
-                                 uint64_t n) {
+                                 uint64_t n, bool stream) {
+  // The unrolled loops below use regular stores
+  if (stream) {
+    EltwiseMultModAVX512IntLoopDefault<BitShift, InputModFactor,
+                                       OutputModFactor>(
+        vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus, v_twice_mod,
+        n, true);
+    return;
+  }
   switch (n) {
     case 1024:
-      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor, 1024>(
+      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor,
+                                        OutputModFactor, 1024>(
           vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
           v_twice_mod);
       break;
 
     case 2048:
-      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor, 2048>(
+      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor,
+                                        OutputModFactor, 2048>(
           vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
           v_twice_mod);
       break;
 
     case 4096:
-      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor, 4096>(
+      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor,
+                                        OutputModFactor, 4096>(
           vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
           v_twice_mod);
       break;
 
     case 8192:
-      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor, 8192>(
+      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor,
+                                        OutputModFactor, 8192>(
           vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
           v_twice_mod);
       break;
 
     case 16384:
-      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor, 16384>(
+      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor,
+                                        OutputModFactor, 16384>(
           vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
           v_twice_mod);
       break;
 
     case 32768:
-      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor, 32768>(
+      EltwiseMultModAVX512IntLoopUnroll<BitShift, InputModFactor,
+                                        OutputModFactor, 32768>(
           vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
           v_twice_mod);
       break;
 
     default:
-      EltwiseMultModAVX512IntLoopDefault<BitShift, InputModFactor>(
+      EltwiseMultModAVX512IntLoopDefault<BitShift, InputModFactor,
+                                         OutputModFactor>(
           vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus, v_twice_mod,
-          n);
+          n, false);
   }
 }
 
 // Algorithm 1 from https://hal.archives-ouvertes.fr/hal-01215845/document
-template <int InputModFactor>
+template <int InputModFactor, int OutputModFactor>
 void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
                              const uint64_t* operand2, uint64_t n,
                              uint64_t modulus) {
@@ -408,16 +538,6 @@ void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
   HEXL_CHECK_BOUNDS(operand2, n, InputModFactor * modulus,
                     "operand2 exceeds bound " << (InputModFactor * modulus));
   HEXL_CHECK(modulus > 1, "Require modulus > 1");
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseMultModNative<InputModFactor>(result, operand1, operand2, n_mod_8,
-                                         modulus);
-    operand1 += n_mod_8;
-    operand2 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-
   const uint64_t logmod = MSB(modulus);
   uint64_t log2_input_mod_factor = 0;
   if (InputModFactor == 2) {
@@ -447,6 +567,8 @@ void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
   const __m512i* vp_operand1 = reinterpret_cast<const __m512i*>(operand1);
   const __m512i* vp_operand2 = reinterpret_cast<const __m512i*>(operand2);
   __m512i* vp_result = reinterpret_cast<__m512i*>(result);
+  bool stream = result != operand1 && result != operand2 &&
+                UseStreamingStores(result, n);
 
   if (reduce_mod) {
     // This case happens only when  N >= 63 - 2 * log2(input_mod_factor) = 59
@@ -454,27 +576,27 @@ void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
     // So N == 59, 60, 61, 62 are the only cases here.
     switch (N) {
       case 59: {
-        EltwiseMultModAVX512IntLoop<59, InputModFactor>(
+        EltwiseMultModAVX512IntLoop<59, InputModFactor, OutputModFactor>(
             vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
-            v_twice_mod, n);
+            v_twice_mod, n, stream);
         break;
       }
       case 60: {
-        EltwiseMultModAVX512IntLoop<60, InputModFactor>(
+        EltwiseMultModAVX512IntLoop<60, InputModFactor, OutputModFactor>(
             vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
-            v_twice_mod, n);
+            v_twice_mod, n, stream);
         break;
       }
       case 61: {
-        EltwiseMultModAVX512IntLoop<61, InputModFactor>(
+        EltwiseMultModAVX512IntLoop<61, InputModFactor, OutputModFactor>(
             vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
-            v_twice_mod, n);
+            v_twice_mod, n, stream);
         break;
       }
       case 62: {
-        EltwiseMultModAVX512IntLoop<62, InputModFactor>(
+        EltwiseMultModAVX512IntLoop<62, InputModFactor, OutputModFactor>(
             vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
-            v_twice_mod, n);
+            v_twice_mod, n, stream);
         break;
       }
       default: {
@@ -489,63 +611,75 @@ void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
     // which requires a compile-time constant for the shift.
     switch (N) {
       case 50: {
-        EltwiseMultModAVX512IntLoop<50, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<50, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 51: {
-        EltwiseMultModAVX512IntLoop<51, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<51, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 52: {
-        EltwiseMultModAVX512IntLoop<52, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<52, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 53: {
-        EltwiseMultModAVX512IntLoop<53, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<53, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 54: {
-        EltwiseMultModAVX512IntLoop<54, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<54, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 55: {
-        EltwiseMultModAVX512IntLoop<55, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<55, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 56: {
-        EltwiseMultModAVX512IntLoop<56, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<56, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 57: {
-        EltwiseMultModAVX512IntLoop<57, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<57, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 58: {
-        EltwiseMultModAVX512IntLoop<58, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<58, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 59: {
-        EltwiseMultModAVX512IntLoop<59, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<59, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 60: {
-        EltwiseMultModAVX512IntLoop<60, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<60, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       case 61: {
-        EltwiseMultModAVX512IntLoop<61, 1>(vp_result, vp_operand1, vp_operand2,
-                                           vbarr_lo, v_modulus, v_twice_mod, n);
+        EltwiseMultModAVX512IntLoop<61, 1, OutputModFactor>(
+            vp_result, vp_operand1, vp_operand2, vbarr_lo, v_modulus,
+            v_twice_mod, n, stream);
         break;
       }
       default: {
@@ -555,79 +689,105 @@ void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
         for (size_t i = n / 8; i > 0; --i) {
           __m512i v_operand1 = _mm512_loadu_si512(vp_operand1);
           __m512i v_operand2 = _mm512_loadu_si512(vp_operand2);
-
-          // Compute product
-          __m512i vprod_hi = _mm512_hexl_mulhi_epi<64>(v_operand1, v_operand2);
-          __m512i vprod_lo = _mm512_hexl_mullo_epi<64>(v_operand1, v_operand2);
-
-          __m512i c1 = _mm512_hexl_shrdi_epi64(
-              vprod_lo, vprod_hi, static_cast<unsigned int>(N - 1));
-
-          // L - N + 1 == 64, so we only need high 64 bits
-          __m512i c3 = _mm512_hexl_mulhi_epi<64>(c1, vbarr_lo);
-
-          // C4 = prod_lo - (p * c3)_lo
-          __m512i vresult = _mm512_hexl_mullo_epi<64>(c3, v_modulus);
-          vresult = _mm512_sub_epi64(vprod_lo, vresult);
-
-          // Conditional subtraction
-          vresult = _mm512_hexl_small_mod_epu64(vresult, v_modulus);
-          _mm512_storeu_si512(vp_result, vresult);
+          __m512i vresult = EltwiseMultModAVX512IntVector<OutputModFactor>(
+              v_operand1, v_operand2, vbarr_lo, v_modulus, N);
+          _mm512_hexl_store_si512(vp_result, vresult, stream);
 
           ++vp_operand1;
           ++vp_operand2;
           ++vp_result;
         }
+        // Handle the n % 8 trailing elements with masked loads and stores
+        uint64_t n_mod_8 = n % 8;
+        if (n_mod_8 != 0) {
+          __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+          __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+          __m512i v_operand2 = _mm512_maskz_loadu_epi64(tail, vp_operand2);
+          __m512i vresult = EltwiseMultModAVX512IntVector<OutputModFactor>(
+              v_operand1, v_operand2, vbarr_lo, v_modulus, N);
+          _mm512_mask_storeu_epi64(vp_result, tail, vresult);
+        }
       }
     }
   }
-  HEXL_CHECK_BOUNDS(result, n, modulus, "result exceeds bound " << modulus);
+  if (stream) {
+    // Order the streaming stores before any subsequent stores
+    _mm_sfence();
+  }
+
+  HEXL_CHECK_BOUNDS(result, n, OutputModFactor * modulus,
+                    "result exceeds bound " << (OutputModFactor * modulus));
 }
 
 // From Function 18, page 19 of https://arxiv.org/pdf/1407.3383.pdf
 // See also Algorithm 2/3 of
 // https://hal.archives-ouvertes.fr/hal-02552673/document
-template <int InputModFactor>
-inline void EltwiseMultModAVX512FloatLoopDefault(
-    __m512i* vp_result, const __m512i* vp_operand1, const __m512i* vp_operand2,
-    __m512d u, __m512d p, __m512i v_modulus, __m512i v_twice_mod, uint64_t n) {
+template <int InputModFactor, int OutputModFactor>
+inline __m512i EltwiseMultModAVX512FloatVector(__m512i v_operand1,
+                                               __m512i v_operand2, __m512d u,
+                                               __m512d p, __m512i v_modulus,
+                                               __m512i v_twice_mod) {
   (void)v_twice_mod;  // Avoid unused variable
 
   constexpr int round_mode = (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
 
-  HEXL_LOOP_UNROLL_4
-  for (size_t i = n / 8; i > 0; --i) {
-    __m512i v_operand1 = _mm512_loadu_si512(vp_operand1);
-    v_operand1 = _mm512_hexl_small_mod_epu64<InputModFactor>(
-        v_operand1, v_modulus, &v_twice_mod);
-
-    __m512i v_operand2 = _mm512_loadu_si512(vp_operand2);
-    v_operand2 = _mm512_hexl_small_mod_epu64<InputModFactor>(
-        v_operand2, v_modulus, &v_twice_mod);
-
-    __m512d x = _mm512_cvt_roundepu64_pd(v_operand1, round_mode);
-    __m512d y = _mm512_cvt_roundepu64_pd(v_operand2, round_mode);
-
-    __m512d h = _mm512_mul_pd(x, y);
-    __m512d l = _mm512_fmsub_pd(x, y, h);  // rounding error; h + l == x * y
-    __m512d b = _mm512_mul_pd(h, u);       // ~ (x * y) / p
-    __m512d c = _mm512_floor_pd(b);        // ~ floor(x * y / p)
-    __m512d d = _mm512_fnmadd_pd(c, p, h);
-    __m512d g = _mm512_add_pd(d, l);
+  v_operand1 = _mm512_hexl_small_mod_epu64<InputModFactor>(
+      v_operand1, v_modulus, &v_twice_mod);
+  v_operand2 = _mm512_hexl_small_mod_epu64<InputModFactor>(
+      v_operand2, v_modulus, &v_twice_mod);
+
+  __m512d x = _mm512_cvt_roundepu64_pd(v_operand1, round_mode);
+  __m512d y = _mm512_cvt_roundepu64_pd(v_operand2, round_mode);
+
+  __m512d h = _mm512_mul_pd(x, y);
+  __m512d l = _mm512_fmsub_pd(x, y, h);  // rounding error; h + l == x * y
+  __m512d b = _mm512_mul_pd(h, u);       // ~ (x * y) / p
+  __m512d c = _mm512_floor_pd(b);        // ~ floor(x * y / p)
+  __m512d d = _mm512_fnmadd_pd(c, p, h);
+  __m512d g = _mm512_add_pd(d, l);
+  if (OutputModFactor == 1) {
     __mmask8 m = _mm512_cmp_pd_mask(g, _mm512_setzero_pd(), _CMP_LT_OQ);
     g = _mm512_mask_add_pd(g, m, g, p);
+  } else {  // g in (-p, p), so g + p is in [0, 2p)
+    g = _mm512_add_pd(g, p);
+  }
 
-    __m512i v_result = _mm512_cvt_roundpd_epu64(g, round_mode);
+  return _mm512_cvt_roundpd_epu64(g, round_mode);
+}
 
-    _mm512_storeu_si512(vp_result, v_result);
+template <int InputModFactor, int OutputModFactor>
+inline void EltwiseMultModAVX512FloatLoopDefault(
+    __m512i* vp_result, const __m512i* vp_operand1, const __m512i* vp_operand2,
+    __m512d u, __m512d p, __m512i v_modulus, __m512i v_twice_mod, uint64_t n,
+    bool stream) {
+  HEXL_LOOP_UNROLL_4
+  for (size_t i = n / 8; i > 0; --i) {
+    __m512i v_operand1 = _mm512_loadu_si512(vp_operand1);
+    __m512i v_operand2 = _mm512_loadu_si512(vp_operand2);
+    __m512i v_result =
+        EltwiseMultModAVX512FloatVector<InputModFactor, OutputModFactor>(
+            v_operand1, v_operand2, u, p, v_modulus, v_twice_mod);
+    _mm512_hexl_store_si512(vp_result, v_result, stream);
 
     ++vp_operand1;
     ++vp_operand2;
     ++vp_result;
   }
+
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+    __m512i v_operand2 = _mm512_maskz_loadu_epi64(tail, vp_operand2);
+    __m512i v_result =
+        EltwiseMultModAVX512FloatVector<InputModFactor, OutputModFactor>(
+            v_operand1, v_operand2, u, p, v_modulus, v_twice_mod);
+    _mm512_mask_storeu_epi64(vp_result, tail, v_result);
+  }
 }
 
-template <int InputModFactor, int CoeffCount>
+template <int InputModFactor, int OutputModFactor, int CoeffCount>
 inline void EltwiseMultModAVX512FloatLoopUnroll(
     __m512i* vp_result, const __m512i* vp_operand1, const __m512i* vp_operand2,
     __m512d u, __m512d p, __m512i v_modulus, __m512i v_twice_mod) {
@@ -716,15 +876,22 @@ inline void EltwiseMultModAVX512FloatLoopUnroll(
     __m512d g3 = _mm512_add_pd(d3, l3);
     __m512d g4 = _mm512_add_pd(d4, l4);
 
-    __mmask8 m1 = _mm512_cmp_pd_mask(g1, _mm512_setzero_pd(), _CMP_LT_OQ);
-    __mmask8 m2 = _mm512_cmp_pd_mask(g2, _mm512_setzero_pd(), _CMP_LT_OQ);
-    __mmask8 m3 = _mm512_cmp_pd_mask(g3, _mm512_setzero_pd(), _CMP_LT_OQ);
-    __mmask8 m4 = _mm512_cmp_pd_mask(g4, _mm512_setzero_pd(), _CMP_LT_OQ);
-
-    g1 = _mm512_mask_add_pd(g1, m1, g1, p);
-    g2 = _mm512_mask_add_pd(g2, m2, g2, p);
-    g3 = _mm512_mask_add_pd(g3, m3, g3, p);
-    g4 = _mm512_mask_add_pd(g4, m4, g4, p);
+    if (OutputModFactor == 1) {
+      __mmask8 m1 = _mm512_cmp_pd_mask(g1, _mm512_setzero_pd(), _CMP_LT_OQ);
+      __mmask8 m2 = _mm512_cmp_pd_mask(g2, _mm512_setzero_pd(), _CMP_LT_OQ);
+      __mmask8 m3 = _mm512_cmp_pd_mask(g3, _mm512_setzero_pd(), _CMP_LT_OQ);
+      __mmask8 m4 = _mm512_cmp_pd_mask(g4, _mm512_setzero_pd(), _CMP_LT_OQ);
+
+      g1 = _mm512_mask_add_pd(g1, m1, g1, p);
+      g2 = _mm512_mask_add_pd(g2, m2, g2, p);
+      g3 = _mm512_mask_add_pd(g3, m3, g3, p);
+      g4 = _mm512_mask_add_pd(g4, m4, g4, p);
+    } else {  // g in (-p, p), so g + p is in [0, 2p)
+      g1 = _mm512_add_pd(g1, p);
+      g2 = _mm512_add_pd(g2, p);
+      g3 = _mm512_add_pd(g3, p);
+      g4 = _mm512_add_pd(g4, p);
+    }
 
     __m512i out1 = _mm512_cvt_roundpd_epu64(g1, round_mode);
     __m512i out2 = _mm512_cvt_roundpd_epu64(g2, round_mode);
@@ -738,53 +905,68 @@ inline void EltwiseMultModAVX512FloatLoopUnroll(
   }
 }
 
-template <int InputModFactor>
+template <int InputModFactor, int OutputModFactor>
 inline void EltwiseMultModAVX512FloatLoop(__m512i* vp_result,
                                           const __m512i* vp_operand1,
                                           const __m512i* vp_operand2, __m512d u,
                                           __m512d p, __m512i v_modulus,
-                                          __m512i v_twice_mod, uint64_t n) {
+                                          __m512i v_twice_mod, uint64_t n,
+                                          bool stream) {
+  // The unrolled loops below use regular stores
+  if (stream) {
+    EltwiseMultModAVX512FloatLoopDefault<InputModFactor, OutputModFactor>(
+        vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod, n,
+        true);
+    return;
+  }
   switch (n) {
     case 1024:
-      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, 1024>(
+      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, OutputModFactor,
+                                          1024>(
           vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod);
       break;
 
     case 2048:
-      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, 2048>(
+      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, OutputModFactor,
+                                          2048>(
           vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod);
       break;
 
     case 4096:
-      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, 4096>(
+      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, OutputModFactor,
+                                          4096>(
           vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod);
       break;
 
     case 8192:
-      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, 8192>(
+      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, OutputModFactor,
+                                          8192>(
           vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod);
       break;
 
     case 16384:
-      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, 16384>(
+      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, OutputModFactor,
+                                          16384>(
           vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod);
       break;
 
     case 32768:
-      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, 32768>(
+      EltwiseMultModAVX512FloatLoopUnroll<InputModFactor, OutputModFactor,
+                                          32768>(
           vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod);
       break;
 
     default:
-      EltwiseMultModAVX512FloatLoopDefault<InputModFactor>(
-          vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod, n);
+      EltwiseMultModAVX512FloatLoopDefault<InputModFactor, OutputModFactor>(
+          vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod, n,
+          false);
   }
 }
 
 // From Function 18, page 19 of https://arxiv.org/pdf/1407.3383.pdf
 // See also Algorithm 2/3 of
 // https://hal.archives-ouvertes.fr/hal-02552673/document
-template <int InputModFactor>
+template <int InputModFactor, int OutputModFactor>
 void EltwiseMultModAVX512Float(uint64_t* result, const uint64_t* operand1,
                                const uint64_t* operand2, uint64_t n,
                                uint64_t modulus) {
@@ -796,15 +978,6 @@ void EltwiseMultModAVX512Float(uint64_t* result, const uint64_t* operand1,
                     "operand1 exceeds bound " << (InputModFactor * modulus));
   HEXL_CHECK_BOUNDS(operand2, n, InputModFactor * modulus,
                     "operand2 exceeds bound " << (InputModFactor * modulus));
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseMultModNative<InputModFactor>(result, operand1, operand2, n_mod_8,
-                                         modulus);
-    operand1 += n_mod_8;
-    operand2 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
   __m512d p = _mm512_set1_pd(static_cast<double>(modulus));
   __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
   __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(modulus * 2));
@@ -818,20 +991,140 @@ void EltwiseMultModAVX512Float(uint64_t* result, const uint64_t* operand1,
   const __m512i* vp_operand1 = reinterpret_cast<const __m512i*>(operand1);
   const __m512i* vp_operand2 = reinterpret_cast<const __m512i*>(operand2);
   __m512i* vp_result = reinterpret_cast<__m512i*>(result);
+  bool stream = result != operand1 && result != operand2 &&
+                UseStreamingStores(result, n);
 
   bool no_reduce_mod = (InputModFactor * modulus) < MaximumValue(50);
   if (no_reduce_mod) {  // No input modulus reduction necessary
-    EltwiseMultModAVX512FloatLoop<1>(vp_result, vp_operand1, vp_operand2, u, p,
-                                     v_modulus, v_twice_mod, n);
+    EltwiseMultModAVX512FloatLoop<1, OutputModFactor>(
+        vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod, n,
+        stream);
   } else {
-    EltwiseMultModAVX512FloatLoop<InputModFactor>(
-        vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod, n);
+    EltwiseMultModAVX512FloatLoop<InputModFactor, OutputModFactor>(
+        vp_result, vp_operand1, vp_operand2, u, p, v_modulus, v_twice_mod, n,
+        stream);
   }
 
-  HEXL_CHECK_BOUNDS(result, n, modulus, "result exceeds bound " << modulus);
+  if (stream) {
+    // Order the streaming stores before any subsequent stores
+    _mm_sfence();
+  }
+
+  HEXL_CHECK_BOUNDS(result, n, OutputModFactor * modulus,
+                    "result exceeds bound " << (OutputModFactor * modulus));
 }
 
 #endif  // HEXL_HAS_AVX512DQ
 
+#ifdef HEXL_HAS_AVX512IFMA
+
+// Barrett reduction, as in Algorithm 1 from
+// https://hal.archives-ouvertes.fr/hal-01215845/document, with 52-bit words.
+// Let N be least such that modulus q <= 2^N. For reduced inputs x, y < q,
+// shifting x left by 52 - N bits makes the high 52-bit half of the product
+// c1 = floor(x * y / 2^N) directly. The Barrett factor floor(2^(52 + N) / q)
+// lies in [2^52, 2^53), so is stored as 2^52 + barr with the 2^52 term folded
+// into the accumulator of the multiply. The resulting quotient c3
+// underestimates floor(x * y / q) by at most 3, so x * y - c3 * q < 4q < 2^52
+// is exact in the low 52 bits, and two conditional subtractions finish the
+// reduction, or one when the output may be in [0, 2q).
+template <int InputModFactor, int OutputModFactor>
+inline __m512i EltwiseMultModAVX512IFMAVector(
+    __m512i v_operand1, __m512i v_operand2, __m512i v_modulus,
+    __m512i v_neg_mod, __m512i v_twice_mod, __m512i v_barr,
+    unsigned int shift) {
+  const __m512i v_mask52 = _mm512_set1_epi64((1LL << 52) - 1);
+  const __m512i v_zero = _mm512_setzero_si512();
+
+  v_operand1 = _mm512_hexl_small_mod_epu64<InputModFactor>(
+      v_operand1, v_modulus, &v_twice_mod);
+  v_operand2 = _mm512_hexl_small_mod_epu64<InputModFactor>(
+      v_operand2, v_modulus, &v_twice_mod);
+
+  __m512i vprod_lo = _mm512_madd52lo_epu64(v_zero, v_operand1, v_operand2);
+  __m512i c1 = _mm512_madd52hi_epu64(
+      v_zero, _mm512_slli_epi64(v_operand1, shift), v_operand2);
+  __m512i c3 = _mm512_madd52hi_epu64(c1, c1, v_barr);
+  // Low 52 bits of x * y - c3 * q
+  __m512i vresult = _mm512_madd52lo_epu64(vprod_lo, c3, v_neg_mod);
+  vresult = _mm512_and_epi64(vresult, v_mask52);
+  if (OutputModFactor == 1) {
+    return _mm512_hexl_small_mod_epu64<4>(vresult, v_modulus, &v_twice_mod);
+  }
+  return _mm512_hexl_small_mod_epu64(vresult, v_twice_mod);
+}
+
+template <int InputModFactor, int OutputModFactor>
+void EltwiseMultModAVX512IFMA(uint64_t* result, const uint64_t* operand1,
+                              const uint64_t* operand2, uint64_t n,
+                              uint64_t modulus) {
+  HEXL_CHECK(modulus < (1ULL << 50), "Require modulus < (1ULL << 50)");
+  HEXL_CHECK(modulus > 1, "Require modulus > 1");
+
+  HEXL_CHECK_BOUNDS(operand1, n, InputModFactor * modulus,
+                    "operand1 exceeds bound " << (InputModFactor * modulus));
+  HEXL_CHECK_BOUNDS(operand2, n, InputModFactor * modulus,
+                    "operand2 exceeds bound " << (InputModFactor * modulus));
+  uint64_t bit_width = MSB(modulus - 1) + 1;
+  // floor(2^(52 + bit_width) / modulus) - 2^52
+  uint64_t barr_hi = (bit_width >= 12) ? (1ULL << (bit_width - 12)) : 0;
+  uint64_t barr_lo = (bit_width >= 12) ? 0 : (1ULL << (52 + bit_width));
+  uint64_t barr =
+      DivideUInt128UInt64Lo(barr_hi, barr_lo, modulus) - (1ULL << 52);
+
+  __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
+  __m512i v_neg_mod =
+      _mm512_set1_epi64(static_cast<int64_t>((1ULL << 52) - modulus));
+  __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(2 * modulus));
+  __m512i v_barr = _mm512_set1_epi64(static_cast<int64_t>(barr));
+  unsigned int shift = static_cast<unsigned int>(52 - bit_width);
+
+  const __m512i* vp_operand1 = reinterpret_cast<const __m512i*>(operand1);
+  const __m512i* vp_operand2 = reinterpret_cast<const __m512i*>(operand2);
+  __m512i* vp_result = reinterpret_cast<__m512i*>(result);
+  bool stream = result != operand1 && result != operand2 &&
+                UseStreamingStores(result, n);
+
+  HEXL_LOOP_UNROLL_4
+  for (size_t i = n / 8; i > 0; --i) {
+    __m512i v_operand1 = _mm512_loadu_si512(vp_operand1);
+    __m512i v_operand2 = _mm512_loadu_si512(vp_operand2);
+    __m512i vresult =
+        EltwiseMultModAVX512IFMAVector<InputModFactor, OutputModFactor>(
+            v_operand1, v_operand2, v_modulus, v_neg_mod, v_twice_mod, v_barr,
+            shift);
+    _mm512_hexl_store_si512(vp_result, vresult, stream);
+
+    ++vp_operand1;
+    ++vp_operand2;
+    ++vp_result;
+  }
+
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+    __m512i v_operand2 = _mm512_maskz_loadu_epi64(tail, vp_operand2);
+    __m512i vresult =
+        EltwiseMultModAVX512IFMAVector<InputModFactor, OutputModFactor>(
+            v_operand1, v_operand2, v_modulus, v_neg_mod, v_twice_mod, v_barr,
+            shift);
+    _mm512_mask_storeu_epi64(vp_result, tail, vresult);
+  }
+
+  if (stream) {
+    // Order the streaming stores before any subsequent stores
+    _mm_sfence();
+  }
+
+  HEXL_CHECK_BOUNDS(result, n, OutputModFactor * modulus,
+                    "result exceeds bound " << (OutputModFactor * modulus));
+}
+
+#endif  // HEXL_HAS_AVX512IFMA
+
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
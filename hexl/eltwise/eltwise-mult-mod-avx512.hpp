@@ -8,14 +8,20 @@
 #include "eltwise/eltwise-mult-mod-internal.hpp"
 #include "hexl/eltwise/eltwise-mult-mod.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
+// Each kernel returns results in [0, OutputModFactor * modulus).
+// OutputModFactor must be 1 or 2.
+
 #ifdef HEXL_HAS_AVX512DQ
 
 // Algorithm 1 from https://hal.archives-ouvertes.fr/hal-01215845/document
-template <int InputModFactor>
+template <int InputModFactor, int OutputModFactor = 1>
 void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
                              const uint64_t* operand2, uint64_t n,
                              uint64_t modulus);
@@ -23,12 +29,25 @@ void EltwiseMultModAVX512Int(uint64_t* result, const uint64_t* operand1,
 // From Function 18, page 19 of https://arxiv.org/pdf/1407.3383.pdf
 // See also Algorithm 2/3 of
 // https://hal.archives-ouvertes.fr/hal-02552673/document
-template <int InputModFactor>
+template <int InputModFactor, int OutputModFactor = 1>
 void EltwiseMultModAVX512Float(uint64_t* result, const uint64_t* operand1,
                                const uint64_t* operand2, uint64_t n,
                                uint64_t modulus);
 
 #endif  // HEXL_HAS_AVX512DQ
 
+#ifdef HEXL_HAS_AVX512IFMA
+
+// Barrett reduction of the 104-bit product computed with 52-bit integer
+// fused multiply-adds. Requires modulus < 2^50
+template <int InputModFactor, int OutputModFactor = 1>
+void EltwiseMultModAVX512IFMA(uint64_t* result, const uint64_t* operand1,
+                              const uint64_t* operand2, uint64_t n,
+                              uint64_t modulus);
+
+#endif  // HEXL_HAS_AVX512IFMA
+
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
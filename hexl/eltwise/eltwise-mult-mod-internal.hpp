@@ -22,13 +22,15 @@ namespace hexl {
 /// less than the modulus.
 /// @param[in] n Number of elements in each vector
 /// @param[in] modulus Modulus with which to perform modular reduction
-/// @param[in] input_mod_factor Assumes input elements are in [0,
-/// input_mod_factor * p) Must be 1, 2 or 4.
+/// @tparam InputModFactor Assumes input elements are in [0,
+/// InputModFactor * modulus). Must be 1, 2 or 4.
+/// @tparam OutputModFactor Output elements are in [0, OutputModFactor *
+/// modulus). Must be 1 or 2.
 /// @details Computes \p result[i] = (\p operand1[i] * \p operand2[i]) mod \p
 /// modulus for i=0, ..., \p n - 1
 /// @details Algorithm 1 of
 /// https://hal.archives-ouvertes.fr/hal-01215845/document
-template <int InputModFactor>
+template <int InputModFactor, int OutputModFactor = 1>
 void EltwiseMultModNative(uint64_t* result, const uint64_t* operand1,
                           const uint64_t* operand2, uint64_t n,
                           uint64_t modulus) {
@@ -76,8 +78,11 @@ void EltwiseMultModNative(uint64_t* result, const uint64_t* operand1,
     // C4 = prod_lo - (p * c3)_lo
     c4 = prod_lo - c3 * modulus;
 
-    // Conditional subtraction
-    *result = (c4 >= modulus) ? (c4 - modulus) : c4;
+    // Conditional subtraction, skipped if c4 in [0, 2 * modulus) suffices
+    if (OutputModFactor == 1) {
+      c4 = (c4 >= modulus) ? (c4 - modulus) : c4;
+    }
+    *result = c4;
 
     ++operand1;
     ++operand2;
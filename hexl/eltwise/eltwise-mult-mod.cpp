@@ -11,13 +11,43 @@
 #include "hexl/util/aligned-allocator.hpp"
 #include "hexl/util/check.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 
 namespace intel {
 namespace hexl {
 
+namespace {
+
+// Kernels indexed by [Log2(input_mod_factor)][output_mod_factor - 1]
+const EltwiseMultModFnPtr s_mult_mod_native_kernels[3][2] = {
+    {EltwiseMultModNative<1, 1>, EltwiseMultModNative<1, 2>},
+    {EltwiseMultModNative<2, 1>, EltwiseMultModNative<2, 2>},
+    {EltwiseMultModNative<4, 1>, EltwiseMultModNative<4, 2>}};
+
+#ifdef HEXL_HAS_AVX512DQ
+const EltwiseMultModFnPtr s_mult_mod_avx512_float_kernels[3][2] = {
+    {EltwiseMultModAVX512Float<1, 1>, EltwiseMultModAVX512Float<1, 2>},
+    {EltwiseMultModAVX512Float<2, 1>, EltwiseMultModAVX512Float<2, 2>},
+    {EltwiseMultModAVX512Float<4, 1>, EltwiseMultModAVX512Float<4, 2>}};
+
+const EltwiseMultModFnPtr s_mult_mod_avx512_int_kernels[3][2] = {
+    {EltwiseMultModAVX512Int<1, 1>, EltwiseMultModAVX512Int<1, 2>},
+    {EltwiseMultModAVX512Int<2, 1>, EltwiseMultModAVX512Int<2, 2>},
+    {EltwiseMultModAVX512Int<4, 1>, EltwiseMultModAVX512Int<4, 2>}};
+#endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+const EltwiseMultModFnPtr s_mult_mod_avx512_ifma_kernels[3][2] = {
+    {EltwiseMultModAVX512IFMA<1, 1>, EltwiseMultModAVX512IFMA<1, 2>},
+    {EltwiseMultModAVX512IFMA<2, 1>, EltwiseMultModAVX512IFMA<2, 2>},
+    {EltwiseMultModAVX512IFMA<4, 1>, EltwiseMultModAVX512IFMA<4, 2>}};
+#endif
+
+}  // namespace
+
 void EltwiseMultMod(uint64_t* result, const uint64_t* operand1,
                     const uint64_t* operand2, uint64_t n, uint64_t modulus,
-                    uint64_t input_mod_factor) {
+                    uint64_t input_mod_factor, uint64_t output_mod_factor) {
   HEXL_CHECK(result != nullptr, "Require result != nullptr");
   HEXL_CHECK(operand1 != nullptr, "Require operand1 != nullptr");
   HEXL_CHECK(operand2 != nullptr, "Require operand2 != nullptr");
@@ -28,56 +58,94 @@ void EltwiseMultMod(uint64_t* result, const uint64_t* operand1,
   HEXL_CHECK(
       input_mod_factor == 1 || input_mod_factor == 2 || input_mod_factor == 4,
       "Require input_mod_factor = 1, 2, or 4")
+  HEXL_CHECK(output_mod_factor == 1 || output_mod_factor == 2,
+             "Require output_mod_factor = 1 or 2")
   HEXL_CHECK_BOUNDS(operand1, n, input_mod_factor * modulus,
                     "operand1 exceeds bound " << (input_mod_factor * modulus))
   HEXL_CHECK_BOUNDS(operand2, n, input_mod_factor * modulus,
                     "operand2 exceeds bound " << (input_mod_factor * modulus))
 
+  size_t in = static_cast<size_t>(Log2(input_mod_factor));
+  size_t out = static_cast<size_t>(output_mod_factor - 1);
+
+  switch (EltwiseMultModKernel(modulus, input_mod_factor)) {
+#ifdef HEXL_HAS_AVX512IFMA
+    case KernelVariant::AVX512IFMA: {
+      HEXL_PROFILE_KERNEL("EltwiseMultMod/AVX512IFMA", n);
+      s_mult_mod_avx512_ifma_kernels[in][out](result, operand1, operand2, n,
+                                              modulus);
+      return;
+    }
+#endif
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
-    if (modulus < (1ULL << 50)) {
-      switch (input_mod_factor) {
-        case 1:
-          EltwiseMultModAVX512Float<1>(result, operand1, operand2, n, modulus);
-          break;
-        case 2:
-          EltwiseMultModAVX512Float<2>(result, operand1, operand2, n, modulus);
-          break;
-        case 4:
-          EltwiseMultModAVX512Float<4>(result, operand1, operand2, n, modulus);
-          break;
-      }
+    case KernelVariant::AVX512Float: {
+      HEXL_PROFILE_KERNEL("EltwiseMultMod/AVX512Float", n);
+      s_mult_mod_avx512_float_kernels[in][out](result, operand1, operand2, n,
+                                               modulus);
       return;
-    } else {
-      switch (input_mod_factor) {
-        case 1:
-          EltwiseMultModAVX512Int<1>(result, operand1, operand2, n, modulus);
-          break;
-        case 2:
-          EltwiseMultModAVX512Int<2>(result, operand1, operand2, n, modulus);
-          break;
-        case 4:
-          EltwiseMultModAVX512Int<4>(result, operand1, operand2, n, modulus);
-          break;
-      }
+    }
+    case KernelVariant::AVX512DQ64: {
+      HEXL_PROFILE_KERNEL("EltwiseMultMod/AVX512DQ-64", n);
+      s_mult_mod_avx512_int_kernels[in][out](result, operand1, operand2, n,
+                                             modulus);
       return;
     }
-  }
 #endif
+    default:
+      break;
+  }
 
   HEXL_VLOG(3, "Calling EltwiseMultModNative");
-  switch (input_mod_factor) {
-    case 1:
-      EltwiseMultModNative<1>(result, operand1, operand2, n, modulus);
-      break;
-    case 2:
-      EltwiseMultModNative<2>(result, operand1, operand2, n, modulus);
-      break;
-    case 4:
-      EltwiseMultModNative<4>(result, operand1, operand2, n, modulus);
+  HEXL_PROFILE_KERNEL("EltwiseMultMod/Native", n);
+  s_mult_mod_native_kernels[in][out](result, operand1, operand2, n, modulus);
+}
+
+KernelVariant EltwiseMultModKernel(uint64_t modulus,
+                                   uint64_t input_mod_factor) {
+  (void)input_mod_factor;  // Avoid unused variable warning
+#ifdef HEXL_HAS_AVX512IFMA
+  if (UseAVX512IFMA() && modulus < (1ULL << 50)) {
+    return KernelVariant::AVX512IFMA;
+  }
+#endif
+#ifdef HEXL_HAS_AVX512DQ
+  if (UseAVX512DQ()) {
+    return (modulus < (1ULL << 50)) ? KernelVariant::AVX512Float
+                                    : KernelVariant::AVX512DQ64;
+  }
+#else
+  (void)modulus;  // Avoid unused variable warning
+#endif
+  return KernelVariant::Native;
+}
+
+EltwiseMultModFnPtr GetEltwiseMultModKernel(uint64_t modulus,
+                                            uint64_t input_mod_factor,
+                                            uint64_t output_mod_factor) {
+  HEXL_CHECK(
+      input_mod_factor == 1 || input_mod_factor == 2 || input_mod_factor == 4,
+      "Require input_mod_factor = 1, 2, or 4")
+  HEXL_CHECK(output_mod_factor == 1 || output_mod_factor == 2,
+             "Require output_mod_factor = 1 or 2")
+  size_t in = static_cast<size_t>(Log2(input_mod_factor));
+  size_t out = static_cast<size_t>(output_mod_factor - 1);
+
+  switch (EltwiseMultModKernel(modulus, input_mod_factor)) {
+#ifdef HEXL_HAS_AVX512IFMA
+    case KernelVariant::AVX512IFMA:
+      return s_mult_mod_avx512_ifma_kernels[in][out];
+#endif
+#ifdef HEXL_HAS_AVX512DQ
+    case KernelVariant::AVX512Float:
+      return s_mult_mod_avx512_float_kernels[in][out];
+    case KernelVariant::AVX512DQ64:
+      return s_mult_mod_avx512_int_kernels[in][out];
+#endif
+    default:
       break;
   }
-  return;
+  return s_mult_mod_native_kernels[in][out];
 }
+
 }  // namespace hexl
 }  // namespace intel
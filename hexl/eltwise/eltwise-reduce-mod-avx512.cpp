@@ -12,12 +12,65 @@
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 
+// Reduces each lane of v_op from [0, InputModFactor * q) to
+// [0, OutputModFactor * q), where InputModFactor == 0 denotes arbitrary input
+template <int InputModFactor, int OutputModFactor>
+inline __m512i EltwiseReduceModAVX512Vector(__m512i v_op, __m512i v_modulus,
+                                            __m512i v_twice_mod,
+                                            __m512i v_bf) {
+  if (InputModFactor == 0) {
+    v_op = _mm512_hexl_barrett_reduce64(v_op, v_modulus, v_bf);
+  } else if (InputModFactor == 2) {
+    v_op = _mm512_hexl_small_mod_epu64(v_op, v_modulus);
+  } else if (InputModFactor == 4) {
+    v_op = _mm512_hexl_small_mod_epu64(v_op, v_twice_mod);
+    if (OutputModFactor == 1) {
+      v_op = _mm512_hexl_small_mod_epu64(v_op, v_modulus);
+    }
+  }
+  HEXL_CHECK_BOUNDS(ExtractValues(v_op).data(), 8,
+                    OutputModFactor * ExtractValues(v_modulus)[0],
+                    "v_op exceeds bound "
+                        << OutputModFactor * ExtractValues(v_modulus)[0]);
+  return v_op;
+}
+
+template <int InputModFactor, int OutputModFactor>
+void EltwiseReduceModAVX512Loop(uint64_t* result, const uint64_t* operand,
+                                uint64_t n, __m512i v_modulus,
+                                __m512i v_twice_mod, __m512i v_bf) {
+  const __m512i* v_operand = reinterpret_cast<const __m512i*>(operand);
+  __m512i* v_result = reinterpret_cast<__m512i*>(result);
+
+  for (size_t i = n / 8; i > 0; --i) {
+    __m512i v_op = _mm512_loadu_si512(v_operand);
+    v_op = EltwiseReduceModAVX512Vector<InputModFactor, OutputModFactor>(
+        v_op, v_modulus, v_twice_mod, v_bf);
+    _mm512_storeu_si512(v_result, v_op);
+    ++v_operand;
+    ++v_result;
+  }
+
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_op = _mm512_maskz_loadu_epi64(tail, v_operand);
+    v_op = EltwiseReduceModAVX512Vector<InputModFactor, OutputModFactor>(
+        v_op, v_modulus, v_twice_mod, v_bf);
+    _mm512_mask_storeu_epi64(v_result, tail, v_op);
+  }
+}
+
 void EltwiseReduceModAVX512(uint64_t* result, const uint64_t* operand,
                             uint64_t n, uint64_t modulus,
                             uint64_t input_mod_factor,
@@ -33,74 +86,30 @@ void EltwiseReduceModAVX512(uint64_t* result, const uint64_t* operand,
   HEXL_CHECK(input_mod_factor != output_mod_factor,
              "input_mod_factor must not be equal to output_mod_factor ");
 
-  uint64_t n_tmp = n;
   uint64_t barrett_factor = MultiplyFactor(1, 64, modulus).BarrettFactor();
   __m512i v_bf = _mm512_set1_epi64(static_cast<int64_t>(barrett_factor));
-
-  // Deals with n not divisible by 8
-  uint64_t n_mod_8 = n_tmp % 8;
-  if (n_mod_8 != 0) {
-    EltwiseReduceModNative(result, operand, n_mod_8, modulus, input_mod_factor,
-                           output_mod_factor);
-    operand += n_mod_8;
-    result += n_mod_8;
-    n_tmp -= n_mod_8;
-  }
-
-  uint64_t twice_mod = modulus << 1;
-  const __m512i* v_operand = reinterpret_cast<const __m512i*>(operand);
-  __m512i* v_result = reinterpret_cast<__m512i*>(result);
   __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
-  __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(twice_mod));
+  __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(modulus << 1));
 
   switch (input_mod_factor) {
     case 0:
-      for (size_t i = 0; i < n_tmp; i += 8) {
-        __m512i v_op = _mm512_loadu_si512(v_operand);
-        v_op = _mm512_hexl_barrett_reduce64(v_op, v_modulus, v_bf);
-        HEXL_CHECK_BOUNDS(ExtractValues(v_op).data(), 8, modulus,
-                          "v_op exceeds bound " << modulus);
-        _mm512_storeu_si512(v_result, v_op);
-        ++v_operand;
-        ++v_result;
-      }
+      EltwiseReduceModAVX512Loop<0, 1>(result, operand, n, v_modulus,
+                                       v_twice_mod, v_bf);
       break;
 
     case 2:
-      for (size_t i = 0; i < n_tmp; i += 8) {
-        __m512i v_op = _mm512_loadu_si512(v_operand);
-        v_op = _mm512_hexl_small_mod_epu64(v_op, v_modulus);
-        HEXL_CHECK_BOUNDS(ExtractValues(v_op).data(), 8, modulus,
-                          "v_op exceeds bound " << modulus);
-        _mm512_storeu_si512(v_result, v_op);
-        ++v_operand;
-        ++v_result;
-      }
+      EltwiseReduceModAVX512Loop<2, 1>(result, operand, n, v_modulus,
+                                       v_twice_mod, v_bf);
       break;
 
     case 4:
       if (output_mod_factor == 1) {
-        for (size_t i = 0; i < n_tmp; i += 8) {
-          __m512i v_op = _mm512_loadu_si512(v_operand);
-          v_op = _mm512_hexl_small_mod_epu64(v_op, v_twice_mod);
-          v_op = _mm512_hexl_small_mod_epu64(v_op, v_modulus);
-          HEXL_CHECK_BOUNDS(ExtractValues(v_op).data(), 8, modulus,
-                            "v_op exceeds bound " << modulus);
-          _mm512_storeu_si512(v_result, v_op);
-          ++v_operand;
-          ++v_result;
-        }
+        EltwiseReduceModAVX512Loop<4, 1>(result, operand, n, v_modulus,
+                                         v_twice_mod, v_bf);
       }
       if (output_mod_factor == 2) {
-        for (size_t i = 0; i < n_tmp; i += 8) {
-          __m512i v_op = _mm512_loadu_si512(v_operand);
-          v_op = _mm512_hexl_small_mod_epu64(v_op, v_twice_mod);
-          HEXL_CHECK_BOUNDS(ExtractValues(v_op).data(), 8, twice_mod,
-                            "v_op exceeds bound " << twice_mod);
-          _mm512_storeu_si512(v_result, v_op);
-          ++v_operand;
-          ++v_result;
-        }
+        EltwiseReduceModAVX512Loop<4, 2>(result, operand, n, v_modulus,
+                                         v_twice_mod, v_bf);
       }
       break;
   }
@@ -108,5 +117,7 @@ void EltwiseReduceModAVX512(uint64_t* result, const uint64_t* operand,
 
 #endif
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
@@ -5,12 +5,18 @@
 
 #include <stdint.h>
 
+#include "util/isa-target.hpp"
+
 namespace intel {
 namespace hexl {
+
+HEXL_BEGIN_TARGET_AVX512
 void EltwiseReduceModAVX512(uint64_t* result, const uint64_t* operand,
                             uint64_t n, uint64_t modulus,
                             uint64_t input_mod_factor,
                             uint64_t output_mod_factor);
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
@@ -9,6 +9,7 @@
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 
 namespace intel {
 namespace hexl {
@@ -84,19 +85,22 @@ void EltwiseReduceMod(uint64_t* result, const uint64_t* operand, uint64_t n,
              "output_mod_factor must be 1 or 2 " << output_mod_factor);
 
   if (input_mod_factor == output_mod_factor && (operand != result)) {
+    HEXL_PROFILE_KERNEL("EltwiseReduceMod/Copy", n);
     for (size_t i = 0; i < n; ++i) {
       result[i] = operand[i];
     }
     return;
   }
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
+  if (UseAVX512DQ()) {
+    HEXL_PROFILE_KERNEL("EltwiseReduceMod/AVX512DQ-64", n);
     EltwiseReduceModAVX512(result, operand, n, modulus, input_mod_factor,
                            output_mod_factor);
     return;
   }
 #endif
   HEXL_VLOG(3, "Calling EltwiseReduceModNative");
+  HEXL_PROFILE_KERNEL("EltwiseReduceMod/Native", n);
   EltwiseReduceModNative(result, operand, n, modulus, input_mod_factor,
                          output_mod_factor);
 }
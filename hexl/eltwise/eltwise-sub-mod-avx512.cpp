@@ -10,12 +10,15 @@
 #include "hexl/eltwise/eltwise-sub-mod.hpp"
 #include "hexl/util/check.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 #ifdef HEXL_HAS_AVX512DQ
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
                          const uint64_t* operand2, uint64_t n,
                          uint64_t modulus) {
@@ -30,15 +33,6 @@ void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
   HEXL_CHECK_BOUNDS(operand2, n, modulus,
                     "pre-sub value in operand2 exceeds bound " << modulus);
 
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseSubModNative(result, operand1, operand2, n_mod_8, modulus);
-    operand1 += n_mod_8;
-    operand2 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-
   __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
   __m512i* vp_result = reinterpret_cast<__m512i*>(result);
   const __m512i* vp_operand1 = reinterpret_cast<const __m512i*>(operand1);
@@ -59,6 +53,17 @@ void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
     ++vp_operand2;
   }
 
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+    __m512i v_operand2 = _mm512_maskz_loadu_epi64(tail, vp_operand2);
+    __m512i v_result =
+        _mm512_hexl_small_sub_mod_epi64(v_operand1, v_operand2, v_modulus);
+    _mm512_mask_storeu_epi64(vp_result, tail, v_result);
+  }
+
   HEXL_CHECK_BOUNDS(result, n, modulus, "result exceeds bound " << modulus);
 }
 
@@ -73,14 +78,6 @@ void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
                     "pre-sub value in operand1 exceeds bound " << modulus);
   HEXL_CHECK(operand2 < modulus, "Require operand2 < modulus");
 
-  uint64_t n_mod_8 = n % 8;
-  if (n_mod_8 != 0) {
-    EltwiseSubModNative(result, operand1, operand2, n_mod_8, modulus);
-    operand1 += n_mod_8;
-    result += n_mod_8;
-    n -= n_mod_8;
-  }
-
   __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
   __m512i* vp_result = reinterpret_cast<__m512i*>(result);
   const __m512i* vp_operand1 = reinterpret_cast<const __m512i*>(operand1);
@@ -99,9 +96,21 @@ void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
     ++vp_operand1;
   }
 
+  // Handle the n % 8 trailing elements with masked loads and stores
+  uint64_t n_mod_8 = n % 8;
+  if (n_mod_8 != 0) {
+    __mmask8 tail = _mm512_hexl_tail_mask_epi64(n_mod_8);
+    __m512i v_operand1 = _mm512_maskz_loadu_epi64(tail, vp_operand1);
+    __m512i v_result =
+        _mm512_hexl_small_sub_mod_epi64(v_operand1, v_operand2, v_modulus);
+    _mm512_mask_storeu_epi64(vp_result, tail, v_result);
+  }
+
   HEXL_CHECK_BOUNDS(result, n, modulus, "result exceeds bound " << modulus);
 }
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
 
@@ -5,9 +5,13 @@
 
 #include <stdint.h>
 
+#include "util/isa-target.hpp"
+
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
                          const uint64_t* operand2, uint64_t n,
                          uint64_t modulus);
@@ -15,5 +19,7 @@ void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
 void EltwiseSubModAVX512(uint64_t* result, const uint64_t* operand1,
                          uint64_t operand2, uint64_t n, uint64_t modulus);
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
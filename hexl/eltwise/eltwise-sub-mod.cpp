@@ -8,6 +8,7 @@
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 
 namespace intel {
 namespace hexl {
@@ -77,13 +78,15 @@ void EltwiseSubMod(uint64_t* result, const uint64_t* operand1,
                     "pre-sub value in operand2 exceeds bound " << modulus);
 
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
+  if (UseAVX512DQ()) {
+    HEXL_PROFILE_KERNEL("EltwiseSubMod/AVX512DQ-64", n);
     EltwiseSubModAVX512(result, operand1, operand2, n, modulus);
     return;
   }
 #endif
 
   HEXL_VLOG(3, "Calling EltwiseSubModNative");
+  HEXL_PROFILE_KERNEL("EltwiseSubMod/Native", n);
   EltwiseSubModNative(result, operand1, operand2, n, modulus);
 }
 
@@ -98,13 +101,15 @@ void EltwiseSubMod(uint64_t* result, const uint64_t* operand1,
   HEXL_CHECK(operand2 < modulus, "Require operand2 < modulus");
 
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq) {
+  if (UseAVX512DQ()) {
+    HEXL_PROFILE_KERNEL("EltwiseSubModScalar/AVX512DQ-64", n);
     EltwiseSubModAVX512(result, operand1, operand2, n, modulus);
     return;
   }
 #endif
 
   HEXL_VLOG(3, "Calling EltwiseSubModNative");
+  HEXL_PROFILE_KERNEL("EltwiseSubModScalar/Native", n);
   EltwiseSubModNative(result, operand1, operand2, n, modulus);
 }
 
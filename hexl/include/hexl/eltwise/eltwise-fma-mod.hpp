@@ -5,6 +5,8 @@
 
 #include <stdint.h>
 
+#include "hexl/util/kernel-variant.hpp"
+
 namespace intel {
 namespace hexl {
 
@@ -19,9 +21,37 @@ namespace hexl {
 /// in the range \f$ [2, 2^{61} - 1]\f$
 /// @param[in] input_mod_factor Assumes input elements are in [0,
 /// input_mod_factor * modulus). Must be 1, 2, 4, or 8.
+/// @param[in] output_mod_factor Output elements are in [0, output_mod_factor *
+/// modulus). Must be 1 or 2. Choosing 2 skips the final conditional
+/// subtraction.
 void EltwiseFMAMod(uint64_t* result, const uint64_t* arg1, uint64_t arg2,
                    const uint64_t* arg3, uint64_t n, uint64_t modulus,
-                   uint64_t input_mod_factor);
+                   uint64_t input_mod_factor, uint64_t output_mod_factor = 1);
+
+/// @brief Returns the kernel variant used by EltwiseFMAMod on this machine
+/// @param[in] modulus Modulus with which to perform modular reduction
+/// @param[in] input_mod_factor Assumes input elements are in [0,
+/// input_mod_factor * modulus). Must be 1, 2, 4, or 8.
+KernelVariant EltwiseFMAModKernel(uint64_t modulus, uint64_t input_mod_factor);
+
+/// @brief Pointer to an EltwiseFMAMod kernel for a fixed input_mod_factor
+/// and output_mod_factor
+using EltwiseFMAModFnPtr = void (*)(uint64_t* result, const uint64_t* arg1,
+                                    uint64_t arg2, const uint64_t* arg3,
+                                    uint64_t n, uint64_t modulus);
+
+/// @brief Returns the kernel EltwiseFMAMod would dispatch to on this machine
+/// for \p modulus, \p input_mod_factor and \p output_mod_factor
+/// @details The kernel performs no argument validation, so its arguments must
+/// satisfy the requirements of EltwiseFMAMod
+/// @param[in] modulus Modulus with which to perform modular reduction
+/// @param[in] input_mod_factor Assumes input elements are in [0,
+/// input_mod_factor * modulus). Must be 1, 2, 4, or 8.
+/// @param[in] output_mod_factor Output elements are in [0, output_mod_factor *
+/// modulus). Must be 1 or 2.
+EltwiseFMAModFnPtr GetEltwiseFMAModKernel(uint64_t modulus,
+                                          uint64_t input_mod_factor,
+                                          uint64_t output_mod_factor = 1);
 
 }  // namespace hexl
 }  // namespace intel
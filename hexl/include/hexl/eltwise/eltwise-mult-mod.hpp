@@ -5,6 +5,8 @@
 
 #include <stdint.h>
 
+#include "hexl/util/kernel-variant.hpp"
+
 namespace intel {
 namespace hexl {
 
@@ -18,11 +20,43 @@ namespace hexl {
 /// @param[in] modulus Modulus with which to perform modular reduction
 /// @param[in] input_mod_factor Assumes input elements are in [0,
 /// input_mod_factor * p) Must be 1, 2 or 4.
+/// @param[in] output_mod_factor Output elements are in [0, output_mod_factor *
+/// modulus). Must be 1 or 2. Choosing 2 skips the final conditional
+/// subtraction, e.g. when the result feeds an operation with input_mod_factor
+/// 2 or 4.
 /// @details Computes \p result[i] = (\p operand1[i] * \p operand2[i]) mod \p
 /// modulus for i=0, ..., \p n - 1
 void EltwiseMultMod(uint64_t* result, const uint64_t* operand1,
                     const uint64_t* operand2, uint64_t n, uint64_t modulus,
-                    uint64_t input_mod_factor);
+                    uint64_t input_mod_factor, uint64_t output_mod_factor = 1);
+
+/// @brief Returns the kernel variant used by EltwiseMultMod on this machine
+/// @param[in] modulus Modulus with which to perform modular reduction
+/// @param[in] input_mod_factor Assumes input elements are in [0,
+/// input_mod_factor * modulus). Must be 1, 2 or 4.
+KernelVariant EltwiseMultModKernel(uint64_t modulus, uint64_t input_mod_factor);
+
+/// @brief Pointer to an EltwiseMultMod kernel for a fixed input_mod_factor
+/// and output_mod_factor
+using EltwiseMultModFnPtr = void (*)(uint64_t* result, const uint64_t* operand1,
+                                     const uint64_t* operand2, uint64_t n,
+                                     uint64_t modulus);
+
+/// @brief Returns the kernel EltwiseMultMod would dispatch to on this machine
+/// for \p modulus, \p input_mod_factor and \p output_mod_factor
+/// @details Allows callers to resolve the dispatch once and then call the
+/// kernel directly, e.g. for many small vectors with the same modulus. The
+/// kernel performs no argument validation, so its arguments must satisfy the
+/// requirements of EltwiseMultMod. Later calls to SetMaxISATier do not affect
+/// a returned kernel.
+/// @param[in] modulus Modulus with which to perform modular reduction
+/// @param[in] input_mod_factor Assumes input elements are in [0,
+/// input_mod_factor * modulus). Must be 1, 2 or 4.
+/// @param[in] output_mod_factor Output elements are in [0, output_mod_factor *
+/// modulus). Must be 1 or 2.
+EltwiseMultModFnPtr GetEltwiseMultModKernel(uint64_t modulus,
+                                            uint64_t input_mod_factor,
+                                            uint64_t output_mod_factor = 1);
 
 }  // namespace hexl
 }  // namespace intel
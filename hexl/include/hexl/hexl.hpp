@@ -16,5 +16,13 @@
 #include "hexl/util/check.hpp"
 #include "hexl/util/compiler.hpp"
 #include "hexl/util/defines.hpp"
+#include "hexl/util/huge-page-allocator.hpp"
+#include "hexl/util/isa-tier.hpp"
+#include "hexl/util/kernel-variant.hpp"
+#include "hexl/util/numa-allocator.hpp"
+#include "hexl/util/pool-allocator.hpp"
+#include "hexl/util/profiling.hpp"
+#include "hexl/util/streaming-stores.hpp"
 #include "hexl/util/types.hpp"
 #include "hexl/util/util.hpp"
+#include "hexl/util/workspace.hpp"
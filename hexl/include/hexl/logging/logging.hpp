@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <vector>
 
@@ -32,6 +34,31 @@
     }                      \
   } while (0);
 
+namespace intel {
+namespace hexl {
+
+/// @brief Prints n values starting at data in a HEXL_VLOG message, without
+/// copying them
+class LogRange : public el::Loggable {
+ public:
+  LogRange(const uint64_t* data, uint64_t n) : m_data(data), m_n(n) {}
+
+  void log(el::base::type::ostream_t& os) const override {
+    os << "[";
+    for (uint64_t i = 0; i < m_n; ++i) {
+      os << (i == 0 ? "" : ", ") << m_data[i];
+    }
+    os << "]";
+  }
+
+ private:
+  const uint64_t* m_data;
+  uint64_t m_n;
+};
+
+}  // namespace hexl
+}  // namespace intel
+
 #else
 
 #define HEXL_VLOG(N, rest) \
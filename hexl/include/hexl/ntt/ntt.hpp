@@ -5,11 +5,15 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
+#include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/aligned-allocator.hpp"
 #include "hexl/util/allocator.hpp"
+#include "hexl/util/kernel-variant.hpp"
 
 namespace intel {
 namespace hexl {
@@ -36,6 +40,14 @@ class NTT {
     Adaptee alloc;
   };
 
+  /// @brief Disables the adapter constructors for pointers to AllocatorBase
+  /// implementations, e.g. std::shared_ptr<PoolAllocator>, which instead use
+  /// the std::shared_ptr<AllocatorBase> constructors
+  template <class Allocator>
+  using EnableIfNotAllocatorPtr = typename std::enable_if<
+      !std::is_convertible<Allocator, std::shared_ptr<AllocatorBase>>::value>::
+      type;
+
   /// @brief Initializes an empty NTT object
   NTT();
 
@@ -54,7 +66,8 @@ class NTT {
   NTT(uint64_t degree, uint64_t q,
       std::shared_ptr<AllocatorBase> alloc_ptr = {});
 
-  template <class Allocator, class... AllocatorArgs>
+  template <class Allocator, class = EnableIfNotAllocatorPtr<Allocator>,
+            class... AllocatorArgs>
   NTT(uint64_t degree, uint64_t q, Allocator&& a, AllocatorArgs&&... args)
       : NTT(degree, q,
             std::static_pointer_cast<AllocatorBase>(
@@ -75,7 +88,8 @@ class NTT {
   NTT(uint64_t degree, uint64_t q, uint64_t root_of_unity,
       std::shared_ptr<AllocatorBase> alloc_ptr = {});
 
-  template <class Allocator, class... AllocatorArgs>
+  template <class Allocator, class = EnableIfNotAllocatorPtr<Allocator>,
+            class... AllocatorArgs>
   NTT(uint64_t degree, uint64_t q, uint64_t root_of_unity, Allocator&& a,
       AllocatorArgs&&... args)
       : NTT(degree, q, root_of_unity,
@@ -93,6 +107,22 @@ class NTT {
   void ComputeForward(uint64_t* result, const uint64_t* operand,
                       uint64_t input_mod_factor, uint64_t output_mod_factor);
 
+  /// Compute forward NTT, multiplied element-wise by an operand in NTT form.
+  /// Results are bit-reversed.
+  /// @param[out] result Stores the result, in [0, q)
+  /// @param[in] operand Data on which to compute the NTT
+  /// @param[in] multiplicand Data in NTT form, in [0, q), to multiply the NTT
+  /// of \p operand by
+  /// @param[in] input_mod_factor Assume input \p operand are in [0,
+  /// input_mod_factor * q). Must be 1, 2 or 4.
+  /// @details Equivalent to ComputeForward with output_mod_factor 1 followed
+  /// by EltwiseMultMod, e.g. for a polynomial multiplication with an operand
+  /// kept in NTT form. The AVX512 transforms multiply each block of the NTT
+  /// output while it is still in cache, saving a pass over the data.
+  void ComputeForwardMultiply(uint64_t* result, const uint64_t* operand,
+                              const uint64_t* multiplicand,
+                              uint64_t input_mod_factor);
+
   /// Compute inverse NTT. Results are bit-reversed.
   /// @param[out] result Stores the result
   /// @param[in] operand Data on which to compute the NTT
@@ -103,6 +133,91 @@ class NTT {
   void ComputeInverse(uint64_t* result, const uint64_t* operand,
                       uint64_t input_mod_factor, uint64_t output_mod_factor);
 
+  /// Compute inverse NTT, multiplied by a scalar. Results are bit-reversed.
+  /// @param[out] result Stores the result
+  /// @param[in] operand Data on which to compute the NTT
+  /// @param[in] input_mod_factor Assume input \p operand are in [0,
+  /// input_mod_factor * q). Must be 1 or 2.
+  /// @param[in] output_mod_factor Returns output \p result in [0,
+  /// output_mod_factor * q). Must be 1 or 2.
+  /// @param[in] scalar Scalar in [0, q) to multiply the inverse NTT by
+  /// @details Equivalent to ComputeInverse followed by a multiplication by \p
+  /// scalar, e.g. by a plaintext scale or CRT factor. The scalar is merged
+  /// into the multiplication by n^{-1} of the final stage, so costs nothing
+  /// per element.
+  void ComputeInverse(uint64_t* result, const uint64_t* operand,
+                      uint64_t input_mod_factor, uint64_t output_mod_factor,
+                      uint64_t scalar);
+
+  /// @brief Returns the kernel variant used by ComputeForward on this machine
+  /// @details Allows deployments to check at startup that the modulus and
+  /// degree select the expected fast path
+  KernelVariant SelectedForwardKernel() const;
+
+  /// @brief Returns the kernel variant used by ComputeInverse on this machine
+  KernelVariant SelectedInverseKernel() const;
+
+  /// @brief Sets the software prefetch distance of the AVX512 transforms
+  /// @param[in] distance Number of 64-byte cache lines to prefetch ahead in
+  /// each of the two blocks combined by a butterfly stage. 0 disables
+  /// software prefetching
+  /// @details Applies to the strided stages of transforms larger than the
+  /// breadth-first base case, whose butterflies combine blocks far apart in
+  /// memory. The best distance depends on the microarchitecture; the
+  /// BM_FwdNTTStage and BM_InvNTTStage benchmarks report cycles per butterfly
+  /// of each stage to tune it. Defaults to s_default_prefetch_distance.
+  /// Applies to all threads.
+  static void SetPrefetchDistance(uint64_t distance);
+
+  /// @brief Returns the value set by SetPrefetchDistance
+  static uint64_t GetPrefetchDistance();
+
+  /// @brief Algorithm used by the AVX512 transforms
+  enum class Engine {
+    /// Selects FourStep for degrees whose working set is many times larger
+    /// than the L2 cache, and Recursive otherwise
+    Auto,
+    /// Depth-first recursive transforms, which complete each subtransform
+    /// before moving to the next
+    Recursive,
+    /// Bailey's four-step transforms, which view the operand as a matrix and
+    /// perform the transforms of its columns and of its rows, each in about
+    /// one pass over the data
+    FourStep
+  };
+
+  /// @brief Sets the algorithm used by the AVX512 transforms of this object
+  /// @param[in] engine Algorithm to use. Defaults to Engine::Auto
+  /// @details The four-step transforms traverse data larger than the cache a
+  /// fixed number of times, rather than once per stage not fitting in the
+  /// cache, and pay off for degrees well beyond the cache. Has no effect on
+  /// the native transforms. Applies to the NUMA replicas of this object too.
+  /// Not thread-safe: must return before the NTT object is used by other
+  /// threads.
+  void SetEngine(Engine engine);
+
+  /// @brief Returns the value set by SetEngine
+  Engine GetEngine() const { return m_engine; }
+
+  /// @brief Returns the algorithm used by ComputeForward and ComputeInverse on
+  /// this machine, resolving Engine::Auto by the degree and the L2 cache size
+  Engine SelectedEngine() const;
+
+  /// @brief Replicates the pre-computed tables on each NUMA node
+  /// @details On systems with more than one NUMA node, builds a copy of the
+  /// tables in memory local to each node, using NumaAllocator. Subsequent calls
+  /// to ComputeForward and ComputeInverse use the copy local to the calling
+  /// thread. Nodes whose memory cannot be bound, see
+  /// NumaAllocator::NumBindFailures, get no copy and use the tables of this
+  /// object. Has no effect on single-node systems. Not thread-safe: must
+  /// return before the NTT object is used by other threads, e.g. call it
+  /// right after construction.
+  void ReplicateTablesPerNumaNode();
+
+  /// @brief Returns the NTT object whose tables are local to the NUMA node of
+  /// the calling thread, or *this if the tables are not replicated
+  NTT& GetNumaLocalReplica();
+
   /// @brief Returns the minimal 2N'th root of unity
   uint64_t GetMinimalRootOfUnity() const { return m_w; }
 
@@ -187,8 +302,12 @@ class NTT {
     return m_precon64_inv_root_of_unity_powers;
   }
 
+  /// @brief Default software prefetch distance of the AVX512 transforms, in
+  /// cache lines
+  static const uint64_t s_default_prefetch_distance{8};
+
   /// @brief Maximum power of 2 in degree
-  static const size_t s_max_degree_bits{20};
+  static const size_t s_max_degree_bits{24};
 
   /// @brief Maximum number of bits in modulus;
   static const size_t s_max_modulus_bits{62};
@@ -219,6 +338,13 @@ class NTT {
  private:
   void ComputeRootOfUnityPowers();
 
+  // Computes ComputeForward, or ComputeForwardMultiply if multiplicand is not
+  // nullptr
+  void ComputeForwardInternal(uint64_t* result, const uint64_t* operand,
+                              const uint64_t* multiplicand,
+                              uint64_t input_mod_factor,
+                              uint64_t output_mod_factor);
+
   uint64_t m_degree;  // N: size of NTT transform, should be power of 2
   uint64_t m_q;       // prime modulus. Must satisfy q == 1 mod 2n
 
@@ -256,6 +382,36 @@ class NTT {
   AlignedVector64<uint64_t> m_precon64_inv_root_of_unity_powers;
 
   AlignedVector64<uint64_t> m_inv_root_of_unity_powers;
+
+  // Scratch of the four-step transforms, preallocated such that
+  // ComputeForward and ComputeInverse do not allocate
+  AlignedVector64<uint64_t> m_four_step_tile;
+
+  // Whether m_four_step_tile is held by a call. Copies of an object start with
+  // their tile free
+  struct TileFlag {
+    TileFlag() = default;
+    TileFlag(const TileFlag&) {}
+    TileFlag& operator=(const TileFlag&) { return *this; }
+    std::atomic<bool> in_use{false};
+  };
+  TileFlag m_four_step_tile_flag;
+
+  // n^{-1} and n^{-1} * W, with W the last inverse root of unity power, with
+  // their Barrett factors for 32, 52 and 64-bit shifts. Multiplicands of the
+  // final stage of the inverse NTT
+  MultiplyFactor m_inv_n_factors32[2];
+  MultiplyFactor m_inv_n_factors52[2];
+  MultiplyFactor m_inv_n_factors64[2];
+
+  // Algorithm set by SetEngine
+  Engine m_engine{Engine::Auto};
+
+  // Copies of this object with tables on each NUMA node, indexed by node, or
+  // nullptr for nodes without a copy. Empty unless ReplicateTablesPerNumaNode
+  // has replicated the tables on some node. Only written
+  // before the object is shared between threads, so read without locking
+  std::vector<std::shared_ptr<NTT>> m_numa_replicas;
 };
 
 }  // namespace hexl
@@ -15,6 +15,8 @@
 namespace intel {
 namespace hexl {
 
+class Workspace;
+
 /// @brief Pre-computes a Barrett factor with which modular multiplication can
 /// be performed more efficiently
 class MultiplyFactor {
@@ -71,10 +73,40 @@ inline uint64_t MaximumValue(uint64_t bits) {
 /// @return The bit-reversed representation of \p x using \p bit_width bits
 uint64_t ReverseBits(uint64_t x, uint64_t bit_width);
 
+/// @brief Computes the bit-reversal permutation of {0, 1, ..., n - 1}
+/// @param[out] result Stores the permutation; must have room for \p n elements
+/// @param[in] n Number of indices. Must be a power of two
+/// @details Sets \p result[i] = ReverseBits(i, log2(n)) for i = 0, ..., \p n -
+/// 1
+void BitReversePermutationIndices(uint64_t* result, uint64_t n);
+
+/// @brief Returns the bit-reversal permutation of {0, 1, ..., n - 1}
+/// @param[in] n Number of indices. Must be a power of two
+std::vector<uint64_t> BitReversePermutationIndices(uint64_t n);
+
 /// @brief Returns x^{-1} mod modulus
 /// @details Requires x % modulus != 0
 uint64_t InverseMod(uint64_t x, uint64_t modulus);
 
+/// @brief Computes result[i] = operand[i]^{-1} mod modulus for i in [0, n)
+/// @param[out] result Stores the result; may alias \p operand
+/// @param[in] operand Vector of elements to invert; each element must be
+/// non-zero, less than \p modulus and invertible mod \p modulus
+/// @param[in] n Number of elements in each vector
+/// @param[in] modulus Modulus
+/// @details Uses Montgomery's simultaneous inversion, which replaces n modular
+/// inversions by a single inversion and 3(n - 1) modular multiplications.
+/// If \p result aliases \p operand, allocates n words of scratch memory.
+void BatchInverseMod(uint64_t* result, const uint64_t* operand, uint64_t n,
+                     uint64_t modulus);
+
+/// @brief Computes result[i] = operand[i]^{-1} mod modulus for i in [0, n),
+/// taking any scratch memory from \p workspace
+/// @details Allocation-free if \p result does not alias \p operand, or if
+/// \p workspace has capacity for at least \p n words
+void BatchInverseMod(uint64_t* result, const uint64_t* operand, uint64_t n,
+                     uint64_t modulus, Workspace& workspace);
+
 /// @brief Returns (x * y) mod modulus
 /// @details Assumes x, y < modulus
 uint64_t MultiplyMod(uint64_t x, uint64_t y, uint64_t modulus);
@@ -96,8 +128,21 @@ uint64_t AddUIntMod(uint64_t x, uint64_t y, uint64_t modulus);
 uint64_t SubUIntMod(uint64_t x, uint64_t y, uint64_t modulus);
 
 /// @brief Returns base^exp mod modulus
+/// @details For odd \p modulus, uses Montgomery multiplication rather than a
+/// 128-bit division per step
 uint64_t PowMod(uint64_t base, uint64_t exp, uint64_t modulus);
 
+/// @brief Computes result[i] = base[i]^exp mod modulus for i in [0, n)
+/// @param[out] result Stores the result; may alias \p base
+/// @param[in] base Vector of bases; each element must be less than \p modulus
+/// @param[in] exp Exponent shared by all elements
+/// @param[in] n Number of elements in each vector
+/// @param[in] modulus Modulus
+/// @details Shares the Montgomery pre-computation across all elements, which
+/// is cheaper than calling PowMod on each element
+void PowModVector(uint64_t* result, const uint64_t* base, uint64_t exp,
+                  uint64_t n, uint64_t modulus);
+
 /// @brief Returns whether or not root is a degree-th root of unity mod modulus
 /// @param[in] root Root of unity to check
 /// @param[in] degree Degree of root of unity; must be a power of two
@@ -105,12 +150,16 @@ uint64_t PowMod(uint64_t base, uint64_t exp, uint64_t modulus);
 bool IsPrimitiveRoot(uint64_t root, uint64_t degree, uint64_t modulus);
 
 /// @brief Tries to return a primitive degree-th root of unity
-/// @details Returns 0 or throws an error if no root is found
+/// @param[in] degree Must be a power of two
+/// @param[in] modulus Odd prime modulus of finite field
+/// @details Returns 0 or throws an error if no root is found. The result is
+/// deterministic: it is derived from the smallest quadratic non-residue mod
+/// \p modulus
 uint64_t GeneratePrimitiveRoot(uint64_t degree, uint64_t modulus);
 
-/// @brief Returns whether or not root is a degree-th root of unity
+/// @brief Returns the smallest primitive degree-th root of unity
 /// @param[in] degree Must be a power of two
-/// @param[in] modulus Modulus of finite field
+/// @param[in] modulus Odd prime modulus of finite field
 uint64_t MinimalPrimitiveRoot(uint64_t degree, uint64_t modulus);
 
 /// @brief Computes (x * y) mod modulus, except that the output is in [0, 2 *
@@ -189,6 +238,48 @@ bool IsPrime(uint64_t n);
 std::vector<uint64_t> GeneratePrimes(size_t num_primes, size_t bit_size,
                                      size_t ntt_size = 1);
 
+/// @brief Order in which GeneratePrimes visits candidate primes
+enum class PrimeSearchDirection {
+  /// Increasing from 2^bit_size; primes are returned in increasing order
+  Upward,
+  /// Decreasing from 2^(bit_size+1); primes are returned in decreasing order
+  Downward,
+  /// Outward from a target value; primes are returned in order of increasing
+  /// distance to the target
+  Nearest
+};
+
+/// @brief Options controlling the prime search of GeneratePrimes
+struct GeneratePrimesOptions {
+  /// @brief Order in which candidates are visited
+  PrimeSearchDirection direction = PrimeSearchDirection::Upward;
+
+  /// @brief Centre of the search when \p direction is
+  /// PrimeSearchDirection::Nearest. Must lie in [2^bit_size, 2^(bit_size+1))
+  uint64_t target = 0;
+
+  /// @brief Number of threads used to run the primality tests. 0 selects the
+  /// hardware concurrency. The result does not depend on the thread count
+  size_t num_threads = 1;
+};
+
+/// @brief Generates a list of \p num_primes primes q in the range
+/// (2^bit_size, 2^(bit_size+1)) such that q % (2 * \p ntt_size) == 1
+/// @param[in] num_primes Number of primes to generate
+/// @param[in] bit_size Bit size of each prime
+/// @param[in] ntt_size N such that each prime q satisfies q % (2N) == 1. N must
+/// be a power of two
+/// @param[in] options Search direction, target and thread count
+/// @details Selects the primes of the range by options.direction:
+/// PrimeSearchDirection::Upward returns the smallest ones, in increasing
+/// order; PrimeSearchDirection::Downward returns the largest ones, in
+/// decreasing order; PrimeSearchDirection::Nearest returns those closest to
+/// options.target, in order of increasing distance to it. Candidates are
+/// pre-filtered with a sieve over small primes before the Miller-Rabin test
+std::vector<uint64_t> GeneratePrimes(size_t num_primes, size_t bit_size,
+                                     size_t ntt_size,
+                                     const GeneratePrimesOptions& options);
+
 /// @brief Returns input mod modulus, computed via 64-bit Barrett reduction
 /// @param[in] input
 /// @param[in] modulus
@@ -94,7 +94,9 @@ class AlignedAllocator {
     }
     void* store_buffer_addr = (reinterpret_cast<char*>(p) - sizeof(void*));
     void* free_address = *(static_cast<void**>(store_buffer_addr));
-    m_alloc_impl->deallocate(free_address, n);
+    // Pass the same byte count as was requested by allocate
+    size_t alloc_size = sizeof(T) * n + Alignment + sizeof(void*);
+    m_alloc_impl->deallocate(free_address, alloc_size);
   }
 
  private:
@@ -0,0 +1,12 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+/* #undef HEXL_USE_MSVC */
+#define HEXL_USE_GNU
+/* #undef HEXL_USE_CLANG */
+
+/* #undef HEXL_DEBUG */
+
+/* #undef HEXL_PROFILE */
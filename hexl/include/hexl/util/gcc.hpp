@@ -59,6 +59,9 @@ inline uint64_t MSB(uint64_t input) {
   return static_cast<uint64_t>(std::log2l(input));
 }
 
+// Returns the input with the order of its bytes reversed
+inline uint64_t ByteSwap64(uint64_t input) { return __builtin_bswap64(input); }
+
 #define HEXL_LOOP_UNROLL_4 _Pragma("GCC unroll 4")
 #define HEXL_LOOP_UNROLL_8 _Pragma("GCC unroll 8")
 
@@ -0,0 +1,62 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "hexl/util/allocator.hpp"
+
+namespace intel {
+namespace hexl {
+
+/// @brief Allocator backing large buffers with huge pages to reduce dTLB
+/// misses, e.g. for NTT tables and polynomial buffers
+/// @details On Linux, allocations of at least min_bytes are mapped with
+/// mmap(MAP_HUGETLB), rounded up to a multiple of the huge page size, if the
+/// rounding wastes at most 1/8 of the mapping. Otherwise, or if no huge pages
+/// are reserved, they are mapped with regular pages and
+/// madvise(MADV_HUGEPAGE), so transparent huge pages can back them. Smaller
+/// allocations, and all allocations on other platforms, use std::malloc.
+/// Thread-safe.
+/// Example usage:
+///   auto alloc = std::make_shared<HugePageAllocator>();
+///   NTT ntt(degree, modulus, alloc);
+///   AlignedVector64<uint64_t> x(degree, 0,
+///                               AlignedAllocator<uint64_t, 64>(alloc));
+class HugePageAllocator : public AllocatorBase {
+ public:
+  /// @brief Size of a huge page, in bytes
+  static const size_t s_huge_page_size{1ULL << 21};
+
+  /// @brief Initializes the allocator
+  /// @param[in] min_bytes Smallest allocation to map with huge pages
+  explicit HugePageAllocator(size_t min_bytes = s_huge_page_size)
+      : m_min_bytes(min_bytes) {}
+
+  /// @brief Allocates \p bytes_count bytes
+  /// @details Mapped allocations are aligned to page boundaries
+  void* allocate(size_t bytes_count) override;
+
+  /// @brief Deallocates memory
+  /// @param[in] p Pointer returned by allocate
+  /// @param[in] n Number of bytes passed to the allocate call returning \p p
+  void deallocate(void* p, size_t n) override;
+
+  /// @brief Returns the number of allocations mapped with MAP_HUGETLB
+  size_t NumHugeTLBMappings() const { return m_num_hugetlb; }
+
+  /// @brief Returns the number of allocations mapped with regular pages and
+  /// madvise(MADV_HUGEPAGE)
+  size_t NumAdvisedMappings() const { return m_num_advised; }
+
+ private:
+  size_t m_min_bytes;
+  std::atomic<size_t> m_num_hugetlb{0};
+  std::atomic<size_t> m_num_advised{0};
+};
+
+}  // namespace hexl
+}  // namespace intel
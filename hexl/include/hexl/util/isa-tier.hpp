@@ -0,0 +1,61 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+namespace intel {
+namespace hexl {
+
+/// @brief Instruction set tiers used by kernel dispatch, in increasing order
+enum class ISATier {
+  Native = 0,     ///< Portable implementations only
+  AVX2 = 1,       ///< Up to AVX2 implementations
+  AVX512DQ = 2,   ///< Up to AVX512-DQ implementations
+  AVX512IFMA = 3  ///< Up to AVX512-IFMA implementations, i.e. no restriction
+};
+
+/// @brief Returns a human-readable name of \p tier, e.g. "AVX512DQ"
+const char* ISATierName(ISATier tier);
+
+/// @brief Returns the highest tier supported by both this build and the CPU,
+/// after applying the HEXL_DISABLE_AVX512DQ and HEXL_DISABLE_AVX512IFMA
+/// environment variables
+ISATier DetectedISATier();
+
+/// @brief Restricts kernel dispatch in all threads to implementations of at
+/// most \p tier. Kernels of tiers unsupported by the CPU are never selected.
+/// @details Defaults to ISATier::AVX512IFMA, i.e. no restriction. Useful to
+/// compare implementations within one process, e.g. in benchmarks
+void SetMaxISATier(ISATier tier);
+
+/// @brief Returns the maximum tier used by kernel dispatch in the calling
+/// thread, i.e. the innermost ScopedMaxISATier if any, else the value set by
+/// SetMaxISATier
+ISATier GetMaxISATier();
+
+/// @brief Restricts kernel dispatch in the calling thread to implementations
+/// of at most the given tier, for the lifetime of this object
+/// @details Overrides SetMaxISATier in the calling thread. Objects may be
+/// nested; destruction restores the previous setting.
+/// Example usage:
+///   {
+///     ScopedMaxISATier native_only(ISATier::Native);
+///     ntt.ComputeForward(result, operand, 1, 1);  // uses the native NTT
+///   }
+class ScopedMaxISATier {
+ public:
+  /// @brief Restricts dispatch in the calling thread to at most \p tier
+  explicit ScopedMaxISATier(ISATier tier);
+
+  /// @brief Restores the previous setting of the calling thread
+  ~ScopedMaxISATier();
+
+  ScopedMaxISATier(const ScopedMaxISATier&) = delete;
+  ScopedMaxISATier& operator=(const ScopedMaxISATier&) = delete;
+
+ private:
+  int m_previous_tier;
+};
+
+}  // namespace hexl
+}  // namespace intel
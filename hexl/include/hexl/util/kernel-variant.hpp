@@ -0,0 +1,37 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+namespace intel {
+namespace hexl {
+
+/// @brief Implementation selected by a dispatching function, e.g.
+/// NTT::ComputeForward or EltwiseMultMod
+enum class KernelVariant {
+  Native,       ///< Portable implementation
+  AVX512Float,  ///< AVX512-DQ using double-precision floating-point
+  AVX512DQ32,   ///< AVX512-DQ using 32-bit pre-conditioned multiplication
+  AVX512DQ64,   ///< AVX512-DQ using 64-bit integer arithmetic
+  AVX512IFMA    ///< AVX512-IFMA using 52-bit integer multiply-add
+};
+
+/// @brief Returns a human-readable name of \p variant, e.g. "AVX512IFMA"
+inline const char* KernelVariantName(KernelVariant variant) {
+  switch (variant) {
+    case KernelVariant::Native:
+      return "Native";
+    case KernelVariant::AVX512Float:
+      return "AVX512Float";
+    case KernelVariant::AVX512DQ32:
+      return "AVX512DQ-32";
+    case KernelVariant::AVX512DQ64:
+      return "AVX512DQ-64";
+    case KernelVariant::AVX512IFMA:
+      return "AVX512IFMA";
+  }
+  return "Unknown";
+}
+
+}  // namespace hexl
+}  // namespace intel
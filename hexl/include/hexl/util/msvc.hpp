@@ -274,6 +274,9 @@ inline uint64_t MSB(uint64_t input) {
   return index;
 }
 
+// Returns the input with the order of its bytes reversed
+inline uint64_t ByteSwap64(uint64_t input) { return _byteswap_uint64(input); }
+
 #define HEXL_LOOP_UNROLL_4 \
   {}
 #define HEXL_LOOP_UNROLL_8 \
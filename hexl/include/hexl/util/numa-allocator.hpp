@@ -0,0 +1,68 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "hexl/util/allocator.hpp"
+
+namespace intel {
+namespace hexl {
+
+/// @brief Allocator placing memory on a given NUMA node
+/// @details Uses libnuma when Intel HEXL is built with HEXL_USE_LIBNUMA=ON.
+/// Otherwise, on Linux, maps pages with mmap and binds them to the node with
+/// the mbind system call. If binding fails, e.g. for a node which does not
+/// exist, the failure is counted by NumBindFailures() and the memory is placed
+/// by the default policy, typically on the node of the calling thread with
+/// libnuma, or of the thread which first writes each page with mmap, so
+/// callers needing node-local memory should check NumBindFailures(). On
+/// other platforms, falls back to std::malloc. Thread-safe.
+/// Example usage:
+///   int node = NumaAllocator::CurrentNode();
+///   auto alloc = std::make_shared<NumaAllocator>(node);
+///   AlignedVector64<uint64_t> x(degree, 0,
+///                               AlignedAllocator<uint64_t, 64>(alloc));
+class NumaAllocator : public AllocatorBase {
+ public:
+  /// @brief Node value selecting first-touch placement
+  static const int s_first_touch_node{-1};
+
+  /// @brief Initializes an allocator placing memory on node \p node
+  /// @param[in] node NUMA node in [0, NumNodes()), or s_first_touch_node
+  explicit NumaAllocator(int node = s_first_touch_node) : m_node(node) {}
+
+  /// @brief Allocates \p bytes_count bytes on the allocator's node
+  void* allocate(size_t bytes_count) override;
+
+  /// @brief Deallocates memory
+  /// @param[in] p Pointer returned by allocate
+  /// @param[in] n Number of bytes passed to the allocate call returning \p p
+  void deallocate(void* p, size_t n) override;
+
+  /// @brief Returns the node on which memory is placed
+  int Node() const { return m_node; }
+
+  /// @brief Returns the number of allocations which could not be bound to the
+  /// allocator's node
+  size_t NumBindFailures() const { return m_num_bind_failures; }
+
+  /// @brief Returns one more than the largest NUMA node ID in the system; at
+  /// least 1
+  /// @details Node IDs may be sparse, so not every ID below the returned value
+  /// is a node
+  static int NumNodes();
+
+  /// @brief Returns the NUMA node of the CPU running the calling thread
+  static int CurrentNode();
+
+ private:
+  int m_node;
+  std::atomic<size_t> m_num_bind_failures{0};
+};
+
+}  // namespace hexl
+}  // namespace intel
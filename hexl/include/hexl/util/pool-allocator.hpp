@@ -0,0 +1,109 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "hexl/util/allocator.hpp"
+
+namespace intel {
+namespace hexl {
+
+/// @brief Allocator which recycles 64-byte aligned blocks through size-class
+/// free lists, carving new blocks from large chunks
+/// @details Intended for workloads which repeatedly allocate buffers of the
+/// same sizes, e.g. one set of scratch buffers per request. Deallocated blocks
+/// are kept for reuse rather than returned to the system, and Reset() makes all
+/// memory available again without freeing it. Once a block size has been
+/// allocated, deallocating and reallocating blocks of that size do not
+/// allocate memory from the system. Not thread-safe; use
+/// ThreadLocal() to obtain one pool per thread.
+/// Example usage:
+///   auto pool = PoolAllocator::ThreadLocal();
+///   NTT ntt(degree, modulus, pool);
+///   AlignedVector64<uint64_t> x(degree, 0,
+///                               AlignedAllocator<uint64_t, 64>(pool));
+class PoolAllocator : public AllocatorBase {
+ public:
+  /// @brief Alignment of each block, in bytes
+  static const size_t s_block_alignment{64};
+
+  /// @brief Default size of each chunk from which blocks are carved, in bytes
+  static const size_t s_default_chunk_size{1ULL << 22};
+
+  /// @brief Initializes an empty pool
+  /// @param[in] chunk_size Size of each chunk requested from the system.
+  /// Larger blocks are allocated in a dedicated chunk
+  explicit PoolAllocator(size_t chunk_size = s_default_chunk_size);
+
+  /// @brief Returns all memory to the system
+  ~PoolAllocator() noexcept override;
+
+  PoolAllocator(const PoolAllocator&) = delete;
+  PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+  /// @brief Returns a 64-byte aligned block of at least \p bytes_count bytes
+  void* allocate(size_t bytes_count) override;
+
+  /// @brief Returns the block \p p to the pool for reuse
+  /// @param[in] p Block returned by allocate
+  /// @param[in] n Number of bytes passed to the allocate call returning \p p
+  /// @details Throws std::runtime_error if no block is outstanding or the pool
+  /// has never allocated a block of \p n bytes, leaving the pool unchanged
+  void deallocate(void* p, size_t n) override;
+
+  /// @brief Makes all memory in the pool available for reuse, while keeping
+  /// it reserved
+  /// @details All blocks must have been deallocated; throws
+  /// std::runtime_error otherwise, leaving the pool unchanged
+  void Reset();
+
+  /// @brief Returns all memory in the pool to the system
+  /// @details All blocks must have been deallocated; throws
+  /// std::runtime_error otherwise, leaving the pool unchanged
+  void Release();
+
+  /// @brief Returns the number of blocks allocated and not yet deallocated
+  size_t NumOutstanding() const { return m_num_outstanding; }
+
+  /// @brief Returns the number of bytes requested from the system
+  size_t BytesReserved() const;
+
+  /// @brief Returns the pool belonging to the calling thread
+  /// @details The pool lives until the thread exits and the last copy of the
+  /// returned pointer is destroyed
+  static std::shared_ptr<PoolAllocator> ThreadLocal();
+
+ private:
+  struct Chunk {
+    void* buffer;  // Pointer returned by std::malloc
+    char* begin;   // First 64-byte aligned address in buffer
+    size_t size;   // Usable bytes starting from begin
+    size_t used;   // Bytes handed out starting from begin
+  };
+
+  // Returns a new block of class_size bytes from the chunks
+  void* AllocateFromChunks(size_t class_size);
+
+  size_t m_chunk_size;
+  std::vector<Chunk> m_chunks;
+
+  // Free blocks form singly linked lists, threaded through the blocks
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  // Maps block size, a multiple of s_block_alignment, to the first free block
+  // of that size, or nullptr
+  std::unordered_map<size_t, FreeBlock*> m_free_lists;
+
+  size_t m_num_outstanding{0};
+};
+
+}  // namespace hexl
+}  // namespace intel
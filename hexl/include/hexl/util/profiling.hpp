@@ -0,0 +1,54 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace intel {
+namespace hexl {
+namespace profiling {
+
+/// @brief Counters accumulated over all calls to one kernel variant
+struct KernelStats {
+  /// @brief Entry point and selected kernel variant, e.g.
+  /// "NTT::ComputeForward/AVX512IFMA"
+  std::string name;
+  /// @brief Number of calls
+  uint64_t num_calls{0};
+  /// @brief Total number of elements processed
+  uint64_t num_elements{0};
+  /// @brief Total number of time-stamp counter cycles spent in the kernel
+  uint64_t num_cycles{0};
+  /// @brief Total wall-clock time spent in the kernel, in nanoseconds
+  uint64_t num_nanoseconds{0};
+};
+
+/// @brief Output format of Report()
+enum class ReportFormat {
+  Table,  ///< Human-readable table, one row per kernel variant
+  JSON    ///< JSON array, one object per kernel variant
+};
+
+/// @brief Returns true if Intel HEXL was built with HEXL_PROFILE=ON
+/// @details Otherwise, no counters are recorded and GetKernelStats() returns
+/// an empty vector
+bool IsEnabled();
+
+/// @brief Returns the counters of each kernel variant called at least once
+/// since startup or the last call to Reset()
+std::vector<KernelStats> GetKernelStats();
+
+/// @brief Zeroes the counters of all kernel variants
+void Reset();
+
+/// @brief Returns the counters of all called kernel variants in the given
+/// format
+std::string Report(ReportFormat format = ReportFormat::Table);
+
+}  // namespace profiling
+}  // namespace hexl
+}  // namespace intel
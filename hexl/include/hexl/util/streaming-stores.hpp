@@ -0,0 +1,27 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+namespace intel {
+namespace hexl {
+
+/// @brief Sets the minimum length, in 64-bit elements, from which
+/// out-of-place EltwiseAddMod and EltwiseMultMod write their results with
+/// non-temporal streaming stores, which bypass the cache
+/// @param[in] n Minimum result length. 0 disables streaming stores
+/// @details Streaming stores avoid evicting data which is needed soon, such as
+/// NTT twiddle factors, when writing large results which are not read again
+/// soon. They are used by the AVX512 kernels only, and only when the result
+/// is 64-byte aligned, e.g. allocated by AlignedVector64, and does not alias
+/// an operand. Defaults to 0, i.e. streaming stores are disabled. Applies to
+/// all threads.
+void SetStreamingStoreThreshold(uint64_t n);
+
+/// @brief Returns the value set by SetStreamingStoreThreshold
+uint64_t GetStreamingStoreThreshold();
+
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,61 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/allocator.hpp"
+
+namespace intel {
+namespace hexl {
+
+/// @brief Caller-owned, 64-byte aligned scratch memory for functions which
+/// need temporary storage
+/// @details Functions taking a Workspace allocate only if it is smaller than
+/// the scratch size they need; reserving enough capacity up front, or reusing
+/// the Workspace across calls, makes them allocation-free. A Workspace must
+/// not be used by two calls at the same time.
+class Workspace {
+ public:
+  /// @brief Initializes an empty workspace
+  /// @param[in] alloc_ptr Allocator for the scratch memory; defaults to malloc
+  explicit Workspace(std::shared_ptr<AllocatorBase> alloc_ptr = {})
+      : m_buffer(AlignedAllocator<uint64_t, 64>(alloc_ptr)) {}
+
+  /// @brief Initializes a workspace with room for \p num_words 64-bit words
+  /// @param[in] num_words Initial capacity, in 64-bit words
+  /// @param[in] alloc_ptr Allocator for the scratch memory; defaults to malloc
+  explicit Workspace(size_t num_words,
+                     std::shared_ptr<AllocatorBase> alloc_ptr = {})
+      : Workspace(alloc_ptr) {
+    Reserve(num_words);
+  }
+
+  /// @brief Ensures the workspace has room for \p num_words 64-bit words
+  void Reserve(size_t num_words) {
+    if (num_words > m_buffer.size()) {
+      m_buffer.resize(num_words);
+    }
+  }
+
+  /// @brief Returns scratch memory of at least \p num_words 64-bit words,
+  /// growing the workspace if needed. Previous contents are not preserved
+  uint64_t* Data(size_t num_words) {
+    Reserve(num_words);
+    return m_buffer.data();
+  }
+
+  /// @brief Returns the capacity, in 64-bit words
+  size_t Capacity() const { return m_buffer.size(); }
+
+ private:
+  AlignedVector64<uint64_t> m_buffer;
+};
+
+}  // namespace hexl
+}  // namespace intel
@@ -3,26 +3,32 @@
 
 #include "ntt/fwd-ntt-avx512.hpp"
 
+#include <algorithm>
 #include <functional>
 #include <vector>
 
+#include "hexl/eltwise/eltwise-mult-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/ntt/ntt.hpp"
 #include "hexl/number-theory/number-theory.hpp"
 #include "ntt/ntt-avx512-util.hpp"
 #include "ntt/ntt-internal.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512IFMA
 template void ForwardTransformToBitReverseAVX512<NTT::s_ifma_shift_bits>(
     uint64_t* operand, uint64_t degree, uint64_t mod,
     const uint64_t* root_of_unity_powers,
     const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth,
-    uint64_t recursion_half);
+    uint64_t recursion_half, const uint64_t* multiplicand,
+    EltwiseMultModFnPtr mult_mod_kernel);
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
@@ -31,14 +37,68 @@ template void ForwardTransformToBitReverseAVX512<32>(
     const uint64_t* root_of_unity_powers,
     const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth,
-    uint64_t recursion_half);
+    uint64_t recursion_half, const uint64_t* multiplicand,
+    EltwiseMultModFnPtr mult_mod_kernel);
 
 template void ForwardTransformToBitReverseAVX512<NTT::s_default_shift_bits>(
     uint64_t* operand, uint64_t degree, uint64_t mod,
     const uint64_t* root_of_unity_powers,
     const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth,
-    uint64_t recursion_half);
+    uint64_t recursion_half, const uint64_t* multiplicand,
+    EltwiseMultModFnPtr mult_mod_kernel);
+#endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+template void
+ForwardTransformToBitReverseFourStepAVX512<NTT::s_ifma_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* root_of_unity_powers,
+    const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const uint64_t* multiplicand, EltwiseMultModFnPtr mult_mod_kernel,
+    uint64_t* tile);
+#endif
+
+#ifdef HEXL_HAS_AVX512DQ
+template void ForwardTransformToBitReverseFourStepAVX512<32>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* root_of_unity_powers,
+    const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const uint64_t* multiplicand, EltwiseMultModFnPtr mult_mod_kernel,
+    uint64_t* tile);
+
+template void
+ForwardTransformToBitReverseFourStepAVX512<NTT::s_default_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* root_of_unity_powers,
+    const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const uint64_t* multiplicand, EltwiseMultModFnPtr mult_mod_kernel,
+    uint64_t* tile);
+#endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+template void ForwardTransformStageAVX512<NTT::s_ifma_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* root_of_unity_powers,
+    const uint64_t* precon_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance);
+#endif
+
+#ifdef HEXL_HAS_AVX512DQ
+template void ForwardTransformStageAVX512<32>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* root_of_unity_powers,
+    const uint64_t* precon_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance);
+
+template void ForwardTransformStageAVX512<NTT::s_default_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* root_of_unity_powers,
+    const uint64_t* precon_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance);
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
@@ -81,9 +141,13 @@ inline void FwdButterfly(__m512i* X, __m512i* Y, __m512i W_op, __m512i W_precon,
   *X = _mm512_add_epi64(*X, T);
 }
 
+/// @brief Performs the last stage of the forward NTT, with t = 1
+/// @details If \p output_mod_factor is 1, also reduces the outputs from
+/// [0, 4q) to [0, q), saving a separate pass over the operand
 template <int BitShift>
-void FwdT1(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
-           uint64_t m, const uint64_t* W_op, const uint64_t* W_precon) {
+void FwdT1(uint64_t* operand, __m512i v_modulus, __m512i v_neg_modulus,
+           __m512i v_twice_mod, uint64_t m, const uint64_t* W_op,
+           const uint64_t* W_precon, uint64_t output_mod_factor) {
   const __m512i* v_W_op_pt = reinterpret_cast<const __m512i*>(W_op);
   const __m512i* v_W_precon_pt = reinterpret_cast<const __m512i*>(W_precon);
   size_t j1 = 0;
@@ -102,6 +166,13 @@ void FwdT1(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
 
     FwdButterfly<BitShift, false>(&v_X, &v_Y, v_W_op, v_W_precon, v_neg_modulus,
                                   v_twice_mod);
+    if (output_mod_factor == 1) {
+      // Reduce from [0, 4q) to [0, q)
+      v_X = _mm512_hexl_small_mod_epu64(v_X, v_twice_mod);
+      v_X = _mm512_hexl_small_mod_epu64(v_X, v_modulus);
+      v_Y = _mm512_hexl_small_mod_epu64(v_Y, v_twice_mod);
+      v_Y = _mm512_hexl_small_mod_epu64(v_Y, v_modulus);
+    }
     WriteFwdInterleavedT1(v_X, v_Y, v_X_pt);
 
     j1 += 16;
@@ -171,10 +242,14 @@ void FwdT4(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
   }
 }
 
-template <int BitShift, bool InputLessThanMod>
+/// @brief Performs m blocks of butterflies whose inputs are t apart
+/// @param Prefetch If true, prefetches \p prefetch_distance cache lines ahead
+/// in both the X and Y blocks. Used for the strided stages of large transforms,
+/// whose blocks are too far apart for the hardware prefetcher to track
+template <int BitShift, bool InputLessThanMod, bool Prefetch = false>
 void FwdT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
            uint64_t t, uint64_t m, const uint64_t* W_op,
-           const uint64_t* W_precon) {
+           const uint64_t* W_precon, uint64_t prefetch_distance = 0) {
   size_t j1 = 0;
 
   HEXL_LOOP_UNROLL_4
@@ -190,6 +265,12 @@ void FwdT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
 
     // assume 8 | t
     for (size_t j = t / 8; j > 0; --j) {
+      if (Prefetch) {
+        _mm_prefetch(reinterpret_cast<const char*>(v_X_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_Y_pt + prefetch_distance),
+                     _MM_HINT_T0);
+      }
       __m512i v_X = _mm512_loadu_si512(v_X_pt);
       __m512i v_Y = _mm512_loadu_si512(v_Y_pt);
 
@@ -203,6 +284,110 @@ void FwdT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
   }
 }
 
+/// @brief Performs two consecutive stages in one pass over m blocks of 2t
+/// elements. The first stage combines inputs t apart, the second t / 2 apart
+/// @param Prefetch If true, prefetches \p prefetch_distance cache lines ahead
+/// in each quarter of the block
+/// @details Each block is split into quarters A, B, C and D, which are held in
+/// registers while the first stage combines (A, C) and (B, D) and the second
+/// stage (A, B) and (C, D). This halves the loads and stores of performing the
+/// stages separately. Requires 16 | t
+template <int BitShift, bool Prefetch = false>
+void FwdT8Radix4(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
+                 uint64_t t, uint64_t m, const uint64_t* W1_op,
+                 const uint64_t* W1_precon, const uint64_t* W2_op,
+                 const uint64_t* W2_precon, uint64_t prefetch_distance = 0) {
+  size_t quarter = t >> 1;
+
+  for (size_t i = 0; i < m; i++) {
+    uint64_t* A = operand + 2 * t * i;
+
+    __m512i v_W1_op = _mm512_set1_epi64(static_cast<int64_t>(W1_op[i]));
+    __m512i v_W1_precon =
+        _mm512_set1_epi64(static_cast<int64_t>(W1_precon[i]));
+    __m512i v_W2_op_AB = _mm512_set1_epi64(static_cast<int64_t>(W2_op[2 * i]));
+    __m512i v_W2_precon_AB =
+        _mm512_set1_epi64(static_cast<int64_t>(W2_precon[2 * i]));
+    __m512i v_W2_op_CD =
+        _mm512_set1_epi64(static_cast<int64_t>(W2_op[2 * i + 1]));
+    __m512i v_W2_precon_CD =
+        _mm512_set1_epi64(static_cast<int64_t>(W2_precon[2 * i + 1]));
+
+    __m512i* v_A_pt = reinterpret_cast<__m512i*>(A);
+    __m512i* v_B_pt = reinterpret_cast<__m512i*>(A + quarter);
+    __m512i* v_C_pt = reinterpret_cast<__m512i*>(A + 2 * quarter);
+    __m512i* v_D_pt = reinterpret_cast<__m512i*>(A + 3 * quarter);
+
+    for (size_t j = quarter / 8; j > 0; --j) {
+      if (Prefetch) {
+        _mm_prefetch(reinterpret_cast<const char*>(v_A_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_B_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_C_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_D_pt + prefetch_distance),
+                     _MM_HINT_T0);
+      }
+      __m512i v_A = _mm512_loadu_si512(v_A_pt);
+      __m512i v_B = _mm512_loadu_si512(v_B_pt);
+      __m512i v_C = _mm512_loadu_si512(v_C_pt);
+      __m512i v_D = _mm512_loadu_si512(v_D_pt);
+
+      FwdButterfly<BitShift, false>(&v_A, &v_C, v_W1_op, v_W1_precon,
+                                    v_neg_modulus, v_twice_mod);
+      FwdButterfly<BitShift, false>(&v_B, &v_D, v_W1_op, v_W1_precon,
+                                    v_neg_modulus, v_twice_mod);
+      FwdButterfly<BitShift, false>(&v_A, &v_B, v_W2_op_AB, v_W2_precon_AB,
+                                    v_neg_modulus, v_twice_mod);
+      FwdButterfly<BitShift, false>(&v_C, &v_D, v_W2_op_CD, v_W2_precon_CD,
+                                    v_neg_modulus, v_twice_mod);
+
+      _mm512_storeu_si512(v_A_pt++, v_A);
+      _mm512_storeu_si512(v_B_pt++, v_B);
+      _mm512_storeu_si512(v_C_pt++, v_C);
+      _mm512_storeu_si512(v_D_pt++, v_D);
+    }
+  }
+}
+
+/// @brief Performs one stage of the column transforms of the four-step forward
+/// NTT on 8 * num_vectors adjacent columns. Reads the rows of \p in, which
+/// are in_stride elements apart, and writes the rows of \p out, which are
+/// out_stride elements apart
+/// @details The stage combines rows t apart in m blocks of 2t rows, using the
+/// m roots of unity \p W_op. \p in and \p out may be equal
+template <int BitShift>
+void FwdColumnT8(const uint64_t* in, uint64_t in_stride, uint64_t* out,
+                 uint64_t out_stride, __m512i v_neg_modulus,
+                 __m512i v_twice_mod, uint64_t t, uint64_t m,
+                 uint64_t num_vectors, const uint64_t* W_op,
+                 const uint64_t* W_precon) {
+  for (size_t i = 0; i < m; i++) {
+    __m512i v_W_op = _mm512_set1_epi64(static_cast<int64_t>(W_op[i]));
+    __m512i v_W_precon = _mm512_set1_epi64(static_cast<int64_t>(W_precon[i]));
+
+    for (size_t r = 2 * i * t; r < (2 * i + 1) * t; ++r) {
+      const __m512i* v_X_in =
+          reinterpret_cast<const __m512i*>(in + r * in_stride);
+      const __m512i* v_Y_in =
+          reinterpret_cast<const __m512i*>(in + (r + t) * in_stride);
+      __m512i* v_X_out = reinterpret_cast<__m512i*>(out + r * out_stride);
+      __m512i* v_Y_out = reinterpret_cast<__m512i*>(out + (r + t) * out_stride);
+      for (size_t j = num_vectors; j > 0; --j) {
+        __m512i v_X = _mm512_loadu_si512(v_X_in++);
+        __m512i v_Y = _mm512_loadu_si512(v_Y_in++);
+
+        FwdButterfly<BitShift, false>(&v_X, &v_Y, v_W_op, v_W_precon,
+                                      v_neg_modulus, v_twice_mod);
+
+        _mm512_storeu_si512(v_X_out++, v_X);
+        _mm512_storeu_si512(v_Y_out++, v_Y);
+      }
+    }
+  }
+}
+
 /// @brief AVX512 implementation of the forward NTT
 /// @param[in, out] operand Input data. Overwritten with NTT output
 /// @param[in] n Size of the transfrom, i.e. the polynomial degree. Must be a
@@ -218,20 +403,30 @@ void FwdT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
 /// output_mod_factor * modulus)
 /// @param[in] recursion_depth Depth of recursive call
 /// @param[in] recursion_half Helper for indexing roots of unity
+/// @param[in] multiplicand Optional operand in NTT form, in [0, modulus), to
+/// multiply the output by element-wise. Requires output_mod_factor 1
+/// @param[in] mult_mod_kernel Kernel multiplying by \p multiplicand, as
+/// returned by GetEltwiseMultModKernel(modulus, 1, 1). Required if \p
+/// multiplicand is not nullptr
 /// @details The implementation is recursive. The base case is a breadth-first
 /// NTT, where all the butterflies in a given stage are processed before any
 /// butteflies in the next stage. The base case is small enough to fit in the
 /// smallest cache. Larger NTTs are processed recursively in a depth-first
 /// manner, such that an entire subtransform is completed before moving to the
 /// next subtransform. This reduces the number of cache misses, improving
-/// performance on larger transform sizes.
+/// performance on larger transform sizes. The IFMA kernel, whose butterflies
+/// are cheap enough for memory traffic to dominate, also merges the first two
+/// stages of each recursive subtransform into a single pass over the data.
+/// The multiplication by \p multiplicand is performed on the output of each
+/// base case while it is still in cache, saving a pass over the data.
 template <int BitShift>
 void ForwardTransformToBitReverseAVX512(
     uint64_t* operand, uint64_t n, uint64_t modulus,
     const uint64_t* root_of_unity_powers,
     const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth,
-    uint64_t recursion_half) {
+    uint64_t recursion_half, const uint64_t* multiplicand,
+    EltwiseMultModFnPtr mult_mod_kernel) {
   HEXL_CHECK(CheckNTTArguments(n, modulus), "");
   HEXL_CHECK(modulus < MaximumValue(BitShift) / 4,
              "modulus " << modulus << " too large for BitShift " << BitShift
@@ -251,6 +446,11 @@ void ForwardTransformToBitReverseAVX512(
       "input_mod_factor must be 1, 2, or 4; got " << input_mod_factor);
   HEXL_CHECK(output_mod_factor == 1 || output_mod_factor == 4,
              "output_mod_factor must be 1 or 4; got " << output_mod_factor);
+  HEXL_CHECK(multiplicand == nullptr || output_mod_factor == 1,
+             "multiplicand requires output_mod_factor 1; got "
+                 << output_mod_factor);
+  HEXL_CHECK(multiplicand == nullptr || mult_mod_kernel != nullptr,
+             "multiplicand requires mult_mod_kernel");
 
   uint64_t twice_mod = modulus << 1;
 
@@ -258,12 +458,10 @@ void ForwardTransformToBitReverseAVX512(
   __m512i v_neg_modulus = _mm512_set1_epi64(-static_cast<int64_t>(modulus));
   __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(twice_mod));
 
-  HEXL_VLOG(5, "root_of_unity_powers " << std::vector<uint64_t>(
-                   root_of_unity_powers, root_of_unity_powers + n))
-  HEXL_VLOG(5,
-            "precon_root_of_unity_powers " << std::vector<uint64_t>(
-                precon_root_of_unity_powers, precon_root_of_unity_powers + n));
-  HEXL_VLOG(5, "operand " << std::vector<uint64_t>(operand, operand + n));
+  HEXL_VLOG(5, "root_of_unity_powers " << LogRange(root_of_unity_powers, n))
+  HEXL_VLOG(5, "precon_root_of_unity_powers "
+                   << LogRange(precon_root_of_unity_powers, n));
+  HEXL_VLOG(5, "operand " << LogRange(operand, n));
 
   static const size_t base_ntt_size = 1024;
 
@@ -347,27 +545,15 @@ void ForwardTransformToBitReverseAVX512(
       new_W_idx = compute_new_W_idx(W_idx);
       W_op = &root_of_unity_powers[new_W_idx];
       W_precon = &precon_root_of_unity_powers[new_W_idx];
-      FwdT1<BitShift>(operand, v_neg_modulus, v_twice_mod, m, W_op, W_precon);
+      FwdT1<BitShift>(operand, v_modulus, v_neg_modulus, v_twice_mod, m, W_op,
+                      W_precon, output_mod_factor);
     }
+    HEXL_CHECK_BOUNDS(operand, (output_mod_factor == 1) ? n : 0, modulus,
+                      "operand exceeds bound " << modulus);
 
-    if (output_mod_factor == 1) {
-      // n power of two at least 8 => n divisible by 8
-      HEXL_CHECK(n % 8 == 0, "n " << n << " not a power of 2");
-      __m512i* v_X_pt = reinterpret_cast<__m512i*>(operand);
-      for (size_t i = 0; i < n; i += 8) {
-        __m512i v_X = _mm512_loadu_si512(v_X_pt);
-
-        // Reduce from [0, 4q) to [0, q)
-        v_X = _mm512_hexl_small_mod_epu64(v_X, v_twice_mod);
-        v_X = _mm512_hexl_small_mod_epu64(v_X, v_modulus);
-
-        HEXL_CHECK_BOUNDS(ExtractValues(v_X).data(), 8, modulus,
-                          "v_X exceeds bound " << modulus);
-
-        _mm512_storeu_si512(v_X_pt, v_X);
-
-        ++v_X_pt;
-      }
+    if (multiplicand != nullptr) {
+      // Multiply while the outputs of the base case are still in cache
+      mult_mod_kernel(operand, operand, multiplicand, n, modulus);
     }
   } else {
     // Perform depth-first NTT via recursive call
@@ -376,22 +562,193 @@ void ForwardTransformToBitReverseAVX512(
     const uint64_t* W_op = &root_of_unity_powers[W_idx];
     const uint64_t* W_precon = &precon_root_of_unity_powers[W_idx];
 
-    FwdT8<BitShift, false>(operand, v_neg_modulus, v_twice_mod, t, 1, W_op,
-                           W_precon);
+    // Multiplicand of the subtransform at the given offset, if any
+    auto sub_multiplicand = [&](size_t offset) -> const uint64_t* {
+      return (multiplicand != nullptr) ? &multiplicand[offset] : nullptr;
+    };
+
+    uint64_t prefetch_distance = NTT::GetPrefetchDistance();
+    if (BitShift == 52) {
+      // The first two stages are merged into one pass over the operand,
+      // followed by the four subtransforms of size n / 4
+      const uint64_t* W2_op = &root_of_unity_powers[W_idx << 1];
+      const uint64_t* W2_precon = &precon_root_of_unity_powers[W_idx << 1];
+      if (prefetch_distance != 0) {
+        // Roots of unity for the first stage of the subtransforms
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&root_of_unity_powers[W_idx << 2]),
+            _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(
+                         &precon_root_of_unity_powers[W_idx << 2]),
+                     _MM_HINT_T0);
+        FwdT8Radix4<BitShift, true>(operand, v_neg_modulus, v_twice_mod, t, 1,
+                                    W_op, W_precon, W2_op, W2_precon,
+                                    prefetch_distance);
+      } else {
+        FwdT8Radix4<BitShift>(operand, v_neg_modulus, v_twice_mod, t, 1, W_op,
+                              W_precon, W2_op, W2_precon);
+      }
 
-    ForwardTransformToBitReverseAVX512<BitShift>(
-        operand, n / 2, modulus, root_of_unity_powers,
-        precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
-        recursion_depth + 1, recursion_half * 2);
+      // The subtransform inputs are in [0, 4q) after the first stages
+      for (size_t i = 0; i < 4; ++i) {
+        ForwardTransformToBitReverseAVX512<BitShift>(
+            &operand[i * (n / 4)], n / 4, modulus, root_of_unity_powers,
+            precon_root_of_unity_powers, 4, output_mod_factor,
+            recursion_depth + 2, recursion_half * 4 + i,
+            sub_multiplicand(i * (n / 4)), mult_mod_kernel);
+      }
+    } else {
+      if (prefetch_distance != 0) {
+        // Roots of unity for the first stage of both subtransforms
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&root_of_unity_powers[2 * W_idx]),
+            _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(
+                         &precon_root_of_unity_powers[2 * W_idx]),
+                     _MM_HINT_T0);
+        FwdT8<BitShift, false, true>(operand, v_neg_modulus, v_twice_mod, t, 1,
+                                     W_op, W_precon, prefetch_distance);
+      } else {
+        FwdT8<BitShift, false>(operand, v_neg_modulus, v_twice_mod, t, 1, W_op,
+                               W_precon);
+      }
+
+      // The subtransform inputs are in [0, 4q) after the first stage
+      ForwardTransformToBitReverseAVX512<BitShift>(
+          operand, n / 2, modulus, root_of_unity_powers,
+          precon_root_of_unity_powers, 4, output_mod_factor,
+          recursion_depth + 1, recursion_half * 2, sub_multiplicand(0),
+          mult_mod_kernel);
+
+      ForwardTransformToBitReverseAVX512<BitShift>(
+          &operand[n / 2], n / 2, modulus, root_of_unity_powers,
+          precon_root_of_unity_powers, 4, output_mod_factor,
+          recursion_depth + 1, recursion_half * 2 + 1,
+          sub_multiplicand(n / 2), mult_mod_kernel);
+    }
+  }
+}
+
+template <int BitShift>
+void ForwardTransformToBitReverseFourStepAVX512(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* root_of_unity_powers,
+    const uint64_t* precon_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const uint64_t* multiplicand, EltwiseMultModFnPtr mult_mod_kernel,
+    uint64_t* tile) {
+  HEXL_CHECK(CheckNTTArguments(n, modulus), "");
+  HEXL_CHECK(IsPowerOfTwo(num_rows) && num_rows >= 2 && n / num_rows >= 16,
+             "num_rows must be a power of two in [2, n / 16]; got num_rows = "
+                 << num_rows);
+  HEXL_CHECK(input_mod_factor == 1 || input_mod_factor == 2 ||
+                 input_mod_factor == 4,
+             "input_mod_factor must be 1, 2, or 4; got " << input_mod_factor);
+  HEXL_CHECK_BOUNDS(operand, n, input_mod_factor * modulus,
+                    "operand larger than input_mod_factor * modulus ("
+                        << input_mod_factor << " * " << modulus << ")");
+  HEXL_CHECK(multiplicand == nullptr || output_mod_factor == 1,
+             "multiplicand requires output_mod_factor 1; got "
+                 << output_mod_factor);
+  HEXL_CHECK(multiplicand == nullptr || mult_mod_kernel != nullptr,
+             "multiplicand requires mult_mod_kernel");
+  (void)(input_mod_factor);  // Avoid unused parameter warning
+
+  __m512i v_neg_modulus = _mm512_set1_epi64(-static_cast<int64_t>(modulus));
+  __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(modulus << 1));
+
+  // View the operand as a num_rows x row_size matrix in row-major order
+  uint64_t row_size = n / num_rows;
+  uint64_t tile_width = std::min(s_four_step_tile_width, row_size);
+  uint64_t tile_vectors = tile_width / 8;
+
+  // Column transforms, i.e. the first log2(num_rows) stages, one tile of
+  // columns at a time. The first stage reads the tile from the operand and the
+  // last stage writes it back, such that the stages in between access the
+  // contiguous tile only, avoiding the cache conflicts of the strided columns
+  AlignedVector64<uint64_t> temp_tile;
+  if (tile == nullptr) {
+    temp_tile.resize(num_rows * tile_width);
+    tile = temp_tile.data();
+  }
+  for (size_t col = 0; col < row_size; col += tile_width) {
+    const uint64_t* in = &operand[col];
+    uint64_t in_stride = row_size;
+    size_t t = (num_rows >> 1);
+    for (size_t m = 1; m < num_rows; m <<= 1) {
+      bool last_stage = (t == 1);
+      uint64_t* out = last_stage ? &operand[col] : tile;
+      uint64_t out_stride = last_stage ? row_size : tile_width;
+      FwdColumnT8<BitShift>(in, in_stride, out, out_stride, v_neg_modulus,
+                            v_twice_mod, t, m, tile_vectors,
+                            &root_of_unity_powers[m],
+                            &precon_root_of_unity_powers[m]);
+      in = out;
+      in_stride = out_stride;
+      t >>= 1;
+    }
+  }
 
+  // Row transforms, i.e. the remaining stages. Their roots of unity include
+  // the twiddle factors of the four-step NTT. The row inputs are in [0, 4q)
+  // after the column transforms
+  uint64_t row_depth = Log2(num_rows);
+  for (size_t row = 0; row < num_rows; ++row) {
+    const uint64_t* row_multiplicand =
+        (multiplicand != nullptr) ? &multiplicand[row * row_size] : nullptr;
     ForwardTransformToBitReverseAVX512<BitShift>(
-        &operand[n / 2], n / 2, modulus, root_of_unity_powers,
-        precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
-        recursion_depth + 1, recursion_half * 2 + 1);
+        &operand[row * row_size], row_size, modulus, root_of_unity_powers,
+        precon_root_of_unity_powers, 4, output_mod_factor, row_depth, row,
+        row_multiplicand, mult_mod_kernel);
+  }
+}
+
+template <int BitShift>
+void ForwardTransformStageAVX512(uint64_t* operand, uint64_t n,
+                                 uint64_t modulus,
+                                 const uint64_t* root_of_unity_powers,
+                                 const uint64_t* precon_root_of_unity_powers,
+                                 uint64_t t, uint64_t num_stages,
+                                 uint64_t prefetch_distance) {
+  HEXL_CHECK(CheckNTTArguments(n, modulus), "");
+  HEXL_CHECK(num_stages == 1 || num_stages == 2,
+             "num_stages must be 1 or 2; got " << num_stages);
+  HEXL_CHECK(IsPowerOfTwo(t) && t >= (4ULL << num_stages) && t <= n / 2,
+             "t must be a power of two in [" << (4ULL << num_stages)
+                                             << ", n / 2]; got t = " << t);
+  HEXL_CHECK_BOUNDS(operand, n, 4 * modulus,
+                    "operand larger than 4 * modulus (" << modulus << ")");
+
+  __m512i v_neg_modulus = _mm512_set1_epi64(-static_cast<int64_t>(modulus));
+  __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(modulus << 1));
+
+  // The stage with butterflies t apart uses the m roots of unity from index m
+  uint64_t m = n / (2 * t);
+  const uint64_t* W_op = &root_of_unity_powers[m];
+  const uint64_t* W_precon = &precon_root_of_unity_powers[m];
+  if (num_stages == 2) {
+    const uint64_t* W2_op = &root_of_unity_powers[2 * m];
+    const uint64_t* W2_precon = &precon_root_of_unity_powers[2 * m];
+    if (prefetch_distance != 0) {
+      FwdT8Radix4<BitShift, true>(operand, v_neg_modulus, v_twice_mod, t, m,
+                                  W_op, W_precon, W2_op, W2_precon,
+                                  prefetch_distance);
+    } else {
+      FwdT8Radix4<BitShift>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                            W_precon, W2_op, W2_precon);
+    }
+  } else if (prefetch_distance != 0) {
+    FwdT8<BitShift, false, true>(operand, v_neg_modulus, v_twice_mod, t, m,
+                                 W_op, W_precon, prefetch_distance);
+  } else {
+    FwdT8<BitShift, false>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                           W_precon);
   }
 }
 
 #endif  // HEXL_HAS_AVX512DQ
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
@@ -5,6 +5,7 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <functional>
 #include <vector>
 
@@ -14,17 +15,70 @@
 #include "ntt/ntt-avx512-util.hpp"
 #include "ntt/ntt-internal.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512IFMA
 template void InverseTransformFromBitReverseAVX512<NTT::s_ifma_shift_bits>(
     uint64_t* operand, uint64_t degree, uint64_t modulus,
     const uint64_t* inv_root_of_unity_powers,
     const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth = 0,
-    uint64_t recursion_half = 0);
+    uint64_t recursion_half = 0,
+    const MultiplyFactor* inv_n_factors = nullptr);
+#endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+template void
+InverseTransformFromBitReverseFourStepAVX512<NTT::s_ifma_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const MultiplyFactor* inv_n_factors = nullptr, uint64_t* tile = nullptr);
+#endif
+
+#ifdef HEXL_HAS_AVX512DQ
+template void InverseTransformFromBitReverseFourStepAVX512<32>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const MultiplyFactor* inv_n_factors = nullptr, uint64_t* tile = nullptr);
+
+template void
+InverseTransformFromBitReverseFourStepAVX512<NTT::s_default_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const MultiplyFactor* inv_n_factors = nullptr, uint64_t* tile = nullptr);
+#endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+template void InverseTransformStageAVX512<NTT::s_ifma_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance);
+#endif
+
+#ifdef HEXL_HAS_AVX512DQ
+template void InverseTransformStageAVX512<32>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance);
+
+template void InverseTransformStageAVX512<NTT::s_default_shift_bits>(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance);
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
@@ -33,14 +87,16 @@ template void InverseTransformFromBitReverseAVX512<32>(
     const uint64_t* inv_root_of_unity_powers,
     const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth = 0,
-    uint64_t recursion_half = 0);
+    uint64_t recursion_half = 0,
+    const MultiplyFactor* inv_n_factors = nullptr);
 
 template void InverseTransformFromBitReverseAVX512<NTT::s_default_shift_bits>(
     uint64_t* operand, uint64_t degree, uint64_t modulus,
     const uint64_t* inv_root_of_unity_powers,
     const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth = 0,
-    uint64_t recursion_half = 0);
+    uint64_t recursion_half = 0,
+    const MultiplyFactor* inv_n_factors = nullptr);
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
@@ -172,10 +228,14 @@ void InvT4(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
   }
 }
 
-template <int BitShift>
+/// @brief Performs m blocks of butterflies whose inputs are t apart
+/// @param Prefetch If true, prefetches \p prefetch_distance cache lines ahead
+/// in both the X and Y blocks. Used for the strided stages of large transforms,
+/// whose blocks are too far apart for the hardware prefetcher to track
+template <int BitShift, bool Prefetch = false>
 void InvT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
            uint64_t t, uint64_t m, const uint64_t* W_op,
-           const uint64_t* W_precon) {
+           const uint64_t* W_precon, uint64_t prefetch_distance = 0) {
   size_t j1 = 0;
 
   HEXL_LOOP_UNROLL_4
@@ -191,6 +251,12 @@ void InvT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
 
     // assume 8 | t
     for (size_t j = t / 8; j > 0; --j) {
+      if (Prefetch) {
+        _mm_prefetch(reinterpret_cast<const char*>(v_X_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_Y_pt + prefetch_distance),
+                     _MM_HINT_T0);
+      }
       __m512i v_X = _mm512_loadu_si512(v_X_pt);
       __m512i v_Y = _mm512_loadu_si512(v_Y_pt);
 
@@ -204,6 +270,184 @@ void InvT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
   }
 }
 
+/// @brief Performs two consecutive stages in one pass over m / 2 blocks of 4t
+/// elements. The first stage combines inputs t apart, the second 2t apart
+/// @param Prefetch If true, prefetches \p prefetch_distance cache lines ahead
+/// in each quarter of the block
+/// @details Each block is split into quarters A, B, C and D, which are held in
+/// registers while the first stage combines (A, B) and (C, D) and the second
+/// stage (A, C) and (B, D). This halves the loads and stores of performing the
+/// stages separately. Requires 8 | t and 2 | m
+template <int BitShift, bool Prefetch = false>
+void InvT8Radix4(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
+                 uint64_t t, uint64_t m, const uint64_t* W1_op,
+                 const uint64_t* W1_precon, const uint64_t* W2_op,
+                 const uint64_t* W2_precon, uint64_t prefetch_distance = 0) {
+  for (size_t i = 0; i < m / 2; i++) {
+    uint64_t* A = operand + 4 * t * i;
+
+    __m512i v_W1_op_AB = _mm512_set1_epi64(static_cast<int64_t>(W1_op[2 * i]));
+    __m512i v_W1_precon_AB =
+        _mm512_set1_epi64(static_cast<int64_t>(W1_precon[2 * i]));
+    __m512i v_W1_op_CD =
+        _mm512_set1_epi64(static_cast<int64_t>(W1_op[2 * i + 1]));
+    __m512i v_W1_precon_CD =
+        _mm512_set1_epi64(static_cast<int64_t>(W1_precon[2 * i + 1]));
+    __m512i v_W2_op = _mm512_set1_epi64(static_cast<int64_t>(W2_op[i]));
+    __m512i v_W2_precon =
+        _mm512_set1_epi64(static_cast<int64_t>(W2_precon[i]));
+
+    __m512i* v_A_pt = reinterpret_cast<__m512i*>(A);
+    __m512i* v_B_pt = reinterpret_cast<__m512i*>(A + t);
+    __m512i* v_C_pt = reinterpret_cast<__m512i*>(A + 2 * t);
+    __m512i* v_D_pt = reinterpret_cast<__m512i*>(A + 3 * t);
+
+    for (size_t j = t / 8; j > 0; --j) {
+      if (Prefetch) {
+        _mm_prefetch(reinterpret_cast<const char*>(v_A_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_B_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_C_pt + prefetch_distance),
+                     _MM_HINT_T0);
+        _mm_prefetch(reinterpret_cast<const char*>(v_D_pt + prefetch_distance),
+                     _MM_HINT_T0);
+      }
+      __m512i v_A = _mm512_loadu_si512(v_A_pt);
+      __m512i v_B = _mm512_loadu_si512(v_B_pt);
+      __m512i v_C = _mm512_loadu_si512(v_C_pt);
+      __m512i v_D = _mm512_loadu_si512(v_D_pt);
+
+      InvButterfly<BitShift, false>(&v_A, &v_B, v_W1_op_AB, v_W1_precon_AB,
+                                    v_neg_modulus, v_twice_mod);
+      InvButterfly<BitShift, false>(&v_C, &v_D, v_W1_op_CD, v_W1_precon_CD,
+                                    v_neg_modulus, v_twice_mod);
+      InvButterfly<BitShift, false>(&v_A, &v_C, v_W2_op, v_W2_precon,
+                                    v_neg_modulus, v_twice_mod);
+      InvButterfly<BitShift, false>(&v_B, &v_D, v_W2_op, v_W2_precon,
+                                    v_neg_modulus, v_twice_mod);
+
+      _mm512_storeu_si512(v_A_pt++, v_A);
+      _mm512_storeu_si512(v_B_pt++, v_B);
+      _mm512_storeu_si512(v_C_pt++, v_C);
+      _mm512_storeu_si512(v_D_pt++, v_D);
+    }
+  }
+}
+
+/// @brief Performs the final stage of the inverse NTT on num_vectors
+/// 8-element vectors of \p X_in and \p Y_in, merged with the multiplication by
+/// n^{-1} and the output modulus reduction, writing the results to \p X_out and
+/// \p Y_out
+/// @details Computes X' = n^{-1} (X + Y) and Y' = n^{-1} W (X - Y), with
+/// v_inv_n_w = n^{-1} W. The outputs may equal the inputs
+template <int BitShift>
+void InvFinalT8(const uint64_t* X_in, const uint64_t* Y_in, uint64_t* X_out,
+                uint64_t* Y_out, uint64_t num_vectors, __m512i v_modulus,
+                __m512i v_neg_modulus, __m512i v_twice_mod, __m512i v_inv_n,
+                __m512i v_inv_n_prime, __m512i v_inv_n_w,
+                __m512i v_inv_n_w_prime, uint64_t output_mod_factor,
+                uint64_t prefetch_distance = 0) {
+  const __m512i* v_X_pt = reinterpret_cast<const __m512i*>(X_in);
+  const __m512i* v_Y_pt = reinterpret_cast<const __m512i*>(Y_in);
+  __m512i* v_X_out = reinterpret_cast<__m512i*>(X_out);
+  __m512i* v_Y_out = reinterpret_cast<__m512i*>(Y_out);
+
+  HEXL_LOOP_UNROLL_4
+  for (size_t j = num_vectors; j > 0; --j) {
+    if (prefetch_distance != 0) {
+      _mm_prefetch(reinterpret_cast<const char*>(v_X_pt + prefetch_distance),
+                   _MM_HINT_T0);
+      _mm_prefetch(reinterpret_cast<const char*>(v_Y_pt + prefetch_distance),
+                   _MM_HINT_T0);
+    }
+    __m512i v_X = _mm512_loadu_si512(v_X_pt++);
+    __m512i v_Y = _mm512_loadu_si512(v_Y_pt++);
+
+    // Slightly different from regular InvButterfly because different W is
+    // used for X and Y
+    __m512i Y_minus_2q = _mm512_sub_epi64(v_Y, v_twice_mod);
+    __m512i X_plus_Y_mod2q =
+        _mm512_hexl_small_add_mod_epi64(v_X, v_Y, v_twice_mod);
+    // T = *X + twice_mod - *Y
+    __m512i T = _mm512_sub_epi64(v_X, Y_minus_2q);
+
+    if (BitShift == 32) {
+      __m512i Q1 = _mm512_hexl_mullo_epi<64>(v_inv_n_prime, X_plus_Y_mod2q);
+      Q1 = _mm512_srli_epi64(Q1, 32);
+      // X = inv_N * X_plus_Y_mod2q - Q1 * modulus;
+      __m512i inv_N_tx = _mm512_hexl_mullo_epi<64>(v_inv_n, X_plus_Y_mod2q);
+      v_X = _mm512_hexl_mullo_add_lo_epi<64>(inv_N_tx, Q1, v_neg_modulus);
+
+      __m512i Q2 = _mm512_hexl_mullo_epi<64>(v_inv_n_w_prime, T);
+      Q2 = _mm512_srli_epi64(Q2, 32);
+
+      // Y = inv_N_W * T - Q2 * modulus;
+      __m512i inv_N_W_T = _mm512_hexl_mullo_epi<64>(v_inv_n_w, T);
+      v_Y = _mm512_hexl_mullo_add_lo_epi<64>(inv_N_W_T, Q2, v_neg_modulus);
+    } else {
+      __m512i Q1 =
+          _mm512_hexl_mulhi_epi<BitShift>(v_inv_n_prime, X_plus_Y_mod2q);
+      // X = inv_N * X_plus_Y_mod2q - Q1 * modulus;
+      __m512i inv_N_tx =
+          _mm512_hexl_mullo_epi<BitShift>(v_inv_n, X_plus_Y_mod2q);
+      v_X = _mm512_hexl_mullo_add_lo_epi<BitShift>(inv_N_tx, Q1, v_neg_modulus);
+
+      __m512i Q2 = _mm512_hexl_mulhi_epi<BitShift>(v_inv_n_w_prime, T);
+      // Y = inv_N_W * T - Q2 * modulus;
+      __m512i inv_N_W_T = _mm512_hexl_mullo_epi<BitShift>(v_inv_n_w, T);
+      v_Y =
+          _mm512_hexl_mullo_add_lo_epi<BitShift>(inv_N_W_T, Q2, v_neg_modulus);
+    }
+
+    if (output_mod_factor == 1) {
+      // Modulus reduction from [0, 2q), to [0, q)
+      v_X = _mm512_hexl_small_mod_epu64(v_X, v_modulus);
+      v_Y = _mm512_hexl_small_mod_epu64(v_Y, v_modulus);
+    }
+
+    _mm512_storeu_si512(v_X_out++, v_X);
+    _mm512_storeu_si512(v_Y_out++, v_Y);
+  }
+}
+
+/// @brief Performs one stage of the column transforms of the four-step inverse
+/// NTT on 8 * num_vectors adjacent columns. Reads the rows of \p in, which
+/// are in_stride elements apart, and writes the rows of \p out, which are
+/// out_stride elements apart
+/// @details The stage combines rows t apart in m blocks of 2t rows, using the
+/// m inverse roots of unity \p W_op. \p in and \p out may be equal
+template <int BitShift>
+void InvColumnT8(const uint64_t* in, uint64_t in_stride, uint64_t* out,
+                 uint64_t out_stride, __m512i v_neg_modulus,
+                 __m512i v_twice_mod, uint64_t t, uint64_t m,
+                 uint64_t num_vectors, const uint64_t* W_op,
+                 const uint64_t* W_precon) {
+  for (size_t i = 0; i < m; i++) {
+    __m512i v_W_op = _mm512_set1_epi64(static_cast<int64_t>(W_op[i]));
+    __m512i v_W_precon = _mm512_set1_epi64(static_cast<int64_t>(W_precon[i]));
+
+    for (size_t r = 2 * i * t; r < (2 * i + 1) * t; ++r) {
+      const __m512i* v_X_in =
+          reinterpret_cast<const __m512i*>(in + r * in_stride);
+      const __m512i* v_Y_in =
+          reinterpret_cast<const __m512i*>(in + (r + t) * in_stride);
+      __m512i* v_X_out = reinterpret_cast<__m512i*>(out + r * out_stride);
+      __m512i* v_Y_out = reinterpret_cast<__m512i*>(out + (r + t) * out_stride);
+      for (size_t j = num_vectors; j > 0; --j) {
+        __m512i v_X = _mm512_loadu_si512(v_X_in++);
+        __m512i v_Y = _mm512_loadu_si512(v_Y_in++);
+
+        InvButterfly<BitShift, false>(&v_X, &v_Y, v_W_op, v_W_precon,
+                                      v_neg_modulus, v_twice_mod);
+
+        _mm512_storeu_si512(v_X_out++, v_X);
+        _mm512_storeu_si512(v_Y_out++, v_Y);
+      }
+    }
+  }
+}
+
 /// @brief AVX512 implementation of the inverse NTT
 /// @param[in, out] operand Input data. Overwritten with NTT output
 /// @param[in] n Size of the transfrom, i.e. the polynomial degree. Must be a
@@ -225,14 +469,16 @@ void InvT8(uint64_t* operand, __m512i v_neg_modulus, __m512i v_twice_mod,
 /// smallest cache. Larger NTTs are processed recursively in a depth-first
 /// manner, such that an entire subtransform is completed before moving to the
 /// next subtransform. This reduces the number of cache misses, improving
-/// performance on larger transform sizes.
+/// performance on larger transform sizes. The IFMA kernel, whose butterflies
+/// are cheap enough for memory traffic to dominate, also merges the last two
+/// stages of each recursive subtransform into a single pass over the data.
 template <int BitShift>
 void InverseTransformFromBitReverseAVX512(
     uint64_t* operand, uint64_t n, uint64_t modulus,
     const uint64_t* inv_root_of_unity_powers,
     const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth,
-    uint64_t recursion_half) {
+    uint64_t recursion_half, const MultiplyFactor* inv_n_factors) {
   HEXL_CHECK(CheckNTTArguments(n, modulus), "");
   HEXL_CHECK(n >= 16,
              "InverseTransformFromBitReverseAVX512 doesn't support small "
@@ -265,6 +511,10 @@ void InverseTransformFromBitReverseAVX512(
 
   static const size_t base_ntt_size = 1024;
 
+  // Only the stages of transforms larger than the base case are strided
+  uint64_t prefetch_distance =
+      (n > base_ntt_size) ? NTT::GetPrefetchDistance() : 0;
+
   if (n <= base_ntt_size) {  // Perform breadth-first InvNTT
     // Extract t=1, t=2, t=4 loops separately
     {
@@ -316,6 +566,43 @@ void InverseTransformFromBitReverseAVX512(
         W_idx += W_idx_delta;
       }
     }
+  } else if (BitShift == 52) {
+    // Perform depth-first InvNTT via recursive calls on the four quarters,
+    // which leave their final stage to this call. The final stages of the
+    // quarters and halves are then merged into one pass over the operand
+    for (size_t i = 0; i < 4; ++i) {
+      InverseTransformFromBitReverseAVX512<BitShift>(
+          &operand[i * (n / 4)], n / 4, modulus, inv_root_of_unity_powers,
+          precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor,
+          recursion_depth + 2, 4 * recursion_half + i);
+    }
+
+    uint64_t W_idx_delta =
+        m * ((1ULL << (recursion_depth + 1)) - recursion_half);
+    for (; m > 4; m >>= 1) {
+      t <<= 1;
+      W_idx_delta >>= 1;
+      W_idx += W_idx_delta;
+    }
+
+    const uint64_t* W_op = &inv_root_of_unity_powers[W_idx];
+    const uint64_t* W_precon = &precon_inv_root_of_unity_powers[W_idx];
+    W_idx_delta >>= 1;
+    W_idx += W_idx_delta;
+    const uint64_t* W2_op = &inv_root_of_unity_powers[W_idx];
+    const uint64_t* W2_precon = &precon_inv_root_of_unity_powers[W_idx];
+    if (prefetch_distance != 0) {
+      InvT8Radix4<BitShift, true>(operand, v_neg_modulus, v_twice_mod, t, m,
+                                  W_op, W_precon, W2_op, W2_precon,
+                                  prefetch_distance);
+    } else {
+      InvT8Radix4<BitShift>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                            W_precon, W2_op, W2_precon);
+    }
+    t <<= 2;
+    m >>= 2;
+    W_idx_delta >>= 1;
+    W_idx += W_idx_delta;
   } else {
     InverseTransformFromBitReverseAVX512<BitShift>(
         operand, n / 2, modulus, inv_root_of_unity_powers,
@@ -336,8 +623,13 @@ void InverseTransformFromBitReverseAVX512(
     if (m == 2) {
       const uint64_t* W_op = &inv_root_of_unity_powers[W_idx];
       const uint64_t* W_precon = &precon_inv_root_of_unity_powers[W_idx];
-      InvT8<BitShift>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
-                      W_precon);
+      if (prefetch_distance != 0) {
+        InvT8<BitShift, true>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                              W_precon, prefetch_distance);
+      } else {
+        InvT8<BitShift>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                        W_precon);
+      }
       t <<= 1;
       m >>= 1;
       W_idx_delta >>= 1;
@@ -347,18 +639,18 @@ void InverseTransformFromBitReverseAVX512(
 
   // Final loop through data
   if (recursion_depth == 0) {
-    HEXL_VLOG(4, "AVX512 intermediate operand "
-                     << std::vector<uint64_t>(operand, operand + n));
-
-    const uint64_t W_op = inv_root_of_unity_powers[W_idx];
-    MultiplyFactor mf_inv_n(InverseMod(n, modulus), BitShift, modulus);
-    const uint64_t inv_n = mf_inv_n.Operand();
-    const uint64_t inv_n_prime = mf_inv_n.BarrettFactor();
+    HEXL_VLOG(4, "AVX512 intermediate operand " << LogRange(operand, n));
 
-    MultiplyFactor mf_inv_n_w(MultiplyMod(inv_n, W_op, modulus), BitShift,
-                              modulus);
-    const uint64_t inv_n_w = mf_inv_n_w.Operand();
-    const uint64_t inv_n_w_prime = mf_inv_n_w.BarrettFactor();
+    MultiplyFactor default_inv_n_factors[2];
+    if (inv_n_factors == nullptr) {
+      ComputeInvNFactors(n, modulus, inv_root_of_unity_powers[W_idx], 1,
+                         BitShift, default_inv_n_factors);
+      inv_n_factors = default_inv_n_factors;
+    }
+    const uint64_t inv_n = inv_n_factors[0].Operand();
+    const uint64_t inv_n_prime = inv_n_factors[0].BarrettFactor();
+    const uint64_t inv_n_w = inv_n_factors[1].Operand();
+    const uint64_t inv_n_w_prime = inv_n_factors[1].BarrettFactor();
 
     HEXL_VLOG(4, "inv_n_w " << inv_n_w);
 
@@ -372,68 +664,158 @@ void InverseTransformFromBitReverseAVX512(
     __m512i v_inv_n_w_prime =
         _mm512_set1_epi64(static_cast<int64_t>(inv_n_w_prime));
 
-    __m512i* v_X_pt = reinterpret_cast<__m512i*>(X);
-    __m512i* v_Y_pt = reinterpret_cast<__m512i*>(Y);
-
     // Merge final InvNTT loop with modulus reduction baked-in
-    HEXL_LOOP_UNROLL_4
-    for (size_t j = n / 16; j > 0; --j) {
-      __m512i v_X = _mm512_loadu_si512(v_X_pt);
-      __m512i v_Y = _mm512_loadu_si512(v_Y_pt);
+    InvFinalT8<BitShift>(X, Y, X, Y, n / 16, v_modulus, v_neg_modulus,
+                         v_twice_mod, v_inv_n, v_inv_n_prime, v_inv_n_w,
+                         v_inv_n_w_prime, output_mod_factor, prefetch_distance);
 
-      // Slightly different from regular InvButterfly because different W is
-      // used for X and Y
-      __m512i Y_minus_2q = _mm512_sub_epi64(v_Y, v_twice_mod);
-      __m512i X_plus_Y_mod2q =
-          _mm512_hexl_small_add_mod_epi64(v_X, v_Y, v_twice_mod);
-      // T = *X + twice_mod - *Y
-      __m512i T = _mm512_sub_epi64(v_X, Y_minus_2q);
-
-      if (BitShift == 32) {
-        __m512i Q1 = _mm512_hexl_mullo_epi<64>(v_inv_n_prime, X_plus_Y_mod2q);
-        Q1 = _mm512_srli_epi64(Q1, 32);
-        // X = inv_N * X_plus_Y_mod2q - Q1 * modulus;
-        __m512i inv_N_tx = _mm512_hexl_mullo_epi<64>(v_inv_n, X_plus_Y_mod2q);
-        v_X = _mm512_hexl_mullo_add_lo_epi<64>(inv_N_tx, Q1, v_neg_modulus);
-
-        __m512i Q2 = _mm512_hexl_mullo_epi<64>(v_inv_n_w_prime, T);
-        Q2 = _mm512_srli_epi64(Q2, 32);
-
-        // Y = inv_N_W * T - Q2 * modulus;
-        __m512i inv_N_W_T = _mm512_hexl_mullo_epi<64>(v_inv_n_w, T);
-        v_Y = _mm512_hexl_mullo_add_lo_epi<64>(inv_N_W_T, Q2, v_neg_modulus);
-      } else {
-        __m512i Q1 =
-            _mm512_hexl_mulhi_epi<BitShift>(v_inv_n_prime, X_plus_Y_mod2q);
-        // X = inv_N * X_plus_Y_mod2q - Q1 * modulus;
-        __m512i inv_N_tx =
-            _mm512_hexl_mullo_epi<BitShift>(v_inv_n, X_plus_Y_mod2q);
-        v_X =
-            _mm512_hexl_mullo_add_lo_epi<BitShift>(inv_N_tx, Q1, v_neg_modulus);
-
-        __m512i Q2 = _mm512_hexl_mulhi_epi<BitShift>(v_inv_n_w_prime, T);
-        // Y = inv_N_W * T - Q2 * modulus;
-        __m512i inv_N_W_T = _mm512_hexl_mullo_epi<BitShift>(v_inv_n_w, T);
-        v_Y = _mm512_hexl_mullo_add_lo_epi<BitShift>(inv_N_W_T, Q2,
-                                                     v_neg_modulus);
-      }
+    HEXL_VLOG(5, "AVX512 returning operand " << LogRange(operand, n));
+  }
+}
 
-      if (output_mod_factor == 1) {
-        // Modulus reduction from [0, 2q), to [0, q)
-        v_X = _mm512_hexl_small_mod_epu64(v_X, v_modulus);
-        v_Y = _mm512_hexl_small_mod_epu64(v_Y, v_modulus);
-      }
+template <int BitShift>
+void InverseTransformFromBitReverseFourStepAVX512(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const MultiplyFactor* inv_n_factors, uint64_t* tile) {
+  HEXL_CHECK(CheckNTTArguments(n, modulus), "");
+  HEXL_CHECK(IsPowerOfTwo(num_rows) && num_rows >= 2 && n / num_rows >= 16,
+             "num_rows must be a power of two in [2, n / 16]; got num_rows = "
+                 << num_rows);
+  HEXL_CHECK_BOUNDS(operand, n, input_mod_factor * modulus,
+                    "operand larger than input_mod_factor * modulus ("
+                        << input_mod_factor << " * " << modulus << ")");
+  HEXL_CHECK(output_mod_factor == 1 || output_mod_factor == 2,
+             "output_mod_factor must be 1 or 2; got " << output_mod_factor);
 
-      _mm512_storeu_si512(v_X_pt++, v_X);
-      _mm512_storeu_si512(v_Y_pt++, v_Y);
+  uint64_t twice_mod = modulus << 1;
+  __m512i v_modulus = _mm512_set1_epi64(static_cast<int64_t>(modulus));
+  __m512i v_neg_modulus = _mm512_set1_epi64(-static_cast<int64_t>(modulus));
+  __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(twice_mod));
+
+  // View the operand as a num_rows x row_size matrix in row-major order
+  uint64_t row_size = n / num_rows;
+  uint64_t row_depth = Log2(num_rows);
+  uint64_t tile_width = std::min(s_four_step_tile_width, row_size);
+  uint64_t tile_vectors = tile_width / 8;
+
+  // Row transforms, i.e. the first stages. Each leaves its final stage, which
+  // combines the two halves of the row, to this call. The stage with num_rows
+  // blocks uses the num_rows roots of unity from index n - 2 * num_rows + 1
+  const uint64_t* W_op = &inv_root_of_unity_powers[n - 2 * num_rows + 1];
+  const uint64_t* W_precon =
+      &precon_inv_root_of_unity_powers[n - 2 * num_rows + 1];
+  for (size_t row = 0; row < num_rows; ++row) {
+    uint64_t* row_operand = &operand[row * row_size];
+    InverseTransformFromBitReverseAVX512<BitShift>(
+        row_operand, row_size, modulus, inv_root_of_unity_powers,
+        precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor,
+        row_depth, row);
+    InvT8<BitShift>(row_operand, v_neg_modulus, v_twice_mod, row_size / 2, 1,
+                    W_op++, W_precon++);
+  }
+
+  // The final stage multiplies by n^{-1}, as in
+  // InverseTransformFromBitReverseAVX512
+  MultiplyFactor default_inv_n_factors[2];
+  if (inv_n_factors == nullptr) {
+    ComputeInvNFactors(n, modulus, inv_root_of_unity_powers[n - 1], 1,
+                       BitShift, default_inv_n_factors);
+    inv_n_factors = default_inv_n_factors;
+  }
+  __m512i v_inv_n =
+      _mm512_set1_epi64(static_cast<int64_t>(inv_n_factors[0].Operand()));
+  __m512i v_inv_n_prime =
+      _mm512_set1_epi64(static_cast<int64_t>(inv_n_factors[0].BarrettFactor()));
+  __m512i v_inv_n_w =
+      _mm512_set1_epi64(static_cast<int64_t>(inv_n_factors[1].Operand()));
+  __m512i v_inv_n_w_prime =
+      _mm512_set1_epi64(static_cast<int64_t>(inv_n_factors[1].BarrettFactor()));
+
+  // Column transforms, i.e. the last log2(num_rows) stages, one tile of
+  // columns at a time. The first stage reads the tile from the operand and the
+  // final stage writes it back, such that the stages in between access the
+  // contiguous tile only, avoiding the cache conflicts of the strided columns
+  AlignedVector64<uint64_t> temp_tile;
+  if (tile == nullptr) {
+    temp_tile.resize(num_rows * tile_width);
+    tile = temp_tile.data();
+  }
+  uint64_t half_rows = num_rows >> 1;
+  for (size_t col = 0; col < row_size; col += tile_width) {
+    const uint64_t* in = &operand[col];
+    uint64_t in_stride = row_size;
+    size_t t = 1;
+    for (size_t m = half_rows; m > 1; m >>= 1) {
+      size_t W_idx = n - 2 * m + 1;
+      InvColumnT8<BitShift>(in, in_stride, tile, tile_width,
+                            v_neg_modulus, v_twice_mod, t, m, tile_vectors,
+                            &inv_root_of_unity_powers[W_idx],
+                            &precon_inv_root_of_unity_powers[W_idx]);
+      in = tile;
+      in_stride = tile_width;
+      t <<= 1;
+    }
+    for (size_t row = 0; row < half_rows; ++row) {
+      InvFinalT8<BitShift>(
+          &in[row * in_stride], &in[(row + half_rows) * in_stride],
+          &operand[row * row_size + col],
+          &operand[(row + half_rows) * row_size + col], tile_vectors,
+          v_modulus, v_neg_modulus, v_twice_mod, v_inv_n, v_inv_n_prime,
+          v_inv_n_w, v_inv_n_w_prime, output_mod_factor);
     }
+  }
+}
 
-    HEXL_VLOG(5, "AVX512 returning operand "
-                     << std::vector<uint64_t>(operand, operand + n));
+template <int BitShift>
+void InverseTransformStageAVX512(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance) {
+  HEXL_CHECK(CheckNTTArguments(n, modulus), "");
+  HEXL_CHECK(num_stages == 1 || num_stages == 2,
+             "num_stages must be 1 or 2; got " << num_stages);
+  HEXL_CHECK(IsPowerOfTwo(t) && t >= 8 && t <= (n >> (num_stages + 1)),
+             "t must be a power of two in [8, " << (n >> (num_stages + 1))
+                                                << "]; got t = " << t);
+  HEXL_CHECK_BOUNDS(operand, n, 2 * modulus,
+                    "operand larger than 2 * modulus (" << modulus << ")");
+
+  __m512i v_neg_modulus = _mm512_set1_epi64(-static_cast<int64_t>(modulus));
+  __m512i v_twice_mod = _mm512_set1_epi64(static_cast<int64_t>(modulus << 1));
+
+  // The stages with butterflies 1, 2, ..., t / 2 apart use the first
+  // n / 2 + n / 4 + ... + 2m roots of unity after index 1
+  uint64_t m = n / (2 * t);
+  uint64_t W_idx = n - 2 * m + 1;
+  const uint64_t* W_op = &inv_root_of_unity_powers[W_idx];
+  const uint64_t* W_precon = &precon_inv_root_of_unity_powers[W_idx];
+  if (num_stages == 2) {
+    const uint64_t* W2_op = &inv_root_of_unity_powers[W_idx + m];
+    const uint64_t* W2_precon = &precon_inv_root_of_unity_powers[W_idx + m];
+    if (prefetch_distance != 0) {
+      InvT8Radix4<BitShift, true>(operand, v_neg_modulus, v_twice_mod, t, m,
+                                  W_op, W_precon, W2_op, W2_precon,
+                                  prefetch_distance);
+    } else {
+      InvT8Radix4<BitShift>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                            W_precon, W2_op, W2_precon);
+    }
+  } else if (prefetch_distance != 0) {
+    InvT8<BitShift, true>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                          W_precon, prefetch_distance);
+  } else {
+    InvT8<BitShift>(operand, v_neg_modulus, v_twice_mod, t, m, W_op,
+                    W_precon);
   }
 }
 
 #endif  // HEXL_HAS_AVX512DQ
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
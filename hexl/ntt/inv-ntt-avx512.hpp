@@ -4,10 +4,13 @@
 #pragma once
 
 #include "ntt/ntt-internal.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 
 /// @brief AVX512 implementation of the inverse NTT
@@ -25,22 +28,91 @@ namespace hexl {
 /// output_mod_factor * modulus)
 /// @param[in] recursion_depth Depth of recursive call
 /// @param[in] recursion_half Helper for indexing roots of unity
+/// @param[in] inv_n_factors Optional constants of the final stage, as computed
+/// by ComputeInvNFactors for \p BitShift. If nullptr, computed with scalar 1
 /// @details The implementation is recursive. The base case is a breadth-first
 /// NTT, where all the butterflies in a given stage are processed before any
 /// butteflies in the next stage. The base case is small enough to fit in the
 /// smallest cache. Larger NTTs are processed recursively in a depth-first
 /// manner, such that an entire subtransform is completed before moving to the
 /// next subtransform. This reduces the number of cache misses, improving
-/// performance on larger transform sizes.
+/// performance on larger transform sizes. The IFMA kernel, whose butterflies
+/// are cheap enough for memory traffic to dominate, also merges the last two
+/// stages of each recursive subtransform into a single pass over the data.
+/// Passing \p inv_n_factors precomputed, e.g. by the NTT object, avoids
+/// their setup cost on small transforms, and allows the output to be multiplied
+/// by a scalar at no extra cost per element.
 template <int BitShift>
 void InverseTransformFromBitReverseAVX512(
     uint64_t* operand, uint64_t n, uint64_t modulus,
     const uint64_t* inv_root_of_unity_powers,
     const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
     uint64_t output_mod_factor, uint64_t recursion_depth = 0,
-    uint64_t recursion_half = 0);
+    uint64_t recursion_half = 0,
+    const MultiplyFactor* inv_n_factors = nullptr);
+
+/// @brief Four-step AVX512 implementation of the inverse NTT
+/// @param[in, out] operand Input data. Overwritten with NTT output
+/// @param[in] n Size of the transform, i.e. the polynomial degree. Must be a
+/// power of two, at least 2048.
+/// @param[in] modulus Prime modulus. Must satisfy q == 1 mod 2n
+/// @param[in] inv_root_of_unity_powers Powers of inverse 2n'th root of unity
+/// in F_q, as used by InverseTransformFromBitReverseAVX512
+/// @param[in] precon_inv_root_of_unity_powers Pre-conditioned \p
+/// inv_root_of_unity_powers
+/// @param[in] input_mod_factor Upper bound for inputs; inputs must be in [0,
+/// input_mod_factor * modulus)
+/// @param[in] output_mod_factor Upper bound for result; result must be in [0,
+/// output_mod_factor * modulus)
+/// @param[in] num_rows Number of rows the operand is split into. Must be a
+/// power of two in [2, n / 16]
+/// @param[in] inv_n_factors Optional constants of the final stage, as computed
+/// by ComputeInvNFactors for \p BitShift. If nullptr, computed with scalar 1
+/// @param[in] tile Optional scratch of num_rows * s_four_step_tile_width
+/// words, 64-byte aligned. If nullptr, allocated by the call
+/// @details Computes the same result as InverseTransformFromBitReverseAVX512,
+/// for transforms whose working set exceeds the cache. The operand is viewed as
+/// a matrix with \p num_rows rows. The first stages are performed as inverse
+/// NTTs on the contiguous rows, and the last log2(num_rows) stages, including
+/// the multiplication by n^{-1}, as inverse NTTs on the columns, a tile of
+/// adjacent columns at a time.
+template <int BitShift>
+void InverseTransformFromBitReverseFourStepAVX512(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
+    uint64_t output_mod_factor, uint64_t num_rows,
+    const MultiplyFactor* inv_n_factors = nullptr, uint64_t* tile = nullptr);
+
+/// @brief Performs one butterfly stage, or two merged stages, of the AVX512
+/// inverse NTT
+/// @param[in, out] operand Input data in [0, 2 * modulus). Overwritten with the
+/// stage output, in [0, 2 * modulus)
+/// @param[in] n Size of the transform, i.e. the polynomial degree. Must be a
+/// power of two.
+/// @param[in] modulus Prime modulus. Must satisfy q == 1 mod 2n
+/// @param[in] inv_root_of_unity_powers Powers of inverse 2n'th root of unity
+/// in F_q, as used by InverseTransformFromBitReverseAVX512
+/// @param[in] precon_inv_root_of_unity_powers Pre-conditioned \p
+/// inv_root_of_unity_powers
+/// @param[in] t Distance between the inputs of each butterfly of the first
+/// stage. Must be a power of two in [8, n / 4], or [8, n / 8] if \p
+/// num_stages is 2
+/// @param[in] num_stages Number of stages to perform, 1 or 2. Two stages are
+/// merged into one pass over the data, as in the IFMA transforms
+/// @param[in] prefetch_distance Number of cache lines to prefetch ahead; 0
+/// disables software prefetching
+/// @details Used to time individual stages when tuning the prefetch distance
+template <int BitShift>
+void InverseTransformStageAVX512(
+    uint64_t* operand, uint64_t n, uint64_t modulus,
+    const uint64_t* inv_root_of_unity_powers,
+    const uint64_t* precon_inv_root_of_unity_powers, uint64_t t,
+    uint64_t num_stages, uint64_t prefetch_distance);
 
 #endif  // HEXL_HAS_AVX512DQ
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
@@ -11,10 +11,13 @@
 #include "hexl/ntt/ntt.hpp"
 #include "hexl/number-theory/number-theory.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 
 // Given input: 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
@@ -215,5 +218,7 @@ inline __m512i LoadWOpT4(const void* arg) {
 
 #endif  // HEXL_HAS_AVX512DQ
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
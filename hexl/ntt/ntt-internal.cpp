@@ -3,25 +3,81 @@
 
 #include "ntt/ntt-internal.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
 #include <memory>
 #include <utility>
 
+#include "hexl/eltwise/eltwise-mult-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/ntt/ntt.hpp"
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/aligned-allocator.hpp"
 #include "hexl/util/check.hpp"
+#include "hexl/util/numa-allocator.hpp"
 #include "ntt/fwd-ntt-avx512.hpp"
 #include "ntt/inv-ntt-avx512.hpp"
 #include "util/cpu-features.hpp"
+#include "util/profiling-internal.hpp"
 
 namespace intel {
 namespace hexl {
 
 AllocatorStrategyPtr mallocStrategy = AllocatorStrategyPtr(new MallocStrategy);
 
+namespace {
+
+// Distance set by NTT::SetPrefetchDistance
+std::atomic<uint64_t> s_prefetch_distance{NTT::s_default_prefetch_distance};
+
+// Cache sizes assumed where the cpu does not report them
+const uint64_t s_default_l1_cache_size = 32 * 1024;
+const uint64_t s_default_l2_cache_size = 1024 * 1024;
+
+uint64_t L1CacheSize() {
+  return (l1_cache_size != 0) ? l1_cache_size : s_default_l1_cache_size;
+}
+
+uint64_t L2CacheSize() {
+  return (l2_cache_size != 0) ? l2_cache_size : s_default_l2_cache_size;
+}
+
+// Bytes accessed per element by a transform: the operand, and the roots of
+// unity with their pre-conditioned values
+const uint64_t s_bytes_per_element = 3 * sizeof(uint64_t);
+
+// Holds the preallocated scratch tile of the four-step transforms of an NTT
+// object for the duration of a call. If a concurrent call on the same object
+// holds it, Tile() returns nullptr, such that the transform allocates a
+// temporary tile instead
+class FourStepTileLock {
+ public:
+  FourStepTileLock(AlignedVector64<uint64_t>* tile, std::atomic<bool>* in_use,
+                   uint64_t num_rows)
+      : m_in_use(in_use) {
+    if (num_rows != 0 && tile->size() >= num_rows * s_four_step_tile_width &&
+        !m_in_use->exchange(true, std::memory_order_acquire)) {
+      m_tile = tile->data();
+    }
+  }
+
+  ~FourStepTileLock() {
+    if (m_tile != nullptr) {
+      m_in_use->store(false, std::memory_order_release);
+    }
+  }
+
+  uint64_t* Tile() const { return m_tile; }
+
+ private:
+  std::atomic<bool>* m_in_use;
+  uint64_t* m_tile{nullptr};
+};
+
+}  // namespace
+
 NTT::NTT(uint64_t degree, uint64_t q, uint64_t root_of_unity,
          std::shared_ptr<AllocatorBase> alloc_ptr)
     : m_degree(degree),
@@ -39,7 +95,8 @@ NTT::NTT(uint64_t degree, uint64_t q, uint64_t root_of_unity,
       m_precon32_inv_root_of_unity_powers(m_aligned_alloc),
       m_precon52_inv_root_of_unity_powers(m_aligned_alloc),
       m_precon64_inv_root_of_unity_powers(m_aligned_alloc),
-      m_inv_root_of_unity_powers(m_aligned_alloc) {
+      m_inv_root_of_unity_powers(m_aligned_alloc),
+      m_four_step_tile(m_aligned_alloc) {
   HEXL_CHECK(CheckNTTArguments(degree, q), "");
   HEXL_CHECK(IsPrimitiveRoot(m_w, 2 * degree, q),
              m_w << " is not a primitive 2*" << degree << "'th root of unity");
@@ -47,6 +104,14 @@ NTT::NTT(uint64_t degree, uint64_t q, uint64_t root_of_unity,
   m_degree_bits = Log2(m_degree);
   m_winv = InverseMod(m_w, m_q);
   ComputeRootOfUnityPowers();
+
+#ifdef HEXL_HAS_AVX512DQ
+  if (has_avx512dq && m_degree >= 32) {
+    uint64_t num_rows =
+        FourStepNumRows(m_degree, L1CacheSize(), L2CacheSize());
+    m_four_step_tile.resize(num_rows * s_four_step_tile_width);
+  }
+#endif
 }
 
 NTT::NTT(uint64_t degree, uint64_t q, std::shared_ptr<AllocatorBase> alloc_ptr)
@@ -61,18 +126,19 @@ void NTT::ComputeRootOfUnityPowers() {
 
   // 64-bit preconditioned inverse and root of unity powers
   root_of_unity_powers[0] = 1;
-  inv_root_of_unity_powers[0] = InverseMod(1, m_q);
   uint64_t idx = 0;
   uint64_t prev_idx = idx;
+  // Shoup multiplication by the fixed root avoids a 128-bit division per power
+  uint64_t w_precon = MultiplyFactor(m_w, 64, m_q).BarrettFactor();
 
   for (size_t i = 1; i < m_degree; i++) {
     idx = ReverseBits(i, m_degree_bits);
     root_of_unity_powers[idx] =
-        MultiplyMod(root_of_unity_powers[prev_idx], m_w, m_q);
-    inv_root_of_unity_powers[idx] = InverseMod(root_of_unity_powers[idx], m_q);
-
+        MultiplyMod(root_of_unity_powers[prev_idx], m_w, w_precon, m_q);
     prev_idx = idx;
   }
+  BatchInverseMod(inv_root_of_unity_powers.data(), root_of_unity_powers.data(),
+                  m_degree, m_q);
 
   m_root_of_unity_powers = root_of_unity_powers;
   m_avx512_root_of_unity_powers = m_root_of_unity_powers;
@@ -128,7 +194,8 @@ void NTT::ComputeRootOfUnityPowers() {
   m_precon64_root_of_unity_powers =
       compute_barrett_vector(root_of_unity_powers, 64);
 
-  // 52-bit preconditioned root of unity powers
+  // 52-bit preconditioned root of unity powers. Tables depend on CPU support
+  // only, so that SetMaxISATier may be changed after construction
   if (has_avx512ifma) {
     m_avx512_precon52_root_of_unity_powers =
         compute_barrett_vector(m_avx512_root_of_unity_powers, 52);
@@ -169,11 +236,150 @@ void NTT::ComputeRootOfUnityPowers() {
   // 64-bit preconditioned inverse root of unity powers
   m_precon64_inv_root_of_unity_powers =
       compute_barrett_vector(m_inv_root_of_unity_powers, 64);
+
+  // Constants of the final inverse NTT stage, which would otherwise cost
+  // several 128-bit divisions per inverse transform
+  uint64_t inv_w = m_inv_root_of_unity_powers[m_degree - 1];
+  ComputeInvNFactors(m_degree, m_q, inv_w, 1, 32, m_inv_n_factors32);
+  ComputeInvNFactors(m_degree, m_q, inv_w, 1, 52, m_inv_n_factors52);
+  ComputeInvNFactors(m_degree, m_q, inv_w, 1, 64, m_inv_n_factors64);
+}
+
+void NTT::ReplicateTablesPerNumaNode() {
+  int num_nodes = NumaAllocator::NumNodes();
+  if (num_nodes <= 1 || !m_numa_replicas.empty()) {
+    return;
+  }
+  HEXL_VLOG(3, "Replicating NTT tables on " << num_nodes << " NUMA nodes");
+  bool any_replica = false;
+  for (int node = 0; node < num_nodes; ++node) {
+    auto alloc = std::make_shared<NumaAllocator>(node);
+    auto replica = std::make_shared<NTT>(
+        m_degree, m_q, m_w, std::static_pointer_cast<AllocatorBase>(alloc));
+    // The tables of a replica whose memory could not be bound are placed on
+    // the node of this thread, so are no more local than those of *this
+    if (alloc->NumBindFailures() != 0) {
+      HEXL_VLOG(3, "Not replicating NTT tables on NUMA node " << node);
+      replica = nullptr;
+    } else {
+      replica->SetEngine(m_engine);
+      any_replica = true;
+    }
+    m_numa_replicas.push_back(replica);
+  }
+  if (!any_replica) {
+    m_numa_replicas.clear();
+  }
+}
+
+NTT& NTT::GetNumaLocalReplica() {
+  if (m_numa_replicas.empty()) {
+    return *this;
+  }
+  size_t node = static_cast<size_t>(NumaAllocator::CurrentNode());
+  return (node < m_numa_replicas.size() && m_numa_replicas[node])
+             ? *m_numa_replicas[node]
+             : *this;
+}
+
+void NTT::SetPrefetchDistance(uint64_t distance) {
+  s_prefetch_distance.store(distance, std::memory_order_relaxed);
+}
+
+uint64_t NTT::GetPrefetchDistance() {
+  return s_prefetch_distance.load(std::memory_order_relaxed);
+}
+
+void NTT::SetEngine(Engine engine) {
+  m_engine = engine;
+  for (auto& replica : m_numa_replicas) {
+    if (replica) {
+      replica->SetEngine(engine);
+    }
+  }
+}
+
+NTT::Engine NTT::SelectedEngine() const {
+  // The four-step transforms are AVX512 only, and need at least two rows of
+  // at least 16 elements
+  if (SelectedForwardKernel() == KernelVariant::Native || m_degree < 32) {
+    return Engine::Recursive;
+  }
+  Engine engine = m_engine;
+  if (engine == Engine::Auto) {
+    // The recursive transforms stream the data from beyond the L2 cache once
+    // per stage until the subtransforms fit in it, i.e. about
+    // log2(working set / L2 size) times, whereas the four-step transforms do
+    // so twice. Within a few such passes, both are equally fast
+    engine = (m_degree * s_bytes_per_element > 16 * L2CacheSize())
+                 ? Engine::FourStep
+                 : Engine::Recursive;
+  }
+  return engine;
+}
+
+KernelVariant NTT::SelectedForwardKernel() const {
+#ifdef HEXL_HAS_AVX512IFMA
+  if (UseAVX512IFMA() && (m_q < s_max_fwd_ifma_modulus) &&
+      (m_degree >= 16)) {
+    return KernelVariant::AVX512IFMA;
+  }
+#endif
+#ifdef HEXL_HAS_AVX512DQ
+  if (UseAVX512DQ() && m_degree >= 16) {
+    return (m_q < s_max_fwd_32_modulus) ? KernelVariant::AVX512DQ32
+                                        : KernelVariant::AVX512DQ64;
+  }
+#endif
+  return KernelVariant::Native;
+}
+
+KernelVariant NTT::SelectedInverseKernel() const {
+#ifdef HEXL_HAS_AVX512IFMA
+  if (UseAVX512IFMA() && (m_q < s_max_inv_ifma_modulus) &&
+      (m_degree >= 16)) {
+    return KernelVariant::AVX512IFMA;
+  }
+#endif
+#ifdef HEXL_HAS_AVX512DQ
+  if (UseAVX512DQ() && m_degree >= 16) {
+    return (m_q < s_max_inv_32_modulus) ? KernelVariant::AVX512DQ32
+                                        : KernelVariant::AVX512DQ64;
+  }
+#endif
+  return KernelVariant::Native;
 }
 
 void NTT::ComputeForward(uint64_t* result, const uint64_t* operand,
                          uint64_t input_mod_factor,
                          uint64_t output_mod_factor) {
+  ComputeForwardInternal(result, operand, nullptr, input_mod_factor,
+                         output_mod_factor);
+}
+
+void NTT::ComputeForwardMultiply(uint64_t* result, const uint64_t* operand,
+                                 const uint64_t* multiplicand,
+                                 uint64_t input_mod_factor) {
+  HEXL_CHECK(multiplicand != nullptr, "multiplicand == nullptr");
+  HEXL_CHECK(multiplicand != result, "multiplicand == result");
+  HEXL_CHECK_BOUNDS(multiplicand, m_degree, m_q,
+                    "value in multiplicand exceeds bound " << m_q);
+  ComputeForwardInternal(result, operand, multiplicand, input_mod_factor, 1);
+}
+
+void NTT::ComputeForwardInternal(uint64_t* result, const uint64_t* operand,
+                                 const uint64_t* multiplicand,
+                                 uint64_t input_mod_factor,
+                                 uint64_t output_mod_factor) {
+  if (!m_numa_replicas.empty()) {
+    NTT& local = GetNumaLocalReplica();
+    if (&local != this) {
+      local.ComputeForwardInternal(result, operand, multiplicand,
+                                   input_mod_factor, output_mod_factor);
+      return;
+    }
+  }
+
   HEXL_CHECK(result != nullptr, "result == nullptr");
   HEXL_CHECK(operand != nullptr, "operand == nullptr");
   HEXL_CHECK(
@@ -189,47 +395,99 @@ void NTT::ComputeForward(uint64_t* result, const uint64_t* operand,
     std::memcpy(result, operand, m_degree * sizeof(uint64_t));
   }
 
+  // Number of rows of the four-step transforms, or 0 to use the recursive ones
+  uint64_t num_rows =
+      (SelectedEngine() == Engine::FourStep)
+          ? FourStepNumRows(m_degree, L1CacheSize(), L2CacheSize())
+          : 0;
+  FourStepTileLock tile_lock(&m_four_step_tile, &m_four_step_tile_flag.in_use,
+                             num_rows);
+  (void)(num_rows);  // Avoid unused variable warning without AVX512
+
+  // Resolved once, rather than by each multiplication of a base case
+  EltwiseMultModFnPtr mult_mod_kernel =
+      (multiplicand != nullptr) ? GetEltwiseMultModKernel(m_q, 1, 1) : nullptr;
+  bool multiply = (multiplicand != nullptr);
+  (void)(multiply);  // Avoid unused variable warning without HEXL_PROFILE
+
+  switch (SelectedForwardKernel()) {
 #ifdef HEXL_HAS_AVX512IFMA
-  if (has_avx512ifma && (m_q < s_max_fwd_ifma_modulus && (m_degree >= 16))) {
-    const uint64_t* root_of_unity_powers = GetAVX512RootOfUnityPowers().data();
-    const uint64_t* precon_root_of_unity_powers =
-        GetAVX512Precon52RootOfUnityPowers().data();
-
-    HEXL_VLOG(3, "Calling 52-bit AVX512-IFMA FwdNTT");
-    ForwardTransformToBitReverseAVX512<s_ifma_shift_bits>(
-        result, m_degree, m_q, root_of_unity_powers,
-        precon_root_of_unity_powers, input_mod_factor, output_mod_factor);
-    return;
-  }
+    case KernelVariant::AVX512IFMA: {
+      HEXL_VLOG(3, "Calling 52-bit AVX512-IFMA FwdNTT");
+      HEXL_PROFILE_KERNEL_SELECT(multiply,
+                                 "NTT::ComputeForwardMultiply/AVX512IFMA",
+                                 "NTT::ComputeForward/AVX512IFMA", m_degree);
+      const uint64_t* root_of_unity_powers =
+          GetAVX512RootOfUnityPowers().data();
+      const uint64_t* precon_root_of_unity_powers =
+          GetAVX512Precon52RootOfUnityPowers().data();
+      if (num_rows != 0) {
+        ForwardTransformToBitReverseFourStepAVX512<s_ifma_shift_bits>(
+            result, m_degree, m_q, root_of_unity_powers,
+            precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
+            num_rows, multiplicand, mult_mod_kernel, tile_lock.Tile());
+        return;
+      }
+      ForwardTransformToBitReverseAVX512<s_ifma_shift_bits>(
+          result, m_degree, m_q, root_of_unity_powers,
+          precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
+          0, 0, multiplicand, mult_mod_kernel);
+      return;
+    }
 #endif
-
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq && m_degree >= 16) {
-    if (m_q < s_max_fwd_32_modulus) {
+    case KernelVariant::AVX512DQ32: {
       HEXL_VLOG(3, "Calling 32-bit AVX512-DQ FwdNTT");
+      HEXL_PROFILE_KERNEL_SELECT(multiply,
+                                 "NTT::ComputeForwardMultiply/AVX512DQ-32",
+                                 "NTT::ComputeForward/AVX512DQ-32", m_degree);
       const uint64_t* root_of_unity_powers =
           GetAVX512RootOfUnityPowers().data();
       const uint64_t* precon_root_of_unity_powers =
           GetAVX512Precon32RootOfUnityPowers().data();
+      if (num_rows != 0) {
+        ForwardTransformToBitReverseFourStepAVX512<32>(
+            result, m_degree, m_q, root_of_unity_powers,
+            precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
+            num_rows, multiplicand, mult_mod_kernel, tile_lock.Tile());
+        return;
+      }
       ForwardTransformToBitReverseAVX512<32>(
           result, m_degree, m_q, root_of_unity_powers,
-          precon_root_of_unity_powers, input_mod_factor, output_mod_factor);
-    } else {
+          precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
+          0, 0, multiplicand, mult_mod_kernel);
+      return;
+    }
+    case KernelVariant::AVX512DQ64: {
       HEXL_VLOG(3, "Calling 64-bit AVX512-DQ FwdNTT");
+      HEXL_PROFILE_KERNEL_SELECT(multiply,
+                                 "NTT::ComputeForwardMultiply/AVX512DQ-64",
+                                 "NTT::ComputeForward/AVX512DQ-64", m_degree);
       const uint64_t* root_of_unity_powers =
           GetAVX512RootOfUnityPowers().data();
       const uint64_t* precon_root_of_unity_powers =
           GetAVX512Precon64RootOfUnityPowers().data();
-
+      if (num_rows != 0) {
+        ForwardTransformToBitReverseFourStepAVX512<s_default_shift_bits>(
+            result, m_degree, m_q, root_of_unity_powers,
+            precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
+            num_rows, multiplicand, mult_mod_kernel, tile_lock.Tile());
+        return;
+      }
       ForwardTransformToBitReverseAVX512<s_default_shift_bits>(
           result, m_degree, m_q, root_of_unity_powers,
-          precon_root_of_unity_powers, input_mod_factor, output_mod_factor);
+          precon_root_of_unity_powers, input_mod_factor, output_mod_factor,
+          0, 0, multiplicand, mult_mod_kernel);
+      return;
     }
-    return;
-  }
 #endif
+    default:
+      break;
+  }
 
   HEXL_VLOG(3, "Calling 64-bit default FwdNTT");
+  HEXL_PROFILE_KERNEL_SELECT(multiply, "NTT::ComputeForwardMultiply/Native",
+                             "NTT::ComputeForward/Native", m_degree);
   const uint64_t* root_of_unity_powers = GetRootOfUnityPowers().data();
   const uint64_t* precon_root_of_unity_powers =
       GetPrecon64RootOfUnityPowers().data();
@@ -237,11 +495,29 @@ void NTT::ComputeForward(uint64_t* result, const uint64_t* operand,
   ForwardTransformToBitReverse64(result, m_degree, m_q, root_of_unity_powers,
                                  precon_root_of_unity_powers, input_mod_factor,
                                  output_mod_factor);
+  if (multiplicand != nullptr) {
+    mult_mod_kernel(result, result, multiplicand, m_degree, m_q);
+  }
 }
 
 void NTT::ComputeInverse(uint64_t* result, const uint64_t* operand,
                          uint64_t input_mod_factor,
                          uint64_t output_mod_factor) {
+  ComputeInverse(result, operand, input_mod_factor, output_mod_factor, 1);
+}
+
+void NTT::ComputeInverse(uint64_t* result, const uint64_t* operand,
+                         uint64_t input_mod_factor, uint64_t output_mod_factor,
+                         uint64_t scalar) {
+  if (!m_numa_replicas.empty()) {
+    NTT& local = GetNumaLocalReplica();
+    if (&local != this) {
+      local.ComputeInverse(result, operand, input_mod_factor,
+                           output_mod_factor, scalar);
+      return;
+    }
+  }
+
   HEXL_CHECK(result != nullptr, "result == nullptr");
   HEXL_CHECK(operand != nullptr, "operand == nullptr");
   HEXL_CHECK(input_mod_factor == 1 || input_mod_factor == 2,
@@ -250,57 +526,118 @@ void NTT::ComputeInverse(uint64_t* result, const uint64_t* operand,
              "output_mod_factor must be 1 or 2; got " << output_mod_factor);
   HEXL_CHECK_BOUNDS(operand, m_degree, m_q * input_mod_factor,
                     "operand exceeds bound " << m_q * input_mod_factor);
+  HEXL_CHECK(scalar < m_q, "scalar " << scalar << " exceeds bound " << m_q);
 
   if (operand != result) {
     std::memcpy(result, operand, m_degree * sizeof(uint64_t));
   }
 
+  // Number of rows of the four-step transforms, or 0 to use the recursive ones
+  uint64_t num_rows =
+      (SelectedEngine() == Engine::FourStep)
+          ? FourStepNumRows(m_degree, L1CacheSize(), L2CacheSize())
+          : 0;
+  FourStepTileLock tile_lock(&m_four_step_tile, &m_four_step_tile_flag.in_use,
+                             num_rows);
+  (void)(num_rows);  // Avoid unused variable warning without AVX512
+
+  // Constants of the final stage for the given bit shift, precomputed unless
+  // scaled by a scalar other than 1
+  MultiplyFactor scaled_inv_n_factors[2];
+  auto inv_n_factors =
+      [&](uint64_t bit_shift,
+          const MultiplyFactor* precomputed) -> const MultiplyFactor* {
+    if (scalar == 1) {
+      return precomputed;
+    }
+    ScaleInvNFactors(m_inv_n_factors64, scalar, m_q, bit_shift,
+                     scaled_inv_n_factors);
+    return scaled_inv_n_factors;
+  };
+
+  switch (SelectedInverseKernel()) {
 #ifdef HEXL_HAS_AVX512IFMA
-  if (has_avx512ifma && (m_q < s_max_inv_ifma_modulus) && (m_degree >= 16)) {
-    HEXL_VLOG(3, "Calling 52-bit AVX512-IFMA InvNTT");
-    const uint64_t* inv_root_of_unity_powers = GetInvRootOfUnityPowers().data();
-    const uint64_t* precon_inv_root_of_unity_powers =
-        GetPrecon52InvRootOfUnityPowers().data();
-    InverseTransformFromBitReverseAVX512<s_ifma_shift_bits>(
-        result, m_degree, m_q, inv_root_of_unity_powers,
-        precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor);
-    return;
-  }
+    case KernelVariant::AVX512IFMA: {
+      HEXL_VLOG(3, "Calling 52-bit AVX512-IFMA InvNTT");
+      HEXL_PROFILE_KERNEL("NTT::ComputeInverse/AVX512IFMA", m_degree);
+      const uint64_t* inv_root_of_unity_powers =
+          GetInvRootOfUnityPowers().data();
+      const uint64_t* precon_inv_root_of_unity_powers =
+          GetPrecon52InvRootOfUnityPowers().data();
+      if (num_rows != 0) {
+        InverseTransformFromBitReverseFourStepAVX512<s_ifma_shift_bits>(
+            result, m_degree, m_q, inv_root_of_unity_powers,
+            precon_inv_root_of_unity_powers, input_mod_factor,
+            output_mod_factor, num_rows,
+            inv_n_factors(s_ifma_shift_bits, m_inv_n_factors52),
+            tile_lock.Tile());
+        return;
+      }
+      InverseTransformFromBitReverseAVX512<s_ifma_shift_bits>(
+          result, m_degree, m_q, inv_root_of_unity_powers,
+          precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor,
+          0, 0, inv_n_factors(s_ifma_shift_bits, m_inv_n_factors52));
+      return;
+    }
 #endif
-
 #ifdef HEXL_HAS_AVX512DQ
-  if (has_avx512dq && m_degree >= 16) {
-    if (m_q < s_max_inv_32_modulus) {
+    case KernelVariant::AVX512DQ32: {
       HEXL_VLOG(3, "Calling 32-bit AVX512-DQ InvNTT");
+      HEXL_PROFILE_KERNEL("NTT::ComputeInverse/AVX512DQ-32", m_degree);
       const uint64_t* inv_root_of_unity_powers =
           GetInvRootOfUnityPowers().data();
       const uint64_t* precon_inv_root_of_unity_powers =
           GetPrecon32InvRootOfUnityPowers().data();
+      if (num_rows != 0) {
+        InverseTransformFromBitReverseFourStepAVX512<32>(
+            result, m_degree, m_q, inv_root_of_unity_powers,
+            precon_inv_root_of_unity_powers, input_mod_factor,
+            output_mod_factor, num_rows,
+            inv_n_factors(32, m_inv_n_factors32), tile_lock.Tile());
+        return;
+      }
       InverseTransformFromBitReverseAVX512<32>(
           result, m_degree, m_q, inv_root_of_unity_powers,
-          precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor);
-    } else {
+          precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor,
+          0, 0, inv_n_factors(32, m_inv_n_factors32));
+      return;
+    }
+    case KernelVariant::AVX512DQ64: {
       HEXL_VLOG(3, "Calling 64-bit AVX512 InvNTT");
+      HEXL_PROFILE_KERNEL("NTT::ComputeInverse/AVX512DQ-64", m_degree);
       const uint64_t* inv_root_of_unity_powers =
           GetInvRootOfUnityPowers().data();
       const uint64_t* precon_inv_root_of_unity_powers =
           GetPrecon64InvRootOfUnityPowers().data();
-
+      if (num_rows != 0) {
+        InverseTransformFromBitReverseFourStepAVX512<s_default_shift_bits>(
+            result, m_degree, m_q, inv_root_of_unity_powers,
+            precon_inv_root_of_unity_powers, input_mod_factor,
+            output_mod_factor, num_rows,
+            inv_n_factors(s_default_shift_bits, m_inv_n_factors64),
+            tile_lock.Tile());
+        return;
+      }
       InverseTransformFromBitReverseAVX512<s_default_shift_bits>(
           result, m_degree, m_q, inv_root_of_unity_powers,
-          precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor);
+          precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor,
+          0, 0, inv_n_factors(s_default_shift_bits, m_inv_n_factors64));
+      return;
     }
-    return;
-  }
 #endif
+    default:
+      break;
+  }
 
   HEXL_VLOG(3, "Calling 64-bit default InvNTT");
+  HEXL_PROFILE_KERNEL("NTT::ComputeInverse/Native", m_degree);
   const uint64_t* inv_root_of_unity_powers = GetInvRootOfUnityPowers().data();
   const uint64_t* precon_inv_root_of_unity_powers =
       GetPrecon64InvRootOfUnityPowers().data();
   InverseTransformFromBitReverse64(
       result, m_degree, m_q, inv_root_of_unity_powers,
-      precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor);
+      precon_inv_root_of_unity_powers, input_mod_factor, output_mod_factor,
+      inv_n_factors(64, m_inv_n_factors64));
 }
 
 // Free functions
@@ -410,7 +747,7 @@ void InverseTransformFromBitReverse64(
     uint64_t* operand, uint64_t n, uint64_t modulus,
     const uint64_t* inv_root_of_unity_powers,
     const uint64_t* precon_inv_root_of_unity_powers, uint64_t input_mod_factor,
-    uint64_t output_mod_factor) {
+    uint64_t output_mod_factor, const MultiplyFactor* inv_n_factors) {
   HEXL_CHECK(CheckNTTArguments(n, modulus), "");
   HEXL_CHECK(inv_root_of_unity_powers != nullptr,
              "inv_root_of_unity_powers == nullptr");
@@ -454,9 +791,16 @@ void InverseTransformFromBitReverse64(
     t <<= 1;
   }
 
-  const uint64_t W_op = inv_root_of_unity_powers[root_index];
-  const uint64_t inv_n = InverseMod(n, modulus);
-  const uint64_t inv_n_w = MultiplyMod(inv_n, W_op, modulus);
+  MultiplyFactor default_inv_n_factors[2];
+  if (inv_n_factors == nullptr) {
+    ComputeInvNFactors(n, modulus, inv_root_of_unity_powers[root_index], 1, 64,
+                       default_inv_n_factors);
+    inv_n_factors = default_inv_n_factors;
+  }
+  const uint64_t inv_n = inv_n_factors[0].Operand();
+  const uint64_t inv_n_precon = inv_n_factors[0].BarrettFactor();
+  const uint64_t inv_n_w = inv_n_factors[1].Operand();
+  const uint64_t inv_n_w_precon = inv_n_factors[1].BarrettFactor();
 
   uint64_t* X = operand;
   uint64_t* Y = X + (n >> 1);
@@ -469,8 +813,8 @@ void InverseTransformFromBitReverse64(
       tx -= twice_mod;
     }
     ty = X[j] + twice_mod - Y[j];
-    X[j] = MultiplyModLazy<64>(tx, inv_n, modulus);
-    Y[j] = MultiplyModLazy<64>(ty, inv_n_w, modulus);
+    X[j] = MultiplyModLazy<64>(tx, inv_n, inv_n_precon, modulus);
+    Y[j] = MultiplyModLazy<64>(ty, inv_n_w, inv_n_w_precon, modulus);
   }
 
   if (output_mod_factor == 1) {
@@ -485,6 +829,33 @@ void InverseTransformFromBitReverse64(
   }
 }
 
+void ComputeInvNFactors(uint64_t n, uint64_t modulus, uint64_t inv_w,
+                        uint64_t scalar, uint64_t bit_shift,
+                        MultiplyFactor* inv_n_factors) {
+  HEXL_CHECK(scalar < modulus,
+             "scalar " << scalar << " must be less than modulus " << modulus);
+  uint64_t inv_n = MultiplyMod(InverseMod(n, modulus), scalar, modulus);
+  inv_n_factors[0] = MultiplyFactor(inv_n, bit_shift, modulus);
+  inv_n_factors[1] =
+      MultiplyFactor(MultiplyMod(inv_n, inv_w, modulus), bit_shift, modulus);
+}
+
+void ScaleInvNFactors(const MultiplyFactor* inv_n_factors64, uint64_t scalar,
+                      uint64_t modulus, uint64_t bit_shift,
+                      MultiplyFactor* scaled_inv_n_factors) {
+  HEXL_CHECK(scalar < modulus,
+             "scalar " << scalar << " must be less than modulus " << modulus);
+  for (size_t i = 0; i < 2; ++i) {
+    uint64_t product = MultiplyModLazy<64>(
+        scalar, inv_n_factors64[i].Operand(),
+        inv_n_factors64[i].BarrettFactor(), modulus);
+    if (product >= modulus) {
+      product -= modulus;
+    }
+    scaled_inv_n_factors[i] = MultiplyFactor(product, bit_shift, modulus);
+  }
+}
+
 bool CheckNTTArguments(uint64_t degree, uint64_t modulus) {
   // Avoid unused parameter warnings
   (void)degree;
@@ -499,5 +870,18 @@ bool CheckNTTArguments(uint64_t degree, uint64_t modulus) {
   return true;
 }
 
+uint64_t FourStepNumRows(uint64_t n, uint64_t l1_size, uint64_t l2_size) {
+  HEXL_CHECK(IsPowerOfTwo(n) && n >= 32,
+             "n must be a power of two, at least 32; got n = " << n);
+  uint64_t tile_row_bytes = s_four_step_tile_width * sizeof(uint64_t);
+  uint64_t max_rows = std::min(n / 16, l1_size / (2 * tile_row_bytes));
+  uint64_t num_rows = 2;
+  while (2 * num_rows <= max_rows &&
+         (n / num_rows) * s_bytes_per_element > l2_size) {
+    num_rows <<= 1;
+  }
+  return num_rows;
+}
+
 }  // namespace hexl
 }  // namespace intel
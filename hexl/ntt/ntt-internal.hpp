@@ -39,10 +39,37 @@ void InverseTransformFromBitReverse64(
     uint64_t* operand, uint64_t n, uint64_t modulus,
     const uint64_t* inv_root_of_unity_powers,
     const uint64_t* precon_inv_root_of_unity_powers,
-    uint64_t input_mod_factor = 1, uint64_t output_mod_factor = 1);
+    uint64_t input_mod_factor = 1, uint64_t output_mod_factor = 1,
+    const MultiplyFactor* inv_n_factors = nullptr);
+
+// Stores in inv_n_factors[0] and inv_n_factors[1] the constants n^{-1} * scalar
+// and n^{-1} * scalar * inv_w mod modulus, with their Barrett factors for the
+// given bit shift. These are the multiplicands of the final stage of the
+// inverse NTTs of degree n, where inv_w is the last inverse root of unity power
+void ComputeInvNFactors(uint64_t n, uint64_t modulus, uint64_t inv_w,
+                        uint64_t scalar, uint64_t bit_shift,
+                        MultiplyFactor* inv_n_factors);
+
+// Stores in scaled_inv_n_factors the constants computed by ComputeInvNFactors
+// with the given scalar and bit shift, from inv_n_factors64, those computed
+// with scalar 1 and bit shift 64. Cheaper than ComputeInvNFactors, needing
+// only the 128-bit divisions of the two Barrett factors
+void ScaleInvNFactors(const MultiplyFactor* inv_n_factors64, uint64_t scalar,
+                      uint64_t modulus, uint64_t bit_shift,
+                      MultiplyFactor* scaled_inv_n_factors);
 
 // Returns true if arguments satisfy constraints for negacyclic NTT
 bool CheckNTTArguments(uint64_t degree, uint64_t modulus);
 
+// Number of elements in each row of the tiles of columns processed by the
+// column transforms of the four-step NTTs
+static const uint64_t s_four_step_tile_width = 32;
+
+// Returns the number of rows of the four-step NTTs of degree n, given the sizes
+// in bytes of the L1 and L2 data caches. Chooses the fewest rows such that each
+// row transform, with its roots of unity, fits in the L2 cache, subject to
+// each tile of columns fitting in half of the L1 cache
+uint64_t FourStepNumRows(uint64_t n, uint64_t l1_size, uint64_t l2_size);
+
 }  // namespace hexl
 }  // namespace intel
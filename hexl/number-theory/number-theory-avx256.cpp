@@ -0,0 +1,46 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "number-theory/number-theory-avx256.hpp"
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/check.hpp"
+#include "util/isa-target.hpp"
+
+namespace intel {
+namespace hexl {
+
+HEXL_BEGIN_TARGET_AVX256
+
+#ifdef HEXL_HAS_AVX256
+
+void BitReversePermutationIndicesAVX256(uint64_t* result, uint64_t n) {
+  HEXL_CHECK(result != nullptr, "Require result != nullptr");
+  HEXL_CHECK(IsPowerOfTwo(n), "n " << n << " is not a power of two");
+  HEXL_CHECK(n >= 4, "Require n >= 4");
+
+  // See BitReversePermutationIndicesAVX512; here i = 4 * k + j with j < 4
+  const uint64_t high_bits = Log2(n) - 2;
+  const __m256i v_low =
+      _mm256_set_epi64x(static_cast<int64_t>(3ULL << high_bits),
+                        static_cast<int64_t>(1ULL << high_bits),
+                        static_cast<int64_t>(2ULL << high_bits), 0);
+
+  __m256i* vp_result = reinterpret_cast<__m256i*>(result);
+  const uint64_t block_count = n / 4;
+  for (uint64_t k = 0; k < block_count; ++k) {
+    __m256i v_high =
+        _mm256_set1_epi64x(static_cast<int64_t>(ReverseBits(k, high_bits)));
+    _mm256_storeu_si256(vp_result++, _mm256_or_si256(v_low, v_high));
+  }
+}
+
+#endif  // HEXL_HAS_AVX256
+
+HEXL_END_TARGET
+
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,53 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "number-theory/number-theory-avx512.hpp"
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/check.hpp"
+#include "util/isa-target.hpp"
+
+namespace intel {
+namespace hexl {
+
+HEXL_BEGIN_TARGET_AVX512
+
+#ifdef HEXL_HAS_AVX512DQ
+
+void BitReversePermutationIndicesAVX512(uint64_t* result, uint64_t n) {
+  HEXL_CHECK(result != nullptr, "Require result != nullptr");
+  HEXL_CHECK(IsPowerOfTwo(n), "n " << n << " is not a power of two");
+  HEXL_CHECK(n >= 8, "Require n >= 8");
+
+  // Writing i = 8 * k + j with j < 8, the bit-reversal of i is the bit-reversal
+  // of j in the top 3 bits, concatenated with the bit-reversal of k in the
+  // remaining low bits. So each group of 8 outputs is a constant vector,
+  // depending only on j, OR'ed with a single broadcast scalar.
+  const uint64_t high_bits = Log2(n) - 3;
+  const __m512i v_low = _mm512_set_epi64(
+      static_cast<int64_t>(7ULL << high_bits),
+      static_cast<int64_t>(3ULL << high_bits),
+      static_cast<int64_t>(5ULL << high_bits),
+      static_cast<int64_t>(1ULL << high_bits),
+      static_cast<int64_t>(6ULL << high_bits),
+      static_cast<int64_t>(2ULL << high_bits),
+      static_cast<int64_t>(4ULL << high_bits), 0);
+
+  __m512i* vp_result = reinterpret_cast<__m512i*>(result);
+  const uint64_t block_count = n / 8;
+  for (uint64_t k = 0; k < block_count; ++k) {
+    __m512i v_high =
+        _mm512_set1_epi64(static_cast<int64_t>(ReverseBits(k, high_bits)));
+    _mm512_storeu_si512(vp_result++, _mm512_or_si512(v_low, v_high));
+  }
+}
+
+#endif  // HEXL_HAS_AVX512DQ
+
+HEXL_END_TARGET
+
+}  // namespace hexl
+}  // namespace intel
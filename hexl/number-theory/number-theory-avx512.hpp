@@ -0,0 +1,26 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "util/isa-target.hpp"
+
+namespace intel {
+namespace hexl {
+
+HEXL_BEGIN_TARGET_AVX512
+
+#ifdef HEXL_HAS_AVX512DQ
+/// @brief Computes the bit-reversal permutation of {0, 1, ..., n - 1}, eight
+/// indices at a time
+/// @param[out] result Stores the permutation; must have room for \p n elements
+/// @param[in] n Number of indices. Must be a power of two, at least 8
+void BitReversePermutationIndicesAVX512(uint64_t* result, uint64_t n);
+#endif
+
+HEXL_END_TARGET
+
+}  // namespace hexl
+}  // namespace intel
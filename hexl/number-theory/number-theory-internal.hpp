@@ -0,0 +1,94 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/check.hpp"
+#include "hexl/util/compiler.hpp"
+
+namespace intel {
+namespace hexl {
+
+/// @brief Computes the bit-reversal permutation of {0, 1, ..., n - 1} one
+/// index at a time
+/// @param[out] result Stores the permutation; must have room for \p n elements
+/// @param[in] n Number of indices. Must be a power of two
+void BitReversePermutationIndicesNative(uint64_t* result, uint64_t n);
+
+/// @brief Modular arithmetic in Montgomery form, with R = 2^64
+/// @details Values are represented as x * R mod q, which lets modular
+/// multiplication use two 64-bit multiplications instead of a 128-bit
+/// division. Works for any odd modulus q < 2^64.
+class MontgomeryModulus {
+ public:
+  /// @brief Pre-computes the Montgomery constants for \p modulus
+  /// @param[in] modulus Must be odd
+  explicit MontgomeryModulus(uint64_t modulus) : m_modulus(modulus) {
+    HEXL_CHECK(modulus % 2 == 1, "modulus " << modulus << " must be odd");
+    // Newton iteration for q^{-1} mod 2^64; q * q == 1 mod 8 for odd q, and
+    // each iteration doubles the number of correct low bits.
+    m_inv_modulus = modulus;
+    for (int i = 0; i < 5; ++i) {
+      m_inv_modulus *= 2 - modulus * m_inv_modulus;
+    }
+    m_r_mod_q = (0 - modulus) % modulus;
+    m_r2_mod_q = MultiplyMod(m_r_mod_q, m_r_mod_q, modulus);
+  }
+
+  /// @brief Returns the modulus q
+  uint64_t Modulus() const { return m_modulus; }
+
+  /// @brief Returns 1 in Montgomery form, i.e. R mod q
+  uint64_t One() const { return m_r_mod_q; }
+
+  /// @brief Returns x * R mod q
+  uint64_t ToMontgomery(uint64_t x) const {
+    return Multiply(x % m_modulus, m_r2_mod_q);
+  }
+
+  /// @brief Returns x * R^{-1} mod q
+  uint64_t FromMontgomery(uint64_t x) const { return Reduce(0, x); }
+
+  /// @brief Returns x * y * R^{-1} mod q
+  /// @details Assumes x, y < q
+  uint64_t Multiply(uint64_t x, uint64_t y) const {
+    uint64_t prod_hi, prod_lo;
+    MultiplyUInt64(x, y, &prod_hi, &prod_lo);
+    return Reduce(prod_hi, prod_lo);
+  }
+
+  /// @brief Returns base^exp in Montgomery form, where \p base is in
+  /// Montgomery form
+  uint64_t Pow(uint64_t base, uint64_t exp) const {
+    uint64_t result = m_r_mod_q;
+    while (exp > 0) {
+      if (exp & 1) {
+        result = Multiply(result, base);
+      }
+      base = Multiply(base, base);
+      exp >>= 1;
+    }
+    return result;
+  }
+
+ private:
+  // Returns (hi * 2^64 + lo) * R^{-1} mod q, assuming hi < q
+  uint64_t Reduce(uint64_t hi, uint64_t lo) const {
+    // m * q has the same low 64 bits as the input, so the exact quotient
+    // (input - m * q) / 2^64 is the difference of the high words
+    uint64_t m = lo * m_inv_modulus;
+    uint64_t mq_hi = MultiplyUInt64Hi<64>(m, m_modulus);
+    return (hi >= mq_hi) ? (hi - mq_hi) : (hi + m_modulus - mq_hi);
+  }
+
+  uint64_t m_modulus;
+  uint64_t m_inv_modulus;  // q^{-1} mod 2^64
+  uint64_t m_r_mod_q;      // 2^64 mod q
+  uint64_t m_r2_mod_q;     // 2^128 mod q
+};
+
+}  // namespace hexl
+}  // namespace intel
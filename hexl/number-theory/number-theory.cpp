@@ -3,10 +3,20 @@
 
 #include "hexl/number-theory/number-theory.hpp"
 
-#include <random>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include "hexl/logging/logging.hpp"
 #include "hexl/util/check.hpp"
+#include "hexl/util/workspace.hpp"
+#include "number-theory/number-theory-avx256.hpp"
+#include "number-theory/number-theory-avx512.hpp"
+#include "number-theory/number-theory-internal.hpp"
+#include "util/cpu-features.hpp"
 
 namespace intel {
 namespace hexl {
@@ -42,6 +52,65 @@ uint64_t InverseMod(uint64_t input, uint64_t modulus) {
   return uint64_t(x);
 }
 
+namespace {
+// Computes the inverses of operand into result. If result aliases operand,
+// operand_copy must have room for n elements.
+void BatchInverseModImpl(uint64_t* result, const uint64_t* operand, uint64_t n,
+                         uint64_t modulus, uint64_t* operand_copy) {
+  HEXL_CHECK_BOUNDS(operand, n, modulus, "pre-reduced operand exceeds modulus");
+  if (n == 0) {
+    return;
+  }
+  if (modulus % 2 == 0) {
+    for (size_t i = 0; i < n; ++i) {
+      result[i] = InverseMod(operand[i], modulus);
+    }
+    return;
+  }
+
+  // The backward pass reads the operands after result has been overwritten
+  if (result == operand) {
+    std::copy(operand, operand + n, operand_copy);
+    operand = operand_copy;
+  }
+
+  // Montgomery's simultaneous inversion, with Montgomery multiplication of
+  // values in standard form. Each product picks up a factor R^{-1}, which the
+  // backward pass cancels exactly, so no conversions are needed.
+  // Forward pass: result[i] = operand[0] * ... * operand[i] * R^{-i}
+  MontgomeryModulus mont(modulus);
+  result[0] = operand[0];
+  for (size_t i = 1; i < n; ++i) {
+    result[i] = mont.Multiply(result[i - 1], operand[i]);
+  }
+
+  // inv = (operand[0] * ... * operand[i])^{-1} * R^i
+  uint64_t inv = InverseMod(result[n - 1], modulus);
+  for (size_t i = n - 1; i > 0; --i) {
+    uint64_t operand_inv = mont.Multiply(inv, result[i - 1]);
+    inv = mont.Multiply(inv, operand[i]);
+    result[i] = operand_inv;
+  }
+  result[0] = inv;
+}
+}  // namespace
+
+void BatchInverseMod(uint64_t* result, const uint64_t* operand, uint64_t n,
+                     uint64_t modulus) {
+  if (result == operand) {
+    Workspace workspace(n);
+    BatchInverseMod(result, operand, n, modulus, workspace);
+    return;
+  }
+  BatchInverseModImpl(result, operand, n, modulus, nullptr);
+}
+
+void BatchInverseMod(uint64_t* result, const uint64_t* operand, uint64_t n,
+                     uint64_t modulus, Workspace& workspace) {
+  uint64_t* operand_copy = (result == operand) ? workspace.Data(n) : nullptr;
+  BatchInverseModImpl(result, operand, n, modulus, operand_copy);
+}
+
 uint64_t BarrettReduce64(uint64_t input, uint64_t modulus, uint64_t q_barr) {
   HEXL_CHECK(modulus != 0, "modulus == 0");
   uint64_t q = MultiplyUInt64Hi<64>(input, q_barr);
@@ -82,6 +151,12 @@ uint64_t SubUIntMod(uint64_t x, uint64_t y, uint64_t modulus) {
 
 // Returns base^exp mod modulus
 uint64_t PowMod(uint64_t base, uint64_t exp, uint64_t modulus) {
+  if (modulus % 2 == 1) {
+    // Montgomery multiplication avoids a 128-bit division per step
+    MontgomeryModulus mont(modulus);
+    return mont.FromMontgomery(mont.Pow(mont.ToMontgomery(base), exp));
+  }
+
   base %= modulus;
   uint64_t result = 1;
   while (exp > 0) {
@@ -94,6 +169,49 @@ uint64_t PowMod(uint64_t base, uint64_t exp, uint64_t modulus) {
   return result;
 }
 
+void PowModVector(uint64_t* result, const uint64_t* base, uint64_t exp,
+                  uint64_t n, uint64_t modulus) {
+  HEXL_CHECK_BOUNDS(base, n, modulus, "pre-reduced base exceeds modulus");
+  if (modulus % 2 == 0) {
+    for (size_t i = 0; i < n; ++i) {
+      result[i] = PowMod(base[i], exp, modulus);
+    }
+    return;
+  }
+
+  // Square-and-multiply with the loop over elements innermost, so the
+  // independent multiplications of different elements can overlap. Blocks
+  // keep the squares on the stack.
+  MontgomeryModulus mont(modulus);
+  const size_t block_size = 64;
+  uint64_t squares[block_size];
+  for (size_t begin = 0; begin < n; begin += block_size) {
+    size_t len = std::min(block_size, static_cast<size_t>(n - begin));
+    const uint64_t* block_base = base + begin;
+    uint64_t* block_result = result + begin;
+    for (size_t i = 0; i < len; ++i) {
+      squares[i] = mont.ToMontgomery(block_base[i]);
+      block_result[i] = mont.One();
+    }
+    for (uint64_t e = exp; e > 0;) {
+      if (e & 1) {
+        for (size_t i = 0; i < len; ++i) {
+          block_result[i] = mont.Multiply(block_result[i], squares[i]);
+        }
+      }
+      e >>= 1;
+      if (e > 0) {
+        for (size_t i = 0; i < len; ++i) {
+          squares[i] = mont.Multiply(squares[i], squares[i]);
+        }
+      }
+    }
+    for (size_t i = 0; i < len; ++i) {
+      block_result[i] = mont.FromMontgomery(block_result[i]);
+    }
+  }
+}
+
 // Returns true whether root is a degree-th root of unity
 // degree must be a power of two.
 bool IsPrimitiveRoot(uint64_t root, uint64_t degree, uint64_t modulus) {
@@ -109,24 +227,43 @@ bool IsPrimitiveRoot(uint64_t root, uint64_t degree, uint64_t modulus) {
   return PowMod(root, degree / 2, modulus) == (modulus - 1);
 }
 
-// Tries to return a primitive degree-th root of unity
-// throw error if no root is found
+// Returns a primitive degree-th root of unity, or throws an error if none
+// exists. Deterministic: the 2-power part of the multiplicative group is
+// generated by a^m for the smallest quadratic non-residue a, where
+// modulus - 1 == 2^s * m with m odd.
 uint64_t GeneratePrimitiveRoot(uint64_t degree, uint64_t modulus) {
-  std::default_random_engine generator;
-  std::uniform_int_distribution<uint64_t> distribution(0, modulus - 1);
-
-  // We need to divide modulus-1 by degree to get the size of the quotient group
-  uint64_t size_entire_group = modulus - 1;
-
-  // Compute size of quotient group
-  uint64_t size_quotient_group = size_entire_group / degree;
-
-  for (int trial = 0; trial < 200; ++trial) {
-    uint64_t root = distribution(generator);
-    root = PowMod(root, size_quotient_group, modulus);
+  HEXL_CHECK(IsPowerOfTwo(degree), degree << " not a power of 2");
+  HEXL_CHECK(modulus % 2 == 1, "modulus " << modulus << " must be odd");
+
+  // Factor modulus - 1 == 2^s * m
+  uint64_t m = modulus - 1;
+  uint64_t s = 0;
+  while (m != 0 && m % 2 == 0) {
+    m >>= 1;
+    ++s;
+  }
+  if (s == 0 || Log2(degree) > s) {
+    HEXL_CHECK(false, "no primitive root found for degree "
+                          << degree << " modulus " << modulus);
+    return 0;
+  }
 
-    if (IsPrimitiveRoot(root, degree, modulus)) {
-      return root;
+  MontgomeryModulus mont(modulus);
+  const uint64_t minus_one = modulus - mont.One();
+  for (uint64_t a = 2; a < modulus; ++a) {
+    // x has order dividing 2^s; it is a generator of that subgroup iff
+    // x^(2^(s-1)) == -1, i.e. iff a is a quadratic non-residue
+    uint64_t x = mont.Pow(mont.ToMontgomery(a), m);
+    uint64_t x_pow = x;
+    for (uint64_t i = 1; i < s; ++i) {
+      x_pow = mont.Multiply(x_pow, x_pow);
+    }
+    if (x_pow == minus_one) {
+      // Reduce the order from 2^s to degree
+      for (uint64_t i = Log2(degree); i < s; ++i) {
+        x = mont.Multiply(x, x);
+      }
+      return mont.FromMontgomery(x);
     }
   }
   HEXL_CHECK(false, "no primitive root found for degree "
@@ -134,7 +271,7 @@ uint64_t GeneratePrimitiveRoot(uint64_t degree, uint64_t modulus) {
   return 0;
 }
 
-// Returns true whether root is a degree-th root of unity
+// Returns the smallest primitive degree-th root of unity
 // degree must be a power of two.
 uint64_t MinimalPrimitiveRoot(uint64_t degree, uint64_t modulus) {
   HEXL_CHECK(IsPowerOfTwo(degree),
@@ -142,22 +279,44 @@ uint64_t MinimalPrimitiveRoot(uint64_t degree, uint64_t modulus) {
 
   uint64_t root = GeneratePrimitiveRoot(degree, modulus);
 
+  // The primitive roots are the odd powers of root
   uint64_t generator_sq = MultiplyMod(root, root, modulus);
   uint64_t current_generator = root;
-
   uint64_t min_root = root;
 
-  // Check if root^(degree/2) == -1 mod modulus
-  for (size_t i = 0; i < degree; ++i) {
-    if (current_generator < min_root) {
-      min_root = current_generator;
+  if (modulus >> 63) {
+    // Shoup multiplication would overflow its [0, 2 * modulus) range
+    for (size_t i = 1; i < degree / 2; ++i) {
+      current_generator = MultiplyMod(current_generator, generator_sq, modulus);
+      min_root = std::min(min_root, current_generator);
     }
-    current_generator = MultiplyMod(current_generator, generator_sq, modulus);
+    return min_root;
   }
 
+  uint64_t generator_sq_precon =
+      MultiplyFactor(generator_sq, 64, modulus).BarrettFactor();
+  for (size_t i = 1; i < degree / 2; ++i) {
+    current_generator = MultiplyMod(current_generator, generator_sq,
+                                    generator_sq_precon, modulus);
+    min_root = std::min(min_root, current_generator);
+  }
   return min_root;
 }
 
+// Table of the bit-reversals of each byte
+#define HEXL_REV2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define HEXL_REV4(n)                                          \
+  HEXL_REV2(n), HEXL_REV2(n + 2 * 16), HEXL_REV2(n + 1 * 16), \
+      HEXL_REV2(n + 3 * 16)
+#define HEXL_REV6(n)                                        \
+  HEXL_REV4(n), HEXL_REV4(n + 2 * 4), HEXL_REV4(n + 1 * 4), \
+      HEXL_REV4(n + 3 * 4)
+static const uint8_t s_reverse_byte_table[256] = {
+    HEXL_REV6(0), HEXL_REV6(2), HEXL_REV6(1), HEXL_REV6(3)};
+#undef HEXL_REV6
+#undef HEXL_REV4
+#undef HEXL_REV2
+
 uint64_t ReverseBits(uint64_t x, uint64_t bit_width) {
   HEXL_CHECK(x == 0 || MSB(x) <= bit_width, "MSB(" << x << ") = " << MSB(x)
                                                    << " must be >= bit_width "
@@ -165,12 +324,51 @@ uint64_t ReverseBits(uint64_t x, uint64_t bit_width) {
   if (bit_width == 0) {
     return 0;
   }
+  // Reverse the bits within each byte, then reverse the order of the bytes
   uint64_t rev = 0;
-  for (uint64_t i = bit_width; i > 0; i--) {
-    rev |= ((x & 1) << (i - 1));
-    x >>= 1;
+  for (uint64_t i = 0; i < 64; i += 8) {
+    rev |= static_cast<uint64_t>(s_reverse_byte_table[(x >> i) & 0xFF]) << i;
+  }
+  return ByteSwap64(rev) >> (64 - bit_width);
+}
+
+void BitReversePermutationIndicesNative(uint64_t* result, uint64_t n) {
+  HEXL_CHECK(result != nullptr, "Require result != nullptr");
+  HEXL_CHECK(IsPowerOfTwo(n), "n " << n << " is not a power of two");
+  const uint64_t bit_width = Log2(n);
+  for (uint64_t i = 0; i < n; ++i) {
+    result[i] = ReverseBits(i, bit_width);
   }
-  return rev;
+}
+
+void BitReversePermutationIndices(uint64_t* result, uint64_t n) {
+  HEXL_CHECK(result != nullptr, "Require result != nullptr");
+  HEXL_CHECK(IsPowerOfTwo(n), "n " << n << " is not a power of two");
+
+#ifdef HEXL_HAS_AVX512DQ
+  if (UseAVX512DQ() && n >= 8) {
+    HEXL_VLOG(3, "Calling BitReversePermutationIndicesAVX512");
+    BitReversePermutationIndicesAVX512(result, n);
+    return;
+  }
+#endif
+
+#ifdef HEXL_HAS_AVX256
+  if (UseAVX256() && n >= 4) {
+    HEXL_VLOG(3, "Calling BitReversePermutationIndicesAVX256");
+    BitReversePermutationIndicesAVX256(result, n);
+    return;
+  }
+#endif
+
+  HEXL_VLOG(3, "Calling BitReversePermutationIndicesNative");
+  BitReversePermutationIndicesNative(result, n);
+}
+
+std::vector<uint64_t> BitReversePermutationIndices(uint64_t n) {
+  std::vector<uint64_t> result(n);
+  BitReversePermutationIndices(result.data(), n);
+  return result;
 }
 
 // Miller-Rabin primality test
@@ -178,39 +376,41 @@ bool IsPrime(uint64_t n) {
   // n < 2^64, so it is enough to test a=2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31,
   // and 37. See
   // https://en.wikipedia.org/wiki/Miller%E2%80%93Rabin_primality_test#Testing_against_small_sets_of_bases
-  static const std::vector<uint64_t> as{2,  3,  5,  7,  11, 13,
-                                        17, 19, 23, 29, 31, 37};
+  static const uint64_t as[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
 
+  if (n < 2) {
+    return false;
+  }
   for (const uint64_t a : as) {
     if (n == a) return true;
     if (n % a == 0) return false;
   }
 
   // Write n == 2**r * d + 1 with d odd.
-  uint64_t r = 63;
-  while (r > 0) {
-    uint64_t two_pow_r = (1ULL << r);
-    if ((n - 1) % two_pow_r == 0) {
-      break;
-    }
-    --r;
+  uint64_t d = n - 1;
+  uint64_t r = 0;
+  while (d % 2 == 0) {
+    d >>= 1;
+    ++r;
   }
-  HEXL_CHECK(r != 0, "Error factoring n " << n);
-  uint64_t d = (n - 1) / (1ULL << r);
-
   HEXL_CHECK(n == (1ULL << r) * d + 1, "Error factoring n " << n);
-  HEXL_CHECK(d % 2 == 1, "d is even");
+
+  // n is odd, so the witnesses can be evaluated in Montgomery form, avoiding
+  // a 128-bit division per modular multiplication
+  MontgomeryModulus mont(n);
+  const uint64_t one = mont.One();
+  const uint64_t minus_one = n - one;
 
   for (const uint64_t a : as) {
-    uint64_t x = PowMod(a, d, n);
-    if ((x == 1) || (x == n - 1)) {
+    uint64_t x = mont.Pow(mont.ToMontgomery(a), d);
+    if ((x == one) || (x == minus_one)) {
       continue;
     }
 
     bool prime = false;
     for (uint64_t i = 1; i < r; ++i) {
-      x = PowMod(x, 2, n);
-      if (x == n - 1) {
+      x = mont.Multiply(x, x);
+      if (x == minus_one) {
         prime = true;
         break;
       }
@@ -222,8 +422,165 @@ bool IsPrime(uint64_t n) {
   return true;
 }
 
+namespace {
+
+// Arithmetic progression of candidate primes start, start +/- stride, ...
+struct PrimeCandidateRun {
+  PrimeCandidateRun(uint64_t start_, uint64_t stride_, uint64_t count_,
+                    bool ascending_, const std::vector<uint64_t>& primes)
+      : start(start_), stride(stride_), count(count_), ascending(ascending_) {
+    // Index k of the first candidate divisible by each sieving prime p, i.e.
+    // start +/- k * stride == 0 mod p
+    first_multiple.reserve(primes.size());
+    for (const uint64_t p : primes) {
+      uint64_t k = MultiplyMod(start % p, InverseMod(stride, p), p);
+      if (ascending && k != 0) {
+        k = p - k;
+      }
+      first_multiple.push_back(k);
+    }
+  }
+
+  uint64_t Candidate(uint64_t k) const {
+    return ascending ? start + k * stride : start - k * stride;
+  }
+
+  // Appends the candidates with index in [begin, end) that have no factor
+  // among the sieving primes
+  void Sieve(uint64_t begin, uint64_t end,
+             const std::vector<uint64_t>& primes,
+             std::vector<uint64_t>* survivors) const {
+    end = std::min(end, count);
+    if (begin >= end) {
+      return;
+    }
+    std::vector<uint8_t> composite(end - begin, 0);
+    for (size_t i = 0; i < primes.size(); ++i) {
+      const uint64_t p = primes[i];
+      uint64_t k = first_multiple[i];
+      uint64_t j = (k >= begin) ? k - begin : (p - (begin - k) % p) % p;
+      for (; j < composite.size(); j += p) {
+        composite[j] = 1;
+      }
+    }
+    for (uint64_t k = begin; k < end; ++k) {
+      if (!composite[k - begin]) {
+        survivors->push_back(Candidate(k));
+      }
+    }
+  }
+
+  uint64_t start;
+  uint64_t stride;
+  uint64_t count;
+  bool ascending;
+  std::vector<uint64_t> first_multiple;
+};
+
+// Tests the primality of candidates on num_threads threads, spawned once for
+// the whole search. Each call to Test wakes the workers, which claim small
+// batches of the range through an atomic cursor, and returns once the range
+// is done
+class PrimalityTester {
+ public:
+  explicit PrimalityTester(size_t num_threads) {
+    m_workers.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+      m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+  }
+
+  ~PrimalityTester() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_start.notify_all();
+    for (auto& worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  PrimalityTester(const PrimalityTester&) = delete;
+  PrimalityTester& operator=(const PrimalityTester&) = delete;
+
+  // Sets is_prime[i] = IsPrime(candidates[i]) for i in [begin, end)
+  void Test(const std::vector<uint64_t>& candidates, size_t begin, size_t end,
+            std::vector<uint8_t>* is_prime) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_candidates = &candidates;
+      m_is_prime = is_prime;
+      m_end = end;
+      m_cursor.store(begin, std::memory_order_relaxed);
+      m_num_busy = m_workers.size();
+      ++m_generation;
+    }
+    m_start.notify_all();
+    TestBatches();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_num_busy == 0; });
+  }
+
+ private:
+  void WorkerLoop() {
+    uint64_t generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_start.wait(lock, [this, generation] {
+          return m_stop || m_generation != generation;
+        });
+        if (m_stop) {
+          return;
+        }
+        generation = m_generation;
+      }
+      TestBatches();
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_num_busy == 0) {
+        m_done.notify_one();
+      }
+    }
+  }
+
+  void TestBatches() {
+    const size_t batch_size = 8;
+    for (size_t first = m_cursor.fetch_add(batch_size); first < m_end;
+         first = m_cursor.fetch_add(batch_size)) {
+      size_t last = std::min(first + batch_size, m_end);
+      for (size_t i = first; i < last; ++i) {
+        (*m_is_prime)[i] = IsPrime((*m_candidates)[i]);
+      }
+    }
+  }
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_done;
+  bool m_stop{false};
+  uint64_t m_generation{0};
+  size_t m_num_busy{0};
+
+  // Current range, written under m_mutex before the workers are woken
+  const std::vector<uint64_t>* m_candidates{nullptr};
+  std::vector<uint8_t>* m_is_prime{nullptr};
+  size_t m_end{0};
+  std::atomic<size_t> m_cursor{0};
+};
+
+}  // namespace
+
 std::vector<uint64_t> GeneratePrimes(size_t num_primes, size_t bit_size,
                                      size_t ntt_size) {
+  return GeneratePrimes(num_primes, bit_size, ntt_size,
+                        GeneratePrimesOptions());
+}
+
+std::vector<uint64_t> GeneratePrimes(size_t num_primes, size_t bit_size,
+                                     size_t ntt_size,
+                                     const GeneratePrimesOptions& options) {
   HEXL_CHECK(num_primes > 0, "num_primes == 0");
   HEXL_CHECK(IsPowerOfTwo(ntt_size),
              "ntt_size " << ntt_size << " is not a power of two");
@@ -231,18 +588,109 @@ std::vector<uint64_t> GeneratePrimes(size_t num_primes, size_t bit_size,
              "log2(ntt_size) " << Log2(ntt_size)
                                << " should be less than bit_size " << bit_size);
 
-  uint64_t value = (1ULL << bit_size) + 1;
+  const uint64_t lower = 1ULL << bit_size;
+  const uint64_t upper = 1ULL << (bit_size + 1);
+  const uint64_t stride = 2 * ntt_size;
 
+  // Odd primes below 1024 no larger than any candidate. Every candidate is odd
+  // and the stride is a power of two, so the stride is invertible mod p.
+  std::vector<uint64_t> sieve_primes;
+  for (uint64_t p = 3; p < 1024 && p < lower; p += 2) {
+    if (IsPrime(p)) {
+      sieve_primes.push_back(p);
+    }
+  }
+
+  // Candidates q == 1 mod 2N in (lower, upper). lower + 1 and upper - stride
+  // + 1 are the extreme such values, since 2N divides lower.
+  const uint64_t num_candidates = (upper - lower - 1) / stride + 1;
+  std::vector<PrimeCandidateRun> runs;
+  uint64_t target = 0;
+  switch (options.direction) {
+    case PrimeSearchDirection::Upward:
+      runs.emplace_back(lower + 1, stride, num_candidates, true, sieve_primes);
+      break;
+    case PrimeSearchDirection::Downward:
+      runs.emplace_back(upper - stride + 1, stride, num_candidates, false,
+                        sieve_primes);
+      break;
+    case PrimeSearchDirection::Nearest: {
+      HEXL_CHECK(options.target >= lower && options.target < upper,
+                 "target " << options.target << " should be in [" << lower
+                           << ", " << upper << ")");
+      target = std::min(std::max(options.target, lower), upper - 1);
+      // Largest candidate <= target, or the smallest candidate if none
+      uint64_t below = (target > lower) ? target - (target - 1) % stride
+                                        : lower + 1;
+      uint64_t num_below = (below - lower - 1) / stride + 1;
+      runs.emplace_back(below, stride, num_below, false, sieve_primes);
+      runs.emplace_back(below + stride, stride, num_candidates - num_below,
+                        true, sieve_primes);
+      break;
+    }
+    default:
+      HEXL_CHECK(false, "Invalid PrimeSearchDirection");
+  }
+
+  size_t num_threads = options.num_threads;
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+
+  // Sieve and test the runs one block of indices at a time. For
+  // PrimeSearchDirection::Nearest, all candidates in a pair of blocks with the
+  // same indices are closer to the target than those in subsequent blocks.
+  const uint64_t block_size = 4096;
   std::vector<uint64_t> ret;
+  std::vector<uint64_t> survivors;
+  // Spawned on the first block needing it, and kept for the rest of the search
+  std::unique_ptr<PrimalityTester> tester;
+  for (uint64_t begin = 0; begin < num_candidates; begin += block_size) {
+    survivors.clear();
+    for (const auto& run : runs) {
+      run.Sieve(begin, begin + block_size, sieve_primes, &survivors);
+    }
+    if (runs.size() > 1) {
+      auto distance = [target](uint64_t x) {
+        return x > target ? x - target : target - x;
+      };
+      std::stable_sort(survivors.begin(), survivors.end(),
+                       [&distance](uint64_t x, uint64_t y) {
+                         return distance(x) < distance(y);
+                       });
+    }
 
-  while (value < (1ULL << (bit_size + 1))) {
-    if (IsPrime(value)) {
-      ret.emplace_back(value);
-      if (ret.size() == num_primes) {
-        return ret;
+    if (num_threads == 1) {
+      for (const uint64_t candidate : survivors) {
+        if (IsPrime(candidate)) {
+          ret.emplace_back(candidate);
+          if (ret.size() == num_primes) {
+            return ret;
+          }
+        }
+      }
+      continue;
+    }
+
+    if (!tester) {
+      tester.reset(new PrimalityTester(num_threads));
+    }
+    // Test a batch per thread at a time to bound the work wasted past the
+    // last prime needed
+    std::vector<uint8_t> is_prime(survivors.size(), 0);
+    const size_t batch_size = 64 * num_threads;
+    for (size_t batch = 0; batch < survivors.size(); batch += batch_size) {
+      size_t batch_end = std::min(batch + batch_size, survivors.size());
+      tester->Test(survivors, batch, batch_end, &is_prime);
+      for (size_t i = batch; i < batch_end; ++i) {
+        if (is_prime[i]) {
+          ret.emplace_back(survivors[i]);
+          if (ret.size() == num_primes) {
+            return ret;
+          }
+        }
       }
     }
-    value += 2 * ntt_size;
   }
 
   HEXL_CHECK(false, "Failed to find enough primes");
@@ -9,11 +9,15 @@
 
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/check.hpp"
+#include "hexl/util/streaming-stores.hpp"
 #include "hexl/util/util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 
 /// @brief Returns the unsigned 64-bit integer values in x as a vector
@@ -322,7 +326,35 @@ inline __m512i _mm512_hexl_shrdi_epi64(__m512i x, __m512i y) {
   return _mm512_hexl_shrdi_epi64(x, y, BitShift);
 }
 
+// Returns a mask selecting the lowest n 64-bit lanes, for use with masked loads
+// and stores on the n % 8 trailing elements of an array; assumes n <= 8
+inline __mmask8 _mm512_hexl_tail_mask_epi64(uint64_t n) {
+  HEXL_CHECK(n <= 8, "Require n <= 8");
+  return static_cast<__mmask8>((1U << n) - 1);
+}
+
+// Returns true if a result of n elements at result should be written with
+// non-temporal stores, per SetStreamingStoreThreshold. Streaming stores
+// require a 64-byte aligned destination
+inline bool UseStreamingStores(const uint64_t* result, uint64_t n) {
+  uint64_t threshold = GetStreamingStoreThreshold();
+  return threshold != 0 && n >= threshold &&
+         (reinterpret_cast<uintptr_t>(result) % 64) == 0;
+}
+
+// Stores x to p, with a non-temporal store bypassing the cache if stream is
+// true, in which case p must be 64-byte aligned
+inline void _mm512_hexl_store_si512(__m512i* p, __m512i x, bool stream) {
+  if (stream) {
+    _mm512_stream_si512(p, x);
+  } else {
+    _mm512_storeu_si512(p, x);
+  }
+}
+
 #endif  // HEXL_HAS_AVX512DQ
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
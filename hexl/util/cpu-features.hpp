@@ -5,9 +5,11 @@
 
 #include <stdbool.h>
 
+#include <cstdint>
 #include <cstdlib>
 
 #include "cpuinfo_x86.h"  // NOLINT(build/include_subdir)
+#include "hexl/util/isa-tier.hpp"
 
 namespace intel {
 namespace hexl {
@@ -23,6 +25,8 @@ static const bool disable_avx512vbmi2 =
 static const cpu_features::X86Features features =
     cpu_features::GetX86Info().features;
 
+static const bool has_avx256 = features.avx2;
+
 static const bool has_avx512dq = features.avx512f && features.avx512dq &&
                                  features.avx512vl && !disable_avx512dq;
 
@@ -31,5 +35,42 @@ static const bool has_avx512ifma = features.avx512ifma && !disable_avx512ifma;
 static const bool has_avx512vbmi2 =
     features.avx512vbmi2 && !disable_avx512vbmi2;
 
+// Returns the size in bytes of the data or unified cache at the given level,
+// or 0 if it is unknown
+inline uint64_t GetCacheSize(int level) {
+  const cpu_features::CacheInfo info = cpu_features::GetX86CacheInfo();
+  for (int i = 0; i < info.size; ++i) {
+    const cpu_features::CacheLevelInfo& cache = info.levels[i];
+    if (cache.level == level &&
+        (cache.cache_type == cpu_features::CPU_FEATURE_CACHE_DATA ||
+         cache.cache_type == cpu_features::CPU_FEATURE_CACHE_UNIFIED)) {
+      return static_cast<uint64_t>(cache.cache_size);
+    }
+  }
+  return 0;
+}
+
+static const uint64_t l1_cache_size = GetCacheSize(1);
+
+static const uint64_t l2_cache_size = GetCacheSize(2);
+
+// Kernel dispatch should use the functions below rather than the has_*
+// variables, so as to respect SetMaxISATier and ScopedMaxISATier
+
+// Returns true if AVX2 kernels are supported and may be dispatched
+inline bool UseAVX256() {
+  return has_avx256 && GetMaxISATier() >= ISATier::AVX2;
+}
+
+// Returns true if AVX512-DQ kernels are supported and may be dispatched
+inline bool UseAVX512DQ() {
+  return has_avx512dq && GetMaxISATier() >= ISATier::AVX512DQ;
+}
+
+// Returns true if AVX512-IFMA kernels are supported and may be dispatched
+inline bool UseAVX512IFMA() {
+  return has_avx512ifma && GetMaxISATier() >= ISATier::AVX512IFMA;
+}
+
 }  // namespace hexl
 }  // namespace intel
@@ -0,0 +1,86 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hexl/util/huge-page-allocator.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "hexl/logging/logging.hpp"
+
+namespace intel {
+namespace hexl {
+
+namespace {
+// Maps with MAP_HUGETLB only if rounding up to whole huge pages wastes at most
+// 1 / s_max_waste_ratio of the mapping, e.g. not for a table of 2 MB plus the
+// AlignedAllocator header, which would take 4 MB
+const size_t s_max_waste_ratio = 8;
+
+// Returns the size of the mapping for an allocation of bytes_count bytes: a
+// multiple of the huge page size if the waste is bounded, else bytes_count
+size_t MappingSize(size_t bytes_count) {
+  const size_t page = HugePageAllocator::s_huge_page_size;
+  size_t huge_size = (bytes_count + page - 1) / page * page;
+  return ((huge_size - bytes_count) * s_max_waste_ratio <= huge_size)
+             ? huge_size
+             : bytes_count;
+}
+}  // namespace
+
+void* HugePageAllocator::allocate(size_t bytes_count) {
+#ifdef __linux__
+  if (bytes_count >= m_min_bytes && bytes_count > 0) {
+    size_t size = MappingSize(bytes_count);
+    void* p = MAP_FAILED;
+    if (size % s_huge_page_size == 0) {
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p != MAP_FAILED) {
+        ++m_num_hugetlb;
+        return p;
+      }
+      HEXL_VLOG(3, "MAP_HUGETLB failed for " << size << " bytes");
+    }
+
+    // Transparent huge pages back the whole huge pages within the mapping
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(p, size, MADV_HUGEPAGE);
+#endif
+    ++m_num_advised;
+    return p;
+  }
+#endif
+  void* p = std::malloc(bytes_count);
+  if (p == nullptr && bytes_count > 0) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void HugePageAllocator::deallocate(void* p, size_t n) {
+  if (p == nullptr) {
+    return;
+  }
+#ifdef __linux__
+  // Same decision as in allocate, so n selects the matching release
+  if (n >= m_min_bytes && n > 0) {
+    munmap(p, MappingSize(n));
+    return;
+  }
+#endif
+  (void)n;
+  std::free(p);
+}
+
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,38 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// With HEXL_MULTI_ISA, all sources are compiled for the baseline architecture,
+// and the functions declared between HEXL_BEGIN_TARGET_* and HEXL_END_TARGET
+// are compiled for the given instruction set through the target attribute.
+// Inline functions and templates defined outside these regions, e.g. in the
+// standard library, stay baseline in every translation unit, so all copies of
+// them are the same. The regions go after the #include directives.
+// Otherwise, the sources are compiled with -march=native and the macros are
+// empty. MSVC allows intrinsics without /arch, so needs no attribute.
+
+#define HEXL_PRAGMA(...) _Pragma(#__VA_ARGS__)
+
+#if defined(HEXL_MULTI_ISA) && defined(__clang__)
+#define HEXL_BEGIN_TARGET(isa) \
+  HEXL_PRAGMA(clang attribute push(__attribute__((target(isa))), \
+                                   apply_to = function))
+#define HEXL_END_TARGET HEXL_PRAGMA(clang attribute pop)
+#elif defined(HEXL_MULTI_ISA) && defined(__GNUC__)
+#define HEXL_BEGIN_TARGET(isa) \
+  HEXL_PRAGMA(GCC push_options) HEXL_PRAGMA(GCC target(isa))
+#define HEXL_END_TARGET HEXL_PRAGMA(GCC pop_options)
+#else
+#define HEXL_BEGIN_TARGET(isa)
+#define HEXL_END_TARGET
+#endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+#define HEXL_BEGIN_TARGET_AVX512 \
+  HEXL_BEGIN_TARGET("avx512f,avx512dq,avx512vl,avx512ifma")
+#else
+#define HEXL_BEGIN_TARGET_AVX512 HEXL_BEGIN_TARGET("avx512f,avx512dq,avx512vl")
+#endif
+
+#define HEXL_BEGIN_TARGET_AVX256 HEXL_BEGIN_TARGET("avx2")
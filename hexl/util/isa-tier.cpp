@@ -0,0 +1,76 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hexl/util/isa-tier.hpp"
+
+#include <atomic>
+
+#include "util/cpu-features.hpp"
+
+namespace intel {
+namespace hexl {
+
+namespace {
+
+// Tier set by SetMaxISATier
+std::atomic<int> s_max_tier{static_cast<int>(ISATier::AVX512IFMA)};
+
+// Tier set by the innermost ScopedMaxISATier of this thread, or -1 if none
+thread_local int s_thread_max_tier = -1;
+
+}  // namespace
+
+const char* ISATierName(ISATier tier) {
+  switch (tier) {
+    case ISATier::Native:
+      return "Native";
+    case ISATier::AVX2:
+      return "AVX2";
+    case ISATier::AVX512DQ:
+      return "AVX512DQ";
+    case ISATier::AVX512IFMA:
+      return "AVX512IFMA";
+  }
+  return "Unknown";
+}
+
+ISATier DetectedISATier() {
+#ifdef HEXL_HAS_AVX512IFMA
+  if (has_avx512ifma && has_avx512dq) {
+    return ISATier::AVX512IFMA;
+  }
+#endif
+#ifdef HEXL_HAS_AVX512DQ
+  if (has_avx512dq) {
+    return ISATier::AVX512DQ;
+  }
+#endif
+#ifdef HEXL_HAS_AVX256
+  if (has_avx256) {
+    return ISATier::AVX2;
+  }
+#endif
+  return ISATier::Native;
+}
+
+void SetMaxISATier(ISATier tier) {
+  s_max_tier.store(static_cast<int>(tier), std::memory_order_relaxed);
+}
+
+ISATier GetMaxISATier() {
+  int tier = s_thread_max_tier;
+  if (tier < 0) {
+    tier = s_max_tier.load(std::memory_order_relaxed);
+  }
+  return static_cast<ISATier>(tier);
+}
+
+ScopedMaxISATier::ScopedMaxISATier(ISATier tier)
+    : m_previous_tier(s_thread_max_tier) {
+  s_thread_max_tier = static_cast<int>(tier);
+}
+
+ScopedMaxISATier::~ScopedMaxISATier() { s_thread_max_tier = m_previous_tier; }
+
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,172 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hexl/util/numa-allocator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef HEXL_HAS_LIBNUMA
+#include <numa.h>
+#include <sched.h>
+#endif
+
+#include "hexl/logging/logging.hpp"
+
+namespace intel {
+namespace hexl {
+
+#if defined(__linux__) && !defined(HEXL_HAS_LIBNUMA)
+namespace {
+// Memory policy for mbind, from linux/mempolicy.h
+const int s_mpol_preferred = 1;
+
+size_t PageSize() {
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+
+size_t MappingSize(size_t bytes_count) {
+  return (bytes_count + PageSize() - 1) / PageSize() * PageSize();
+}
+
+// Parses a node list such as "0-1,3" and returns the largest node plus one
+int ParseNumNodes(const std::string& node_list) {
+  int num_nodes = 1;
+  size_t pos = 0;
+  while (pos < node_list.size()) {
+    size_t end = node_list.find(',', pos);
+    if (end == std::string::npos) {
+      end = node_list.size();
+    }
+    std::string range = node_list.substr(pos, end - pos);
+    size_t dash = range.find('-');
+    std::string last =
+        (dash == std::string::npos) ? range : range.substr(dash + 1);
+    if (!last.empty()) {
+      num_nodes = std::max(num_nodes, std::atoi(last.c_str()) + 1);
+    }
+    pos = end + 1;
+  }
+  return num_nodes;
+}
+}  // namespace
+#endif
+
+void* NumaAllocator::allocate(size_t bytes_count) {
+  if (bytes_count == 0) {
+    return nullptr;
+  }
+#ifdef HEXL_HAS_LIBNUMA
+  if (numa_available() >= 0) {
+    bool valid_node = m_node >= 0 && m_node <= numa_max_node() &&
+                      numa_bitmask_isbitset(numa_all_nodes_ptr,
+                                            static_cast<unsigned>(m_node));
+    if (m_node != s_first_touch_node && !valid_node) {
+      HEXL_VLOG(3, "Cannot bind memory to node " << m_node);
+      ++m_num_bind_failures;
+    }
+    void* p = valid_node ? numa_alloc_onnode(bytes_count, m_node)
+                         : numa_alloc_local(bytes_count);
+    if (p == nullptr) {
+      throw std::bad_alloc();
+    }
+    return p;
+  }
+#elif defined(__linux__)
+  size_t size = MappingSize(bytes_count);
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  if (m_node != s_first_touch_node) {
+    using MaskWord = unsigned long;  // NOLINT
+    const size_t bits_per_word = 8 * sizeof(MaskWord);
+    size_t node = static_cast<size_t>(m_node);
+    std::vector<MaskWord> node_mask(node / bits_per_word + 1, 0);
+    node_mask[node / bits_per_word] = 1UL << (node % bits_per_word);
+    long ret = syscall(SYS_mbind, p, size, s_mpol_preferred,  // NOLINT
+                       node_mask.data(), node_mask.size() * bits_per_word + 1,
+                       0);
+    if (ret != 0) {
+      // The pages are placed by the default policy when first written, which
+      // need not be on m_node
+      HEXL_VLOG(3, "mbind failed for node " << m_node);
+      ++m_num_bind_failures;
+    }
+  }
+  return p;
+#endif
+  void* ptr = std::malloc(bytes_count);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void NumaAllocator::deallocate(void* p, size_t n) {
+  if (p == nullptr) {
+    return;
+  }
+#ifdef HEXL_HAS_LIBNUMA
+  if (numa_available() >= 0) {
+    numa_free(p, n);
+    return;
+  }
+#elif defined(__linux__)
+  munmap(p, MappingSize(n));
+  return;
+#endif
+  (void)n;
+  std::free(p);
+}
+
+int NumaAllocator::NumNodes() {
+#ifdef HEXL_HAS_LIBNUMA
+  if (numa_available() >= 0) {
+    // Node IDs may be sparse
+    return numa_max_node() + 1;
+  }
+#elif defined(__linux__)
+  static const int num_nodes = []() {
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string node_list;
+    if (!(online >> node_list)) {
+      return 1;
+    }
+    return ParseNumNodes(node_list);
+  }();
+  return num_nodes;
+#endif
+  return 1;
+}
+
+int NumaAllocator::CurrentNode() {
+#ifdef HEXL_HAS_LIBNUMA
+  if (numa_available() >= 0) {
+    int cpu = sched_getcpu();
+    return (cpu < 0) ? 0 : std::max(numa_node_of_cpu(cpu), 0);
+  }
+#elif defined(__linux__)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return 0;
+}
+
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,142 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hexl/util/pool-allocator.hpp"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace intel {
+namespace hexl {
+
+namespace {
+// Rounds n up to a non-zero multiple of the block alignment
+size_t BlockSize(size_t n) {
+  const size_t alignment = PoolAllocator::s_block_alignment;
+  return std::max((n + alignment - 1) / alignment * alignment, alignment);
+}
+
+// Throws unless all blocks have been deallocated. Checked in release builds
+// too, since recycling a live block, e.g. holding the tables of an NTT, would
+// silently corrupt it
+void CheckNoneOutstanding(size_t num_outstanding) {
+  if (num_outstanding != 0) {
+    throw std::runtime_error(std::to_string(num_outstanding) +
+                             " blocks have not been deallocated");
+  }
+}
+}  // namespace
+
+PoolAllocator::PoolAllocator(size_t chunk_size)
+    : m_chunk_size(BlockSize(chunk_size)) {}
+
+PoolAllocator::~PoolAllocator() noexcept {
+  for (const auto& chunk : m_chunks) {
+    std::free(chunk.buffer);
+  }
+}
+
+void* PoolAllocator::allocate(size_t bytes_count) {
+  size_t class_size = BlockSize(bytes_count);
+  void* block = nullptr;
+
+  // Creates the free list of a new size class here rather than in deallocate,
+  // such that returning a block never allocates
+  FreeBlock*& free_list = m_free_lists[class_size];
+  if (free_list != nullptr) {
+    block = free_list;
+    free_list = free_list->next;
+  } else {
+    block = AllocateFromChunks(class_size);
+  }
+  ++m_num_outstanding;
+  return block;
+}
+
+void PoolAllocator::deallocate(void* p, size_t n) {
+  if (p == nullptr) {
+    return;
+  }
+  // Checked in release builds too, since recording a foreign block would
+  // corrupt the counts, or hand it out as a block of the wrong size
+  if (m_num_outstanding == 0) {
+    throw std::runtime_error("Deallocating unknown block");
+  }
+  auto it = m_free_lists.find(BlockSize(n));
+  if (it == m_free_lists.end()) {
+    throw std::runtime_error("Deallocating block of unknown size " +
+                             std::to_string(n));
+  }
+  FreeBlock* block = static_cast<FreeBlock*>(p);
+  block->next = it->second;
+  it->second = block;
+  --m_num_outstanding;
+}
+
+void* PoolAllocator::AllocateFromChunks(size_t class_size) {
+  // Bump-allocate from the first chunk with enough room left. Scans all
+  // chunks, such that the space left in a chunk is used by later, smaller
+  // blocks. New blocks are rare, since freed blocks are recycled
+  for (auto& chunk : m_chunks) {
+    if (chunk.size - chunk.used >= class_size) {
+      void* block = chunk.begin + chunk.used;
+      chunk.used += class_size;
+      return block;
+    }
+  }
+
+  size_t size = std::max(m_chunk_size, class_size);
+  void* buffer = std::malloc(size + s_block_alignment - 1);
+  if (buffer == nullptr) {
+    throw std::bad_alloc();
+  }
+  uintptr_t address = reinterpret_cast<uintptr_t>(buffer);
+  uintptr_t aligned_address =
+      (address + s_block_alignment - 1) & ~(s_block_alignment - 1);
+  char* begin = reinterpret_cast<char*>(aligned_address);
+
+  m_chunks.push_back(Chunk{buffer, begin, size, class_size});
+  return begin;
+}
+
+void PoolAllocator::Reset() {
+  CheckNoneOutstanding(m_num_outstanding);
+  // Keeps the size classes, such that their free lists are not recreated
+  for (auto& free_list : m_free_lists) {
+    free_list.second = nullptr;
+  }
+  for (auto& chunk : m_chunks) {
+    chunk.used = 0;
+  }
+}
+
+void PoolAllocator::Release() {
+  CheckNoneOutstanding(m_num_outstanding);
+  m_free_lists.clear();
+  for (const auto& chunk : m_chunks) {
+    std::free(chunk.buffer);
+  }
+  m_chunks.clear();
+}
+
+size_t PoolAllocator::BytesReserved() const {
+  size_t bytes = 0;
+  for (const auto& chunk : m_chunks) {
+    bytes += chunk.size;
+  }
+  return bytes;
+}
+
+std::shared_ptr<PoolAllocator> PoolAllocator::ThreadLocal() {
+  static thread_local std::shared_ptr<PoolAllocator> pool =
+      std::make_shared<PoolAllocator>();
+  return pool;
+}
+
+}  // namespace hexl
+}  // namespace intel
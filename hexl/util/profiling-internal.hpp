@@ -0,0 +1,107 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "hexl/util/defines.hpp"
+#include "hexl/util/profiling.hpp"
+
+#ifdef HEXL_PROFILE
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+
+#ifdef HEXL_USE_MSVC
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+namespace intel {
+namespace hexl {
+namespace profiling {
+
+/// @brief Counters of a single kernel variant, updated concurrently
+struct KernelCounters {
+  const char* name{nullptr};
+  std::atomic<uint64_t> num_calls{0};
+  std::atomic<uint64_t> num_elements{0};
+  std::atomic<uint64_t> num_cycles{0};
+  std::atomic<uint64_t> num_nanoseconds{0};
+};
+
+/// @brief Returns the counters of the kernel variant \p name, which must be a
+/// string literal
+/// @details Never allocates, so profiled kernels remain allocation-free
+KernelCounters* RegisterKernel(const char* name);
+
+/// @brief Adds the duration of its lifetime to a kernel's counters
+class ScopedKernelTimer {
+ public:
+  ScopedKernelTimer(KernelCounters* counters, uint64_t num_elements)
+      : m_counters(counters),
+        m_num_elements(num_elements),
+        m_start_time(std::chrono::steady_clock::now()),
+        m_start_cycles(__rdtsc()) {}
+
+  ~ScopedKernelTimer() {
+    uint64_t cycles = __rdtsc() - m_start_cycles;
+    auto elapsed = std::chrono::steady_clock::now() - m_start_time;
+    uint64_t nanoseconds = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+    m_counters->num_calls.fetch_add(1, std::memory_order_relaxed);
+    m_counters->num_elements.fetch_add(m_num_elements,
+                                       std::memory_order_relaxed);
+    m_counters->num_cycles.fetch_add(cycles, std::memory_order_relaxed);
+    m_counters->num_nanoseconds.fetch_add(nanoseconds,
+                                          std::memory_order_relaxed);
+  }
+
+  ScopedKernelTimer(const ScopedKernelTimer&) = delete;
+  ScopedKernelTimer& operator=(const ScopedKernelTimer&) = delete;
+
+ private:
+  KernelCounters* m_counters;
+  uint64_t m_num_elements;
+  std::chrono::steady_clock::time_point m_start_time;
+  uint64_t m_start_cycles;
+};
+
+}  // namespace profiling
+}  // namespace hexl
+}  // namespace intel
+
+// Records a call processing n elements to the kernel variant name, timing the
+// remainder of the enclosing scope
+#define HEXL_PROFILE_KERNEL(name, n)                                 \
+  static ::intel::hexl::profiling::KernelCounters* const             \
+      hexl_profile_counters =                                        \
+          ::intel::hexl::profiling::RegisterKernel(name);            \
+  ::intel::hexl::profiling::ScopedKernelTimer hexl_profile_timer(    \
+      hexl_profile_counters, static_cast<uint64_t>(n))
+
+// Records a call processing n elements to the kernel variant true_name if
+// condition holds, and to false_name otherwise, timing the remainder of the
+// enclosing scope
+#define HEXL_PROFILE_KERNEL_SELECT(condition, true_name, false_name, n) \
+  static ::intel::hexl::profiling::KernelCounters* const                \
+      hexl_profile_true_counters =                                      \
+          ::intel::hexl::profiling::RegisterKernel(true_name);          \
+  static ::intel::hexl::profiling::KernelCounters* const                \
+      hexl_profile_false_counters =                                     \
+          ::intel::hexl::profiling::RegisterKernel(false_name);         \
+  ::intel::hexl::profiling::ScopedKernelTimer hexl_profile_timer(       \
+      (condition) ? hexl_profile_true_counters                          \
+                  : hexl_profile_false_counters,                        \
+      static_cast<uint64_t>(n))
+
+#else  // HEXL_PROFILE
+
+#define HEXL_PROFILE_KERNEL(name, n)
+
+#define HEXL_PROFILE_KERNEL_SELECT(condition, true_name, false_name, n)
+
+#endif  // HEXL_PROFILE
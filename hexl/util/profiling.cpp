@@ -0,0 +1,147 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hexl/util/profiling.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include "util/profiling-internal.hpp"
+
+namespace intel {
+namespace hexl {
+namespace profiling {
+
+#ifdef HEXL_PROFILE
+
+namespace {
+
+// Upper bound on the number of profiled kernel variants. Counters live in a
+// static array so registration never allocates
+const size_t s_max_kernels = 128;
+
+KernelCounters s_kernels[s_max_kernels];
+size_t s_num_kernels = 0;
+std::mutex s_kernels_mutex;
+
+// Shared by all kernel variants registered after s_kernels is full
+KernelCounters s_overflow_kernel;
+
+}  // namespace
+
+KernelCounters* RegisterKernel(const char* name) {
+  std::lock_guard<std::mutex> lock(s_kernels_mutex);
+  if (s_num_kernels == s_max_kernels) {
+    s_overflow_kernel.name = "(other)";
+    return &s_overflow_kernel;
+  }
+  KernelCounters* counters = &s_kernels[s_num_kernels++];
+  counters->name = name;
+  return counters;
+}
+
+bool IsEnabled() { return true; }
+
+std::vector<KernelStats> GetKernelStats() {
+  std::vector<KernelCounters*> kernels;
+  {
+    std::lock_guard<std::mutex> lock(s_kernels_mutex);
+    for (size_t i = 0; i < s_num_kernels; ++i) {
+      kernels.push_back(&s_kernels[i]);
+    }
+    if (s_overflow_kernel.name != nullptr) {
+      kernels.push_back(&s_overflow_kernel);
+    }
+  }
+
+  std::vector<KernelStats> stats;
+  for (KernelCounters* counters : kernels) {
+    KernelStats kernel_stats;
+    kernel_stats.name = counters->name;
+    kernel_stats.num_calls = counters->num_calls.load();
+    kernel_stats.num_elements = counters->num_elements.load();
+    kernel_stats.num_cycles = counters->num_cycles.load();
+    kernel_stats.num_nanoseconds = counters->num_nanoseconds.load();
+    if (kernel_stats.num_calls != 0) {
+      stats.push_back(kernel_stats);
+    }
+  }
+  std::sort(stats.begin(), stats.end(),
+            [](const KernelStats& a, const KernelStats& b) {
+              return a.name < b.name;
+            });
+  return stats;
+}
+
+void Reset() {
+  std::lock_guard<std::mutex> lock(s_kernels_mutex);
+  for (size_t i = 0; i < s_num_kernels; ++i) {
+    s_kernels[i].num_calls = 0;
+    s_kernels[i].num_elements = 0;
+    s_kernels[i].num_cycles = 0;
+    s_kernels[i].num_nanoseconds = 0;
+  }
+  s_overflow_kernel.num_calls = 0;
+  s_overflow_kernel.num_elements = 0;
+  s_overflow_kernel.num_cycles = 0;
+  s_overflow_kernel.num_nanoseconds = 0;
+}
+
+#else  // HEXL_PROFILE
+
+bool IsEnabled() { return false; }
+
+std::vector<KernelStats> GetKernelStats() { return {}; }
+
+void Reset() {}
+
+#endif  // HEXL_PROFILE
+
+std::string Report(ReportFormat format) {
+  std::vector<KernelStats> stats = GetKernelStats();
+  std::ostringstream ss;
+
+  if (format == ReportFormat::JSON) {
+    ss << "[";
+    for (size_t i = 0; i < stats.size(); ++i) {
+      ss << (i == 0 ? "\n" : ",\n");
+      ss << "  {\"name\": \"" << stats[i].name << "\", "
+         << "\"calls\": " << stats[i].num_calls << ", "
+         << "\"elements\": " << stats[i].num_elements << ", "
+         << "\"cycles\": " << stats[i].num_cycles << ", "
+         << "\"nanoseconds\": " << stats[i].num_nanoseconds << "}";
+    }
+    ss << (stats.empty() ? "]\n" : "\n]\n");
+    return ss.str();
+  }
+
+  if (!IsEnabled()) {
+    ss << "Intel HEXL profiling is disabled; rebuild with HEXL_PROFILE=ON\n";
+    return ss.str();
+  }
+
+  ss << std::left << std::setw(40) << "Kernel" << std::right << std::setw(12)
+     << "Calls" << std::setw(16) << "Elements" << std::setw(18) << "Cycles"
+     << std::setw(14) << "Cycles/elem" << std::setw(16) << "Time (ns)"
+     << "\n";
+  for (const auto& kernel_stats : stats) {
+    double cycles_per_element =
+        kernel_stats.num_elements == 0
+            ? 0.0
+            : static_cast<double>(kernel_stats.num_cycles) /
+                  static_cast<double>(kernel_stats.num_elements);
+    ss << std::left << std::setw(40) << kernel_stats.name << std::right
+       << std::setw(12) << kernel_stats.num_calls << std::setw(16)
+       << kernel_stats.num_elements << std::setw(18) << kernel_stats.num_cycles
+       << std::setw(14) << std::fixed << std::setprecision(2)
+       << cycles_per_element << std::setw(16) << kernel_stats.num_nanoseconds
+       << "\n";
+  }
+  return ss.str();
+}
+
+}  // namespace profiling
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,27 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "hexl/util/streaming-stores.hpp"
+
+#include <atomic>
+
+namespace intel {
+namespace hexl {
+
+namespace {
+
+// Threshold set by SetStreamingStoreThreshold
+std::atomic<uint64_t> s_streaming_store_threshold{0};
+
+}  // namespace
+
+void SetStreamingStoreThreshold(uint64_t n) {
+  s_streaming_store_threshold.store(n, std::memory_order_relaxed);
+}
+
+uint64_t GetStreamingStoreThreshold() {
+  return s_streaming_store_threshold.load(std::memory_order_relaxed);
+}
+
+}  // namespace hexl
+}  // namespace intel
@@ -0,0 +1,49 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "allocation-counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// The replacement operators are defined in their own translation unit, which
+// allocates nothing itself. Where operator delete is inlined next to a call to
+// operator new, GCC flags the std::free in its body as mismatched.
+
+namespace {
+thread_local bool s_count_new = false;
+thread_local size_t s_num_new = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  if (s_count_new) {
+    ++s_num_new;
+  }
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace intel {
+namespace hexl {
+
+void SetCountNew(bool enabled) { s_count_new = enabled; }
+
+size_t NumNew() { return s_num_new; }
+
+void ResetNumNew() { s_num_new = 0; }
+
+}  // namespace hexl
+}  // namespace intel
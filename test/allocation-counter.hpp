@@ -0,0 +1,22 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+
+namespace intel {
+namespace hexl {
+
+/// @brief Enables or disables counting the global operator new calls made on
+/// this thread
+void SetCountNew(bool enabled);
+
+/// @brief Returns the number of operator new calls counted on this thread
+size_t NumNew();
+
+/// @brief Resets the number of operator new calls counted on this thread
+void ResetNumNew();
+
+}  // namespace hexl
+}  // namespace intel
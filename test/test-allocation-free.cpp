@@ -0,0 +1,181 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "allocation-counter.hpp"
+#include "gtest/gtest.h"
+#include "hexl/eltwise/eltwise-add-mod.hpp"
+#include "hexl/eltwise/eltwise-cmp-add.hpp"
+#include "hexl/eltwise/eltwise-cmp-sub-mod.hpp"
+#include "hexl/eltwise/eltwise-fma-mod.hpp"
+#include "hexl/eltwise/eltwise-mult-mod.hpp"
+#include "hexl/eltwise/eltwise-reduce-mod.hpp"
+#include "hexl/eltwise/eltwise-sub-mod.hpp"
+#include "hexl/ntt/ntt.hpp"
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/workspace.hpp"
+
+// Debug builds allocate in HEXL_CHECK diagnostics, so the guarantee, and these
+// tests, only apply to release builds
+#ifndef HEXL_DEBUG
+
+namespace intel {
+namespace hexl {
+
+// Counts the allocations made through it
+struct CountingAllocator : AllocatorBase {
+  void* allocate(size_t bytes_count) final {
+    ++num_allocations;
+    return std::malloc(bytes_count);
+  }
+
+  void deallocate(void* p, size_t n) final {
+    (void)n;
+    std::free(p);
+  }
+
+  size_t num_allocations{0};
+};
+
+// Counts heap allocations on this thread, both through AllocatorBase, by
+// replacing the default allocation strategy, and through operator new
+class AllocationCounter {
+ public:
+  AllocationCounter()
+      : m_counting_alloc(std::make_shared<CountingAllocator>()),
+        m_saved_strategy(mallocStrategy) {
+    mallocStrategy = m_counting_alloc;
+    ResetNumNew();
+    SetCountNew(true);
+  }
+
+  ~AllocationCounter() {
+    SetCountNew(false);
+    mallocStrategy = m_saved_strategy;
+  }
+
+  size_t NumAllocations() const {
+    return m_counting_alloc->num_allocations + NumNew();
+  }
+
+ private:
+  std::shared_ptr<CountingAllocator> m_counting_alloc;
+  AllocatorStrategyPtr m_saved_strategy;
+};
+
+TEST(AllocationFree, NTT) {
+  auto ntt_alloc = std::make_shared<CountingAllocator>();
+  // Moduli covering the AVX512-IFMA, AVX512-DQ 32-bit and 64-bit, and native
+  // code paths
+  for (uint64_t N : {8, 1024}) {
+    for (size_t modulus_bits : {27, 49, 55, 62}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+      NTT ntt(N, modulus, ntt_alloc);
+      size_t setup_allocations = ntt_alloc->num_allocations;
+      std::vector<uint64_t> input(N, 1);
+      std::vector<uint64_t> output(N);
+
+      AllocationCounter counter;
+      ntt.ComputeForward(output.data(), input.data(), 1, 1);
+      ntt.ComputeForward(output.data(), output.data(), 2, 4);
+      ntt.ComputeForwardMultiply(output.data(), input.data(), input.data(), 1);
+      ntt.ComputeInverse(output.data(), output.data(), 2, 2);
+      ntt.ComputeInverse(output.data(), input.data(), 1, 1);
+      ntt.ComputeInverse(output.data(), input.data(), 1, 1, 3);
+      EXPECT_EQ(counter.NumAllocations(), 0);
+      EXPECT_EQ(ntt_alloc->num_allocations, setup_allocations);
+    }
+  }
+}
+
+TEST(AllocationFree, NTTFourStep) {
+  auto ntt_alloc = std::make_shared<CountingAllocator>();
+  for (uint64_t N : {1024, 4096}) {
+    for (size_t modulus_bits : {27, 49, 55, 62}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+      NTT ntt(N, modulus, ntt_alloc);
+      ntt.SetEngine(NTT::Engine::FourStep);
+      size_t setup_allocations = ntt_alloc->num_allocations;
+      std::vector<uint64_t> input(N, 1);
+      std::vector<uint64_t> output(N);
+
+      AllocationCounter counter;
+      ntt.ComputeForward(output.data(), input.data(), 1, 1);
+      ntt.ComputeForwardMultiply(output.data(), input.data(), input.data(), 1);
+      ntt.ComputeInverse(output.data(), output.data(), 2, 1);
+      ntt.ComputeInverse(output.data(), input.data(), 1, 1, 3);
+      EXPECT_EQ(counter.NumAllocations(), 0);
+      EXPECT_EQ(ntt_alloc->num_allocations, setup_allocations);
+    }
+  }
+}
+
+TEST(AllocationFree, Eltwise) {
+  // Moduli covering the floating-point and integer EltwiseMultMod paths
+  for (size_t modulus_bits : {30, 48, 60}) {
+    uint64_t n = 1027;
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, 1024)[0];
+    std::vector<uint64_t> op1(n, 3);
+    std::vector<uint64_t> op2(n, modulus - 2);
+    std::vector<uint64_t> result(n);
+
+    AllocationCounter counter;
+    EltwiseAddMod(result.data(), op1.data(), op2.data(), n, modulus);
+    EltwiseAddMod(result.data(), op1.data(), 5, n, modulus);
+    EltwiseSubMod(result.data(), op1.data(), op2.data(), n, modulus);
+    EltwiseSubMod(result.data(), op1.data(), 5, n, modulus);
+    EltwiseCmpAdd(result.data(), op1.data(), n, CMPINT::NLT, 2, 1);
+    EltwiseCmpSubMod(result.data(), op1.data(), n, modulus, CMPINT::NLT, 2,
+                     1);
+    EltwiseFMAMod(result.data(), op1.data(), 7, op2.data(), n, modulus, 1);
+    EltwiseFMAMod(result.data(), op1.data(), 7, nullptr, n, modulus, 1);
+    for (uint64_t input_mod_factor : {1, 2, 4}) {
+      EltwiseMultMod(result.data(), op1.data(), op2.data(), n, modulus,
+                     input_mod_factor);
+    }
+    EltwiseReduceMod(result.data(), op2.data(), n, modulus, modulus, 1);
+    EltwiseReduceMod(result.data(), op2.data(), n, modulus, 2, 1);
+    EXPECT_EQ(counter.NumAllocations(), 0);
+  }
+}
+
+TEST(AllocationFree, NumberTheory) {
+  uint64_t n = 300;
+  uint64_t modulus = GeneratePrimes(1, 60, 1024)[0];
+  std::vector<uint64_t> operand(n);
+  for (size_t i = 0; i < n; ++i) {
+    operand[i] = i + 1;
+  }
+  std::vector<uint64_t> result(n);
+  Workspace workspace(n);
+
+  AllocationCounter counter;
+  PowModVector(result.data(), operand.data(), 12345, n, modulus);
+  BatchInverseMod(result.data(), operand.data(), n, modulus);
+  BatchInverseMod(result.data(), result.data(), n, modulus, workspace);
+  EXPECT_EQ(counter.NumAllocations(), 0);
+}
+
+TEST(AllocationFree, Workspace) {
+  auto alloc = std::make_shared<CountingAllocator>();
+  Workspace workspace(alloc);
+  EXPECT_EQ(workspace.Capacity(), 0);
+  uint64_t* data = workspace.Data(100);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % 64, 0);
+  EXPECT_GE(workspace.Capacity(), 100);
+  size_t num_allocations = alloc->num_allocations;
+
+  // Smaller requests reuse the memory
+  EXPECT_EQ(workspace.Data(50), data);
+  EXPECT_EQ(workspace.Data(100), data);
+  EXPECT_EQ(alloc->num_allocations, num_allocations);
+}
+
+}  // namespace hexl
+}  // namespace intel
+
+#endif  // HEXL_DEBUG
@@ -10,10 +10,13 @@
 #include "gtest/gtest.h"
 #include "test-util.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
 
+HEXL_BEGIN_TARGET_AVX512
+
 #ifdef HEXL_HAS_AVX512DQ
 
 TEST(AVX512, ExtractValues) {
@@ -33,6 +36,21 @@ TEST(AVX512, ExtractDoubleValues) {
   AssertEqual(ExtractValues(x),
               std::vector<double>{3.3, 2.2, 1.1, 0, -1.1, -2.2, -3.3, -4.4});
 }
+
+TEST(AVX512, _mm512_hexl_tail_mask_epi64) {
+  EXPECT_EQ(_mm512_hexl_tail_mask_epi64(0), 0x00);
+  EXPECT_EQ(_mm512_hexl_tail_mask_epi64(1), 0x01);
+  EXPECT_EQ(_mm512_hexl_tail_mask_epi64(5), 0x1F);
+  EXPECT_EQ(_mm512_hexl_tail_mask_epi64(8), 0xFF);
+
+  std::vector<uint64_t> in{1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<uint64_t> out(8, 0);
+  __mmask8 tail = _mm512_hexl_tail_mask_epi64(3);
+  __m512i x = _mm512_maskz_loadu_epi64(tail, in.data());
+  AssertEqual(ExtractValues(x), std::vector<uint64_t>{1, 2, 3, 0, 0, 0, 0, 0});
+  _mm512_mask_storeu_epi64(out.data(), tail, x);
+  AssertEqual(out, std::vector<uint64_t>{1, 2, 3, 0, 0, 0, 0, 0});
+}
 #endif
 
 #ifdef HEXL_HAS_AVX512IFMA
@@ -271,5 +289,7 @@ TEST(AVX512, _mm512_hexl_barrett_reduce64) {
 }
 #endif
 
+HEXL_END_TARGET
+
 }  // namespace hexl
 }  // namespace intel
@@ -12,6 +12,8 @@
 #include "hexl/eltwise/eltwise-add-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/streaming-stores.hpp"
 #include "test-util.hpp"
 
 namespace intel {
@@ -243,5 +245,69 @@ TEST(EltwiseAddMod, vector_scalar_avx512_native_match) {
 }
 #endif
 
+#ifdef HEXL_HAS_AVX512DQ
+TEST(EltwiseAddMod, avx512_unaligned_tail) {
+  uint64_t modulus = GeneratePrimes(1, 50, 1024)[0];
+  CheckUnalignedTail(
+      modulus - 1,
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseAddModNative(result, op1, op2, n, modulus);
+      },
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseAddModAVX512(result, op1, op2, n, modulus);
+      });
+  CheckUnalignedTail(
+      modulus - 1,
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseAddModNative(result, op1, op2[0], n, modulus);
+      },
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseAddModAVX512(result, op1, op2[0], n, modulus);
+      });
+}
+#endif
+
+// Checks results with streaming stores enabled match those with regular
+// stores, for aligned and unaligned results
+TEST(EltwiseAddMod, StreamingStores) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  uint64_t modulus = GeneratePrimes(1, 50, 1024)[0];
+  std::uniform_int_distribution<uint64_t> distrib(0, modulus - 1);
+
+  for (size_t n : {1, 9, 1031, 4096}) {
+    AlignedVector64<uint64_t> op1(n, 0);
+    AlignedVector64<uint64_t> op2(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+      op1[i] = distrib(gen);
+      op2[i] = distrib(gen);
+    }
+    for (size_t offset : {0, 1}) {
+      AlignedVector64<uint64_t> expected(n + offset, 0);
+      AlignedVector64<uint64_t> result(n + offset, 0);
+      EltwiseAddMod(expected.data() + offset, op1.data(), op2.data(), n,
+                    modulus);
+
+      SetStreamingStoreThreshold(1);
+      EXPECT_EQ(GetStreamingStoreThreshold(), 1ULL);
+      EltwiseAddMod(result.data() + offset, op1.data(), op2.data(), n,
+                    modulus);
+      SetStreamingStoreThreshold(0);
+      ASSERT_EQ(result, expected) << "n " << n << " offset " << offset;
+
+      EltwiseAddMod(expected.data() + offset, op1.data(), op2[0], n, modulus);
+      SetStreamingStoreThreshold(1);
+      EltwiseAddMod(result.data() + offset, op1.data(), op2[0], n, modulus);
+      SetStreamingStoreThreshold(0);
+      ASSERT_EQ(result, expected) << "n " << n << " offset " << offset;
+    }
+  }
+}
+
 }  // namespace hexl
 }  // namespace intel
@@ -12,6 +12,7 @@
 #include "hexl/eltwise/eltwise-cmp-add.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
 #include "test-util.hpp"
 
 namespace intel {
@@ -117,5 +118,23 @@ TEST(EltwiseCmpAdd, AVX512) {
 }
 #endif
 
+#ifdef HEXL_HAS_AVX512DQ
+TEST(EltwiseCmpAdd, avx512_unaligned_tail) {
+  // The comparison depends on n, the bound and difference on op2
+  CheckUnalignedTail(
+      100,
+      [](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+         uint64_t n) {
+        EltwiseCmpAddNative(result, op1, n, static_cast<CMPINT>(n % 8),
+                            op2[0], op2[1] + 1);
+      },
+      [](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+         uint64_t n) {
+        EltwiseCmpAddAVX512(result, op1, n, static_cast<CMPINT>(n % 8),
+                            op2[0], op2[1] + 1);
+      });
+}
+#endif
+
 }  // namespace hexl
 }  // namespace intel
@@ -12,6 +12,7 @@
 #include "hexl/eltwise/eltwise-cmp-sub-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
 #include "test-util.hpp"
 
 namespace intel {
@@ -132,5 +133,27 @@ TEST(EltwiseCmpSubMod, AVX512) {
   }
 }
 #endif
+
+#ifdef HEXL_HAS_AVX512DQ
+TEST(EltwiseCmpSubMod, avx512_unaligned_tail) {
+  uint64_t modulus = GeneratePrimes(1, 50, 1024)[0];
+  // The comparison depends on n, the bound and difference on op2
+  CheckUnalignedTail(
+      modulus - 1,
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseCmpSubModNative(result, op1, n, modulus,
+                               static_cast<CMPINT>(n % 8), op2[0],
+                               op2[1] % (modulus - 1) + 1);
+      },
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseCmpSubModAVX512(result, op1, n, modulus,
+                               static_cast<CMPINT>(n % 8), op2[0],
+                               op2[1] % (modulus - 1) + 1);
+      });
+}
+#endif
+
 }  // namespace hexl
 }  // namespace intel
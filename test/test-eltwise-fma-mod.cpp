@@ -12,7 +12,10 @@
 #include "hexl/eltwise/eltwise-fma-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/isa-tier.hpp"
 #include "test-util.hpp"
+#include "util/cpu-features.hpp"
 
 namespace intel {
 namespace hexl {
@@ -309,5 +312,133 @@ TEST(EltwiseFMAMod, AVX512) {
 }
 #endif
 
+// Checks output_mod_factor == 2 results are in [0, 2 * modulus) and congruent
+// to the fully reduced results, for each kernel this machine supports
+TEST(EltwiseFMAMod, OutputModFactor) {
+  uint64_t n = 1031;
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  for (ISATier tier :
+       {ISATier::Native, ISATier::AVX512DQ, ISATier::AVX512IFMA}) {
+    ScopedMaxISATier max_tier(tier);
+    for (size_t modulus_bits : {20, 30, 48, 60}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, 1024)[0];
+      for (uint64_t input_mod_factor : {1, 2, 4, 8}) {
+        std::uniform_int_distribution<uint64_t> distrib(
+            0, input_mod_factor * modulus - 1);
+        std::vector<uint64_t> arg1(n);
+        std::vector<uint64_t> arg3(n);
+        for (size_t i = 0; i < n; ++i) {
+          arg1[i] = distrib(gen);
+          arg3[i] = distrib(gen);
+        }
+        uint64_t arg2 = distrib(gen);
+        for (bool use_arg3 : {true, false}) {
+          const uint64_t* add = use_arg3 ? arg3.data() : nullptr;
+          std::vector<uint64_t> expected(n);
+          std::vector<uint64_t> result(n);
+          EltwiseFMAMod(expected.data(), arg1.data(), arg2, add, n, modulus,
+                        input_mod_factor);
+          EltwiseFMAMod(result.data(), arg1.data(), arg2, add, n, modulus,
+                        input_mod_factor, 2);
+          for (size_t i = 0; i < n; ++i) {
+            ASSERT_LT(result[i], 2 * modulus);
+            ASSERT_EQ(result[i] % modulus, expected[i])
+                << "tier " << ISATierName(tier) << " modulus " << modulus
+                << " input_mod_factor " << input_mod_factor;
+          }
+
+          GetEltwiseFMAModKernel(modulus, input_mod_factor, 2)(
+              result.data(), arg1.data(), arg2, add, n, modulus);
+          for (size_t i = 0; i < n; ++i) {
+            ASSERT_LT(result[i], 2 * modulus);
+            ASSERT_EQ(result[i] % modulus, expected[i]);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(EltwiseFMAMod, SelectedKernel) {
+  KernelVariant small_kernel = EltwiseFMAModKernel((1ULL << 40) + 1, 8);
+  KernelVariant large_kernel = EltwiseFMAModKernel((1ULL << 50) + 1, 8);
+  if (has_avx512ifma) {
+    EXPECT_EQ(small_kernel, KernelVariant::AVX512IFMA);
+  } else if (has_avx512dq) {
+    EXPECT_EQ(small_kernel, KernelVariant::AVX512DQ64);
+  } else {
+    EXPECT_EQ(small_kernel, KernelVariant::Native);
+  }
+  EXPECT_EQ(large_kernel,
+            has_avx512dq ? KernelVariant::AVX512DQ64 : KernelVariant::Native);
+}
+
+TEST(EltwiseFMAMod, GetKernel) {
+  uint64_t n = 1031;
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  for (size_t modulus_bits : {30, 48, 60}) {
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, 1024)[0];
+    for (uint64_t input_mod_factor : {1, 2, 4, 8}) {
+      std::uniform_int_distribution<uint64_t> distrib(
+          0, input_mod_factor * modulus - 1);
+      std::vector<uint64_t> arg1(n);
+      std::vector<uint64_t> arg3(n);
+      for (size_t i = 0; i < n; ++i) {
+        arg1[i] = distrib(gen);
+        arg3[i] = distrib(gen);
+      }
+      uint64_t arg2 = distrib(gen);
+      std::vector<uint64_t> expected(n);
+      std::vector<uint64_t> result(n);
+      EltwiseFMAMod(expected.data(), arg1.data(), arg2, arg3.data(), n,
+                    modulus, input_mod_factor);
+
+      EltwiseFMAModFnPtr kernel =
+          GetEltwiseFMAModKernel(modulus, input_mod_factor);
+      kernel(result.data(), arg1.data(), arg2, arg3.data(), n, modulus);
+      CheckEqual(result, expected);
+    }
+  }
+}
+
+#ifdef HEXL_HAS_AVX512DQ
+TEST(EltwiseFMAMod, avx512_unaligned_tail) {
+  uint64_t modulus = GeneratePrimes(1, 50, 1024)[0];
+  for (bool use_arg3 : {true, false}) {
+    // arg1 is op1, arg2 is op1[0] and arg3 is op2, if used
+    CheckUnalignedTail(
+        modulus - 1,
+        [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+            uint64_t n) {
+          EltwiseFMAModNative<1>(result, op1, op1[0],
+                                 use_arg3 ? op2 : nullptr, n, modulus);
+        },
+        [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+            uint64_t n) {
+          EltwiseFMAModAVX512<64, 1>(result, op1, op1[0],
+                                     use_arg3 ? op2 : nullptr, n, modulus);
+        });
+#ifdef HEXL_HAS_AVX512IFMA
+    if (has_avx512ifma) {
+      CheckUnalignedTail(
+          modulus - 1,
+          [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+              uint64_t n) {
+            EltwiseFMAModNative<1>(result, op1, op1[0],
+                                   use_arg3 ? op2 : nullptr, n, modulus);
+          },
+          [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+              uint64_t n) {
+            EltwiseFMAModAVX512<52, 1>(result, op1, op1[0],
+                                       use_arg3 ? op2 : nullptr, n, modulus);
+          });
+    }
+#endif
+  }
+}
+#endif
+
 }  // namespace hexl
 }  // namespace intel
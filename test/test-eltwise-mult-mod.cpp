@@ -12,7 +12,11 @@
 #include "hexl/eltwise/eltwise-mult-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/isa-tier.hpp"
+#include "hexl/util/streaming-stores.hpp"
 #include "test-util.hpp"
+#include "util/cpu-features.hpp"
 
 namespace intel {
 namespace hexl {
@@ -384,5 +388,245 @@ TEST(EltwiseMultMod, AVX512Big) {
   }
 }
 #endif
+
+#ifdef HEXL_HAS_AVX512IFMA
+TEST(EltwiseMultMod, avx512_ifma_small) {
+  if (!has_avx512ifma) {
+    GTEST_SKIP();
+  }
+  std::vector<uint64_t> op1{1, 2, 3, 1, 1, 1, 0, 1, 0};
+  std::vector<uint64_t> op2{1, 1, 1, 1, 2, 3, 1, 0, 0};
+  std::vector<uint64_t> result{0, 0, 0, 0, 0, 0, 0, 0, 0};
+  std::vector<uint64_t> exp_out{1, 2, 3, 1, 2, 3, 0, 0, 0};
+
+  uint64_t modulus = 769;
+  EltwiseMultModAVX512IFMA<1>(result.data(), op1.data(), op2.data(),
+                              op1.size(), modulus);
+
+  CheckEqual(result, exp_out);
+}
+
+// Checks AVX512IFMA and native eltwise mult implementations match for every
+// modulus bit-width the IFMA kernel supports
+TEST(EltwiseMultMod, AVX512IFMABig) {
+  if (!has_avx512ifma) {
+    GTEST_SKIP();
+  }
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  uint64_t length = 1031;
+  std::vector<uint64_t> op1(length, 0);
+  std::vector<uint64_t> op2(length, 0);
+  std::vector<uint64_t> expected(length, 0);
+  std::vector<uint64_t> result(length, 0);
+
+  for (size_t bits = 1; bits < 50; ++bits) {
+    for (uint64_t modulus : {(1ULL << bits) + 7, (1ULL << (bits + 1)) - 1}) {
+      for (uint64_t input_mod_factor : {1, 2, 4}) {
+        std::uniform_int_distribution<uint64_t> distrib(
+            0, input_mod_factor * modulus - 1);
+        for (size_t i = 0; i < length; ++i) {
+          op1[i] = distrib(gen);
+          op2[i] = distrib(gen);
+        }
+        op1[length - 1] = input_mod_factor * modulus - 1;
+        op2[length - 1] = input_mod_factor * modulus - 1;
+
+        switch (input_mod_factor) {
+          case 1:
+            EltwiseMultModNative<1>(expected.data(), op1.data(), op2.data(),
+                                    length, modulus);
+            EltwiseMultModAVX512IFMA<1>(result.data(), op1.data(), op2.data(),
+                                        length, modulus);
+            break;
+          case 2:
+            EltwiseMultModNative<2>(expected.data(), op1.data(), op2.data(),
+                                    length, modulus);
+            EltwiseMultModAVX512IFMA<2>(result.data(), op1.data(), op2.data(),
+                                        length, modulus);
+            break;
+          case 4:
+            EltwiseMultModNative<4>(expected.data(), op1.data(), op2.data(),
+                                    length, modulus);
+            EltwiseMultModAVX512IFMA<4>(result.data(), op1.data(), op2.data(),
+                                        length, modulus);
+            break;
+        }
+        ASSERT_EQ(result, expected) << "modulus " << modulus
+                                    << " input_mod_factor "
+                                    << input_mod_factor;
+      }
+    }
+  }
+}
+#endif
+
+// Checks output_mod_factor == 2 results are in [0, 2 * modulus) and congruent
+// to the fully reduced results, for each kernel this machine supports
+TEST(EltwiseMultMod, OutputModFactor) {
+  uint64_t n = 1031;
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  for (ISATier tier :
+       {ISATier::Native, ISATier::AVX512DQ, ISATier::AVX512IFMA}) {
+    ScopedMaxISATier max_tier(tier);
+    for (size_t modulus_bits : {20, 30, 49, 52, 60}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, 1024)[0];
+      for (uint64_t input_mod_factor : {1, 2, 4}) {
+        if (input_mod_factor * modulus >= (1ULL << 63)) {
+          continue;
+        }
+        std::uniform_int_distribution<uint64_t> distrib(
+            0, input_mod_factor * modulus - 1);
+        std::vector<uint64_t> op1(n);
+        std::vector<uint64_t> op2(n);
+        for (size_t i = 0; i < n; ++i) {
+          op1[i] = distrib(gen);
+          op2[i] = distrib(gen);
+        }
+        std::vector<uint64_t> expected(n);
+        std::vector<uint64_t> result(n);
+        EltwiseMultMod(expected.data(), op1.data(), op2.data(), n, modulus,
+                       input_mod_factor);
+        EltwiseMultMod(result.data(), op1.data(), op2.data(), n, modulus,
+                       input_mod_factor, 2);
+        for (size_t i = 0; i < n; ++i) {
+          ASSERT_LT(result[i], 2 * modulus);
+          ASSERT_EQ(result[i] % modulus, expected[i])
+              << "tier " << ISATierName(tier) << " modulus " << modulus
+              << " input_mod_factor " << input_mod_factor;
+        }
+
+        GetEltwiseMultModKernel(modulus, input_mod_factor, 2)(
+            result.data(), op1.data(), op2.data(), n, modulus);
+        for (size_t i = 0; i < n; ++i) {
+          ASSERT_LT(result[i], 2 * modulus);
+          ASSERT_EQ(result[i] % modulus, expected[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST(EltwiseMultMod, SelectedKernel) {
+  KernelVariant small_kernel = EltwiseMultModKernel((1ULL << 30) + 1, 1);
+  KernelVariant large_kernel = EltwiseMultModKernel((1ULL << 60) + 1, 2);
+  if (has_avx512ifma) {
+    EXPECT_EQ(small_kernel, KernelVariant::AVX512IFMA);
+    EXPECT_EQ(large_kernel, KernelVariant::AVX512DQ64);
+  } else if (has_avx512dq) {
+    EXPECT_EQ(small_kernel, KernelVariant::AVX512Float);
+    EXPECT_EQ(large_kernel, KernelVariant::AVX512DQ64);
+  } else {
+    EXPECT_EQ(small_kernel, KernelVariant::Native);
+    EXPECT_EQ(large_kernel, KernelVariant::Native);
+  }
+}
+
+TEST(EltwiseMultMod, GetKernel) {
+  uint64_t n = 1031;
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  for (size_t modulus_bits : {30, 49, 60}) {
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, 1024)[0];
+    for (uint64_t input_mod_factor : {1, 2, 4}) {
+      std::uniform_int_distribution<uint64_t> distrib(
+          0, input_mod_factor * modulus - 1);
+      std::vector<uint64_t> op1(n);
+      std::vector<uint64_t> op2(n);
+      for (size_t i = 0; i < n; ++i) {
+        op1[i] = distrib(gen);
+        op2[i] = distrib(gen);
+      }
+      std::vector<uint64_t> expected(n);
+      std::vector<uint64_t> result(n);
+      EltwiseMultMod(expected.data(), op1.data(), op2.data(), n, modulus,
+                     input_mod_factor);
+
+      EltwiseMultModFnPtr kernel =
+          GetEltwiseMultModKernel(modulus, input_mod_factor);
+      kernel(result.data(), op1.data(), op2.data(), n, modulus);
+      CheckEqual(result, expected);
+    }
+  }
+
+  EltwiseMultModFnPtr native_kernel = GetEltwiseMultModKernel(1ULL << 60, 2);
+  if (!has_avx512dq) {
+    EXPECT_EQ(native_kernel, &EltwiseMultModNative<2>);
+  }
+}
+
+#ifdef HEXL_HAS_AVX512DQ
+TEST(EltwiseMultMod, avx512_unaligned_tail) {
+  for (size_t modulus_bits : {30, 49, 55, 60}) {
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, 1024)[0];
+    auto native = [=](uint64_t* result, const uint64_t* op1,
+                      const uint64_t* op2, uint64_t n) {
+      EltwiseMultModNative<1>(result, op1, op2, n, modulus);
+    };
+    if (modulus_bits < 50) {
+      CheckUnalignedTail(modulus - 1, native,
+                         [=](uint64_t* result, const uint64_t* op1,
+                             const uint64_t* op2, uint64_t n) {
+                           EltwiseMultModAVX512Float<1>(result, op1, op2, n,
+                                                        modulus);
+                         });
+    } else {
+      CheckUnalignedTail(modulus - 1, native,
+                         [=](uint64_t* result, const uint64_t* op1,
+                             const uint64_t* op2, uint64_t n) {
+                           EltwiseMultModAVX512Int<1>(result, op1, op2, n,
+                                                      modulus);
+                         });
+    }
+#ifdef HEXL_HAS_AVX512IFMA
+    if (has_avx512ifma && modulus_bits < 50) {
+      CheckUnalignedTail(modulus - 1, native,
+                         [=](uint64_t* result, const uint64_t* op1,
+                             const uint64_t* op2, uint64_t n) {
+                           EltwiseMultModAVX512IFMA<1>(result, op1, op2, n,
+                                                       modulus);
+                         });
+    }
+#endif
+  }
+}
+#endif
+
+// Checks results with streaming stores enabled match those with regular
+// stores, for aligned and unaligned results and each kernel this machine
+// supports
+TEST(EltwiseMultMod, StreamingStores) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  for (size_t modulus_bits : {30, 49, 55, 60}) {
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, 1024)[0];
+    std::uniform_int_distribution<uint64_t> distrib(0, modulus - 1);
+    for (size_t n : {1, 9, 1031, 4096}) {
+      AlignedVector64<uint64_t> op1(n, 0);
+      AlignedVector64<uint64_t> op2(n, 0);
+      for (size_t i = 0; i < n; ++i) {
+        op1[i] = distrib(gen);
+        op2[i] = distrib(gen);
+      }
+      for (size_t offset : {0, 1}) {
+        AlignedVector64<uint64_t> expected(n + offset, 0);
+        AlignedVector64<uint64_t> result(n + offset, 0);
+        EltwiseMultMod(expected.data() + offset, op1.data(), op2.data(), n,
+                       modulus, 1);
+
+        SetStreamingStoreThreshold(1);
+        EltwiseMultMod(result.data() + offset, op1.data(), op2.data(), n,
+                       modulus, 1);
+        SetStreamingStoreThreshold(0);
+        ASSERT_EQ(result, expected)
+            << "modulus " << modulus << " n " << n << " offset " << offset;
+      }
+    }
+  }
+}
+
 }  // namespace hexl
 }  // namespace intel
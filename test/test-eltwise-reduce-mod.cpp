@@ -12,6 +12,7 @@
 #include "hexl/eltwise/eltwise-reduce-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
 #include "test-util.hpp"
 
 namespace intel {
@@ -278,5 +279,32 @@ TEST(EltwiseReduceMod, AVX512Big_2_1) {
 }
 #endif
 
+#ifdef HEXL_HAS_AVX512DQ
+TEST(EltwiseReduceMod, avx512_unaligned_tail) {
+  uint64_t modulus = GeneratePrimes(1, 50, 1024)[0];
+  for (uint64_t input_mod_factor : {0, 2, 4}) {
+    for (uint64_t output_mod_factor : {1, 2}) {
+      if (input_mod_factor == output_mod_factor) {
+        continue;
+      }
+      uint64_t max_input =
+          input_mod_factor == 0 ? ~0ULL : input_mod_factor * modulus - 1;
+      CheckUnalignedTail(
+          max_input,
+          [=](uint64_t* result, const uint64_t* op1, const uint64_t*,
+              uint64_t n) {
+            EltwiseReduceModNative(result, op1, n, modulus, input_mod_factor,
+                                   output_mod_factor);
+          },
+          [=](uint64_t* result, const uint64_t* op1, const uint64_t*,
+              uint64_t n) {
+            EltwiseReduceModAVX512(result, op1, n, modulus, input_mod_factor,
+                                   output_mod_factor);
+          });
+    }
+  }
+}
+#endif
+
 }  // namespace hexl
 }  // namespace intel
@@ -12,6 +12,7 @@
 #include "hexl/eltwise/eltwise-sub-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
 #include "test-util.hpp"
 
 namespace intel {
@@ -238,5 +239,31 @@ TEST(EltwiseSubMod, vector_scalar_avx512_native_match) {
 }
 #endif
 
+#ifdef HEXL_HAS_AVX512DQ
+TEST(EltwiseSubMod, avx512_unaligned_tail) {
+  uint64_t modulus = GeneratePrimes(1, 50, 1024)[0];
+  CheckUnalignedTail(
+      modulus - 1,
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseSubModNative(result, op1, op2, n, modulus);
+      },
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseSubModAVX512(result, op1, op2, n, modulus);
+      });
+  CheckUnalignedTail(
+      modulus - 1,
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseSubModNative(result, op1, op2[0], n, modulus);
+      },
+      [=](uint64_t* result, const uint64_t* op1, const uint64_t* op2,
+          uint64_t n) {
+        EltwiseSubModAVX512(result, op1, op2[0], n, modulus);
+      });
+}
+#endif
+
 }  // namespace hexl
 }  // namespace intel
@@ -0,0 +1,75 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hexl/ntt/ntt.hpp"
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/huge-page-allocator.hpp"
+#include "test-util.hpp"
+
+namespace intel {
+namespace hexl {
+
+TEST(HugePageAllocator, alloc) {
+  const size_t page = HugePageAllocator::s_huge_page_size;
+  HugePageAllocator alloc(4096);
+  for (size_t bytes : {size_t(0), size_t(1), size_t(100), size_t(4096),
+                       page / 2, page + 1, page, 15 * page / 2}) {
+    void* p = alloc.allocate(bytes);
+    if (bytes > 0) {
+      ASSERT_NE(p, nullptr);
+      std::memset(p, 0xff, bytes);
+    }
+    alloc.deallocate(p, bytes);
+  }
+#ifdef __linux__
+  // Allocations of at least min_bytes are mapped
+  ASSERT_EQ(alloc.NumHugeTLBMappings() + alloc.NumAdvisedMappings(), 5);
+  // Mappings are page-aligned
+  void* p = alloc.allocate(page);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 4096, 0);
+  alloc.deallocate(p, page);
+#endif
+}
+
+#ifdef __linux__
+// Rounding up to whole huge pages is limited to 1/8 of the mapping
+TEST(HugePageAllocator, rounding_waste) {
+  const size_t page = HugePageAllocator::s_huge_page_size;
+  HugePageAllocator alloc;
+  for (size_t bytes : {page / 2, page + 1, 2 * page + 72}) {
+    void* p = alloc.allocate(bytes);
+    std::memset(p, 0xff, bytes);
+    alloc.deallocate(p, bytes);
+  }
+  // The first allocation is below the default min_bytes of one huge page
+  ASSERT_EQ(alloc.NumHugeTLBMappings(), 0);
+  ASSERT_EQ(alloc.NumAdvisedMappings(), 2);
+}
+#endif
+
+TEST(HugePageAllocator, NTT) {
+  uint64_t N = 1ULL << 14;
+  uint64_t modulus = GeneratePrimes(1, 50, N)[0];
+  auto alloc = std::make_shared<HugePageAllocator>();
+  AlignedAllocator<uint64_t, 64> aligned_alloc(alloc);
+
+  AlignedVector64<uint64_t> input(N, 0, aligned_alloc);
+  for (size_t i = 0; i < N; ++i) {
+    input[i] = i;
+  }
+  std::vector<uint64_t> expected(input.begin(), input.end());
+  NTT(N, modulus).ComputeForward(expected.data(), expected.data(), 1, 1);
+
+  NTT ntt(N, modulus, alloc);
+  ntt.ComputeForward(input.data(), input.data(), 1, 1);
+  ASSERT_EQ(std::vector<uint64_t>(input.begin(), input.end()), expected);
+}
+
+}  // namespace hexl
+}  // namespace intel
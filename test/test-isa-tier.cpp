@@ -0,0 +1,104 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "hexl/eltwise/eltwise-mult-mod.hpp"
+#include "hexl/ntt/ntt.hpp"
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/isa-tier.hpp"
+#include "util/cpu-features.hpp"
+
+namespace intel {
+namespace hexl {
+
+TEST(ISATier, Detected) {
+  ISATier detected = DetectedISATier();
+  EXPECT_EQ(GetMaxISATier(), ISATier::AVX512IFMA);
+  if (has_avx512dq) {
+    EXPECT_GE(detected, ISATier::AVX512DQ);
+  }
+  EXPECT_STREQ(ISATierName(ISATier::AVX2), "AVX2");
+}
+
+TEST(ISATier, SetMaxISATier) {
+  uint64_t N = 1024;
+  uint64_t modulus = GeneratePrimes(1, 50, N)[0];
+  NTT ntt(N, modulus);
+  KernelVariant default_fwd = ntt.SelectedForwardKernel();
+
+  SetMaxISATier(ISATier::Native);
+  EXPECT_EQ(GetMaxISATier(), ISATier::Native);
+  EXPECT_EQ(ntt.SelectedForwardKernel(), KernelVariant::Native);
+  EXPECT_EQ(ntt.SelectedInverseKernel(), KernelVariant::Native);
+  EXPECT_EQ(EltwiseMultModKernel(modulus, 1), KernelVariant::Native);
+
+  // Other threads use the global setting too
+  KernelVariant thread_fwd = default_fwd;
+  std::thread thread([&]() { thread_fwd = ntt.SelectedForwardKernel(); });
+  thread.join();
+  EXPECT_EQ(thread_fwd, KernelVariant::Native);
+
+  SetMaxISATier(ISATier::AVX512IFMA);
+  EXPECT_EQ(ntt.SelectedForwardKernel(), default_fwd);
+}
+
+TEST(ISATier, ScopedMaxISATier) {
+  uint64_t N = 1024;
+  uint64_t modulus = GeneratePrimes(1, 40, N)[0];
+  NTT ntt(N, modulus);
+  KernelVariant default_fwd = ntt.SelectedForwardKernel();
+
+  {
+    ScopedMaxISATier max_tier(ISATier::AVX512DQ);
+    KernelVariant expected =
+        has_avx512dq ? KernelVariant::AVX512DQ64 : KernelVariant::Native;
+    EXPECT_EQ(ntt.SelectedForwardKernel(), expected);
+    {
+      ScopedMaxISATier native_only(ISATier::Native);
+      EXPECT_EQ(ntt.SelectedForwardKernel(), KernelVariant::Native);
+
+      // Other threads are unaffected
+      KernelVariant thread_fwd = KernelVariant::Native;
+      std::thread thread([&]() { thread_fwd = ntt.SelectedForwardKernel(); });
+      thread.join();
+      EXPECT_EQ(thread_fwd, default_fwd);
+    }
+    EXPECT_EQ(ntt.SelectedForwardKernel(), expected);
+  }
+  EXPECT_EQ(ntt.SelectedForwardKernel(), default_fwd);
+}
+
+// Every tier computes the same transform
+TEST(ISATier, NTTAgrees) {
+  uint64_t N = 512;
+  for (size_t modulus_bits : {30, 50, 60}) {
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+    NTT ntt(N, modulus);
+    std::vector<uint64_t> input(N);
+    for (size_t i = 0; i < N; ++i) {
+      input[i] = (i * i + 3) % modulus;
+    }
+
+    std::vector<uint64_t> expected(N);
+    {
+      ScopedMaxISATier native_only(ISATier::Native);
+      ntt.ComputeForward(expected.data(), input.data(), 1, 1);
+    }
+    for (ISATier tier :
+         {ISATier::AVX2, ISATier::AVX512DQ, ISATier::AVX512IFMA}) {
+      ScopedMaxISATier max_tier(tier);
+      std::vector<uint64_t> output(N);
+      ntt.ComputeForward(output.data(), input.data(), 1, 1);
+      EXPECT_EQ(output, expected);
+      ntt.ComputeInverse(output.data(), output.data(), 1, 1);
+      EXPECT_EQ(output, input);
+    }
+  }
+}
+
+}  // namespace hexl
+}  // namespace intel
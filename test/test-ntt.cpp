@@ -8,6 +8,7 @@
 #include <tuple>
 #include <vector>
 
+#include "hexl/eltwise/eltwise-mult-mod.hpp"
 #include "hexl/logging/logging.hpp"
 #include "hexl/ntt/ntt.hpp"
 #include "hexl/number-theory/number-theory.hpp"
@@ -17,6 +18,7 @@
 #include "ntt/ntt-internal.hpp"
 #include "test-util.hpp"
 #include "util/cpu-features.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
@@ -68,6 +70,18 @@ TEST(NTT, bad_input) {
   EXPECT_ANY_THROW(ntt.ComputeForward(input.data(), input.data(), 2, 123));
   init_inputs();
 
+  // Bad multiplicand
+  std::vector<uint64_t> result(N);
+  EXPECT_NO_THROW(
+      ntt.ComputeForwardMultiply(result.data(), input.data(), input.data(), 1));
+  EXPECT_ANY_THROW(
+      ntt.ComputeForwardMultiply(result.data(), input.data(), nullptr, 1));
+  EXPECT_ANY_THROW(ntt.ComputeForwardMultiply(input.data(), p_input.data(),
+                                              input.data(), 2));
+  EXPECT_ANY_THROW(ntt.ComputeForwardMultiply(result.data(), input.data(),
+                                              p_input.data(), 1));
+  init_inputs();
+
   // Inverse tranform
 
   // Bad input
@@ -93,6 +107,14 @@ TEST(NTT, bad_input) {
   init_inputs();
   EXPECT_ANY_THROW(ntt.ComputeInverse(input.data(), input.data(), 1, 123));
   init_inputs();
+
+  // Bad scalar
+  EXPECT_NO_THROW(
+      ntt.ComputeInverse(input.data(), input.data(), 1, 1, modulus - 1));
+  init_inputs();
+  EXPECT_ANY_THROW(
+      ntt.ComputeInverse(input.data(), input.data(), 1, 1, modulus));
+  init_inputs();
 }
 #endif
 
@@ -486,6 +508,8 @@ INSTANTIATE_TEST_SUITE_P(NTTModulusTest, NTTModulusTest,
 #endif
 
 #ifdef HEXL_HAS_AVX512DQ
+HEXL_BEGIN_TARGET_AVX512
+
 TEST(NTT, LoadFwdInterleavedT1) {
   std::vector<uint64_t> arg{0, 1, 2,  3,  4,  5,  6,  7,
                             8, 9, 10, 11, 12, 13, 14, 15};
@@ -600,6 +624,8 @@ TEST(NTT, WriteInvInterleavedT4) {
   AssertEqual(exp, out);
 }
 
+HEXL_END_TARGET
+
 // Checks AVX512 and native forward NTT implementations match
 TEST(NTT, FwdNTT_AVX512_32) {
   if (!has_avx512dq) {
@@ -807,7 +833,454 @@ TEST(NTT, InvNTT_AVX512_64) {
     }
   }
 }
+
+// Checks the recursive AVX512 transforms match the native transforms for each
+// prefetch distance
+TEST(NTT, AVX512_PrefetchDistance) {
+  if (!has_avx512dq) {
+    return;
+  }
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  for (size_t N : {2048, 16384}) {
+    for (size_t modulus_bits : {27, 49, 55, 60}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+      std::uniform_int_distribution<uint64_t> distrib(0, modulus - 1);
+      NTT ntt(N, modulus);
+
+      std::vector<uint64_t> input(N);
+      for (auto& elem : input) {
+        elem = distrib(gen);
+      }
+      std::vector<uint64_t> exp_fwd = input;
+      ForwardTransformToBitReverse64(
+          exp_fwd.data(), N, modulus, ntt.GetRootOfUnityPowers().data(),
+          ntt.GetPrecon64RootOfUnityPowers().data(), 1, 1);
+      std::vector<uint64_t> exp_inv = input;
+      InverseTransformFromBitReverse64(
+          exp_inv.data(), N, modulus, ntt.GetInvRootOfUnityPowers().data(),
+          ntt.GetPrecon64InvRootOfUnityPowers().data(), 1, 1);
+
+      for (uint64_t prefetch_distance : {0, 1, 8, 64}) {
+        NTT::SetPrefetchDistance(prefetch_distance);
+        std::vector<uint64_t> out(N);
+        ntt.ComputeForward(out.data(), input.data(), 1, 1);
+        ASSERT_EQ(out, exp_fwd) << "prefetch_distance " << prefetch_distance;
+        ntt.ComputeInverse(out.data(), input.data(), 1, 1);
+        ASSERT_EQ(out, exp_inv) << "prefetch_distance " << prefetch_distance;
+      }
+    }
+  }
+  NTT::SetPrefetchDistance(NTT::s_default_prefetch_distance);
+}
+
+// Checks single AVX512 butterfly stages against the butterfly definitions
+TEST(NTT, AVX512_Stages) {
+  if (!has_avx512dq) {
+    return;
+  }
+  uint64_t N = 1024;
+  uint64_t modulus = GeneratePrimes(1, 55, N)[0];
+  NTT ntt(N, modulus);
+  const auto& W_fwd = ntt.GetAVX512RootOfUnityPowers();
+  const auto& W_inv = ntt.GetInvRootOfUnityPowers();
+
+  std::vector<uint64_t> input(N);
+  for (size_t i = 0; i < N; ++i) {
+    input[i] = (i * 0x9E3779B97F4A7C15ULL) % (2 * modulus);
+  }
+
+  for (uint64_t t = 8; t <= N / 2; t *= 2) {
+    uint64_t m = N / (2 * t);
+    for (uint64_t prefetch_distance : {0, 8}) {
+      std::vector<uint64_t> fwd = input;
+      ForwardTransformStageAVX512<64>(
+          fwd.data(), N, modulus, W_fwd.data(),
+          ntt.GetAVX512Precon64RootOfUnityPowers().data(), t, 1,
+          prefetch_distance);
+      std::vector<uint64_t> inv = input;
+      if (t <= N / 4) {
+        InverseTransformStageAVX512<64>(
+            inv.data(), N, modulus, W_inv.data(),
+            ntt.GetPrecon64InvRootOfUnityPowers().data(), t, 1,
+            prefetch_distance);
+      }
+
+      for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 2 * i * t; j < 2 * i * t + t; ++j) {
+          uint64_t X = input[j] % modulus;
+          uint64_t Y = input[j + t] % modulus;
+
+          // X + WY, X - WY
+          uint64_t WY = MultiplyMod(W_fwd[m + i], Y, modulus);
+          ASSERT_LT(fwd[j], 4 * modulus);
+          ASSERT_LT(fwd[j + t], 4 * modulus);
+          ASSERT_EQ(fwd[j] % modulus, AddUIntMod(X, WY, modulus));
+          ASSERT_EQ(fwd[j + t] % modulus, SubUIntMod(X, WY, modulus));
+
+          // X + Y, W(X - Y)
+          if (t <= N / 4) {
+            uint64_t W = W_inv[N - 2 * m + 1 + i];
+            ASSERT_LT(inv[j], 2 * modulus);
+            ASSERT_LT(inv[j + t], 2 * modulus);
+            ASSERT_EQ(inv[j] % modulus, AddUIntMod(X, Y, modulus));
+            ASSERT_EQ(inv[j + t] % modulus,
+                      MultiplyMod(W, SubUIntMod(X, Y, modulus), modulus));
+          }
+        }
+      }
+    }
+  }
+}
+
+// Checks merged pairs of AVX512 butterfly stages match the single stages
+TEST(NTT, AVX512_MergedStages) {
+  if (!has_avx512dq) {
+    return;
+  }
+  uint64_t N = 1024;
+  uint64_t modulus = GeneratePrimes(1, 55, N)[0];
+  NTT ntt(N, modulus);
+  const uint64_t* W_fwd = ntt.GetAVX512RootOfUnityPowers().data();
+  const uint64_t* W_fwd_precon =
+      ntt.GetAVX512Precon64RootOfUnityPowers().data();
+  const uint64_t* W_inv = ntt.GetInvRootOfUnityPowers().data();
+  const uint64_t* W_inv_precon = ntt.GetPrecon64InvRootOfUnityPowers().data();
+
+  std::vector<uint64_t> input(N);
+  for (size_t i = 0; i < N; ++i) {
+    input[i] = (i * 0x9E3779B97F4A7C15ULL) % (2 * modulus);
+  }
+
+  for (uint64_t prefetch_distance : {0, 8}) {
+    for (uint64_t t = 16; t <= N / 2; t *= 2) {
+      std::vector<uint64_t> exp = input;
+      ForwardTransformStageAVX512<64>(exp.data(), N, modulus, W_fwd,
+                                      W_fwd_precon, t, 1, 0);
+      ForwardTransformStageAVX512<64>(exp.data(), N, modulus, W_fwd,
+                                      W_fwd_precon, t / 2, 1, 0);
+      std::vector<uint64_t> out = input;
+      ForwardTransformStageAVX512<64>(out.data(), N, modulus, W_fwd,
+                                      W_fwd_precon, t, 2, prefetch_distance);
+      ASSERT_EQ(out, exp) << "t " << t;
+    }
+
+    for (uint64_t t = 8; t <= N / 8; t *= 2) {
+      std::vector<uint64_t> exp = input;
+      InverseTransformStageAVX512<64>(exp.data(), N, modulus, W_inv,
+                                      W_inv_precon, t, 1, 0);
+      InverseTransformStageAVX512<64>(exp.data(), N, modulus, W_inv,
+                                      W_inv_precon, 2 * t, 1, 0);
+      std::vector<uint64_t> out = input;
+      InverseTransformStageAVX512<64>(out.data(), N, modulus, W_inv,
+                                      W_inv_precon, t, 2, prefetch_distance);
+      ASSERT_EQ(out, exp) << "t " << t;
+    }
+  }
+}
+
+// Checks the four-step AVX512 transforms match the recursive AVX512 transforms
+// for each number of rows
+TEST(NTT, AVX512_FourStep) {
+  if (!has_avx512dq) {
+    return;
+  }
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  for (size_t N : {32, 2048, 16384}) {
+    for (size_t modulus_bits : {27, 49, 60}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+      std::uniform_int_distribution<uint64_t> distrib(0, modulus - 1);
+      NTT ntt(N, modulus);
+      const uint64_t* W_fwd = ntt.GetAVX512RootOfUnityPowers().data();
+      const uint64_t* W_inv = ntt.GetInvRootOfUnityPowers().data();
+
+      std::vector<uint64_t> input(N);
+      for (auto& elem : input) {
+        elem = distrib(gen);
+      }
+
+      for (uint64_t num_rows = 2; num_rows <= N / 16; num_rows *= 2) {
+        std::vector<uint64_t> exp_fwd = input;
+        std::vector<uint64_t> out_fwd = input;
+        std::vector<uint64_t> exp_inv = input;
+        std::vector<uint64_t> out_inv = input;
+        if (modulus_bits == 27) {
+          const uint64_t* W_fwd_precon =
+              ntt.GetAVX512Precon32RootOfUnityPowers().data();
+          const uint64_t* W_inv_precon =
+              ntt.GetPrecon32InvRootOfUnityPowers().data();
+          ForwardTransformToBitReverseAVX512<32>(
+              exp_fwd.data(), N, modulus, W_fwd, W_fwd_precon, 1, 1);
+          ForwardTransformToBitReverseFourStepAVX512<32>(
+              out_fwd.data(), N, modulus, W_fwd, W_fwd_precon, 1, 1, num_rows);
+          InverseTransformFromBitReverseAVX512<32>(
+              exp_inv.data(), N, modulus, W_inv, W_inv_precon, 1, 1);
+          InverseTransformFromBitReverseFourStepAVX512<32>(
+              out_inv.data(), N, modulus, W_inv, W_inv_precon, 1, 1, num_rows);
+        } else if (modulus_bits == 49) {
+#ifdef HEXL_HAS_AVX512IFMA
+          if (!has_avx512ifma) {
+            continue;
+          }
+          const uint64_t* W_fwd_precon =
+              ntt.GetAVX512Precon52RootOfUnityPowers().data();
+          const uint64_t* W_inv_precon =
+              ntt.GetPrecon52InvRootOfUnityPowers().data();
+          ForwardTransformToBitReverseAVX512<52>(
+              exp_fwd.data(), N, modulus, W_fwd, W_fwd_precon, 1, 1);
+          ForwardTransformToBitReverseFourStepAVX512<52>(
+              out_fwd.data(), N, modulus, W_fwd, W_fwd_precon, 1, 1, num_rows);
+          InverseTransformFromBitReverseAVX512<52>(
+              exp_inv.data(), N, modulus, W_inv, W_inv_precon, 1, 1);
+          InverseTransformFromBitReverseFourStepAVX512<52>(
+              out_inv.data(), N, modulus, W_inv, W_inv_precon, 1, 1, num_rows);
+#endif
+        } else {
+          const uint64_t* W_fwd_precon =
+              ntt.GetAVX512Precon64RootOfUnityPowers().data();
+          const uint64_t* W_inv_precon =
+              ntt.GetPrecon64InvRootOfUnityPowers().data();
+          ForwardTransformToBitReverseAVX512<64>(
+              exp_fwd.data(), N, modulus, W_fwd, W_fwd_precon, 1, 1);
+          ForwardTransformToBitReverseFourStepAVX512<64>(
+              out_fwd.data(), N, modulus, W_fwd, W_fwd_precon, 1, 1, num_rows);
+          InverseTransformFromBitReverseAVX512<64>(
+              exp_inv.data(), N, modulus, W_inv, W_inv_precon, 1, 1);
+          InverseTransformFromBitReverseFourStepAVX512<64>(
+              out_inv.data(), N, modulus, W_inv, W_inv_precon, 1, 1, num_rows);
+        }
+        ASSERT_EQ(out_fwd, exp_fwd) << "N " << N << " num_rows " << num_rows;
+        ASSERT_EQ(out_inv, exp_inv) << "N " << N << " num_rows " << num_rows;
+      }
+    }
+  }
+}
+#endif
+
+TEST(NTT, SelectedKernel) {
+  uint64_t N = 1024;
+  for (size_t modulus_bits : {27, 49, 55, 62}) {
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+    NTT ntt(N, modulus);
+
+    KernelVariant expected_fwd = KernelVariant::Native;
+    KernelVariant expected_inv = KernelVariant::Native;
+#ifdef HEXL_HAS_AVX512DQ
+    if (has_avx512dq) {
+      expected_fwd = (modulus < NTT::s_max_fwd_32_modulus)
+                         ? KernelVariant::AVX512DQ32
+                         : KernelVariant::AVX512DQ64;
+      expected_inv = (modulus < NTT::s_max_inv_32_modulus)
+                         ? KernelVariant::AVX512DQ32
+                         : KernelVariant::AVX512DQ64;
+    }
+#endif
+#ifdef HEXL_HAS_AVX512IFMA
+    if (has_avx512ifma && modulus < NTT::s_max_fwd_ifma_modulus) {
+      expected_fwd = KernelVariant::AVX512IFMA;
+    }
+    if (has_avx512ifma && modulus < NTT::s_max_inv_ifma_modulus) {
+      expected_inv = KernelVariant::AVX512IFMA;
+    }
 #endif
+    EXPECT_EQ(ntt.SelectedForwardKernel(), expected_fwd);
+    EXPECT_EQ(ntt.SelectedInverseKernel(), expected_inv);
+  }
+
+  // Small transforms always use the native implementation
+  NTT small_ntt(8, GeneratePrimes(1, 30, 8)[0]);
+  EXPECT_EQ(small_ntt.SelectedForwardKernel(), KernelVariant::Native);
+  EXPECT_EQ(small_ntt.SelectedInverseKernel(), KernelVariant::Native);
+  EXPECT_STREQ(KernelVariantName(KernelVariant::AVX512IFMA), "AVX512IFMA");
+}
+
+TEST(NTT, PrefetchDistance) {
+  uint64_t default_distance = NTT::s_default_prefetch_distance;
+  EXPECT_EQ(NTT::GetPrefetchDistance(), default_distance);
+  NTT::SetPrefetchDistance(0);
+  EXPECT_EQ(NTT::GetPrefetchDistance(), 0ULL);
+  NTT::SetPrefetchDistance(default_distance);
+}
+
+TEST(NTT, Engine) {
+  // Small transforms always use the recursive engine
+  NTT small_ntt(16, GeneratePrimes(1, 30, 16)[0]);
+  EXPECT_EQ(small_ntt.GetEngine(), NTT::Engine::Auto);
+  small_ntt.SetEngine(NTT::Engine::FourStep);
+  EXPECT_EQ(small_ntt.GetEngine(), NTT::Engine::FourStep);
+  EXPECT_EQ(small_ntt.SelectedEngine(), NTT::Engine::Recursive);
+
+  // The engine is set per object
+  NTT other_ntt(16, GeneratePrimes(1, 30, 16)[0]);
+  EXPECT_EQ(other_ntt.GetEngine(), NTT::Engine::Auto);
+
+  // Transforms beyond the cache match the native transforms for each engine
+  uint64_t N = 1ULL << 21;
+  for (size_t modulus_bits : {27, 49, 60}) {
+    uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+    NTT ntt(N, modulus);
+    std::vector<uint64_t> input(N);
+    for (size_t i = 0; i < N; ++i) {
+      input[i] = (i * 0x9E3779B97F4A7C15ULL) % modulus;
+    }
+    std::vector<uint64_t> exp_fwd = input;
+    ForwardTransformToBitReverse64(
+        exp_fwd.data(), N, modulus, ntt.GetRootOfUnityPowers().data(),
+        ntt.GetPrecon64RootOfUnityPowers().data(), 1, 1);
+    std::vector<uint64_t> exp_inv = input;
+    InverseTransformFromBitReverse64(
+        exp_inv.data(), N, modulus, ntt.GetInvRootOfUnityPowers().data(),
+        ntt.GetPrecon64InvRootOfUnityPowers().data(), 1, 1);
+
+    for (NTT::Engine engine : {NTT::Engine::Auto, NTT::Engine::Recursive,
+                               NTT::Engine::FourStep}) {
+      ntt.SetEngine(engine);
+      if (engine != NTT::Engine::Auto &&
+          ntt.SelectedForwardKernel() != KernelVariant::Native) {
+        EXPECT_EQ(ntt.SelectedEngine(), engine);
+      }
+      std::vector<uint64_t> out(N);
+      ntt.ComputeForward(out.data(), input.data(), 1, 1);
+      ASSERT_EQ(out, exp_fwd) << "engine " << static_cast<int>(engine);
+      ntt.ComputeInverse(out.data(), input.data(), 1, 1);
+      ASSERT_EQ(out, exp_inv) << "engine " << static_cast<int>(engine);
+    }
+  }
+}
+
+TEST(NTT, ComputeForwardMultiply) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  for (size_t N : {8, 1024, 4096, 1 << 17}) {
+    for (size_t modulus_bits : {27, 49, 60}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+      std::uniform_int_distribution<uint64_t> distrib(0, modulus - 1);
+      NTT ntt(N, modulus);
+
+      std::vector<uint64_t> input(N);
+      std::vector<uint64_t> multiplicand(N);
+      for (size_t i = 0; i < N; ++i) {
+        input[i] = distrib(gen);
+        multiplicand[i] = distrib(gen);
+      }
+      std::vector<uint64_t> exp(N);
+      ntt.ComputeForward(exp.data(), input.data(), 1, 1);
+      EltwiseMultMod(exp.data(), exp.data(), multiplicand.data(), N, modulus,
+                     1);
+
+      for (NTT::Engine engine :
+           {NTT::Engine::Recursive, NTT::Engine::FourStep}) {
+        ntt.SetEngine(engine);
+        std::vector<uint64_t> out(N);
+        ntt.ComputeForwardMultiply(out.data(), input.data(),
+                                   multiplicand.data(), 1);
+        ASSERT_EQ(out, exp) << "N " << N << " modulus_bits " << modulus_bits;
+
+        // In-place
+        out = input;
+        ntt.ComputeForwardMultiply(out.data(), out.data(), multiplicand.data(),
+                                   1);
+        ASSERT_EQ(out, exp) << "N " << N << " modulus_bits " << modulus_bits;
+      }
+    }
+  }
+}
+
+TEST(NTT, ComputeInverseScalar) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+
+  for (size_t N : {8, 1024, 4096, 1 << 17}) {
+    for (size_t modulus_bits : {27, 49, 60}) {
+      uint64_t modulus = GeneratePrimes(1, modulus_bits, N)[0];
+      std::uniform_int_distribution<uint64_t> distrib(0, modulus - 1);
+      NTT ntt(N, modulus);
+
+      std::vector<uint64_t> input(N);
+      for (size_t i = 0; i < N; ++i) {
+        input[i] = distrib(gen);
+      }
+      for (uint64_t scalar : {uint64_t(0), uint64_t(1), distrib(gen)}) {
+        std::vector<uint64_t> exp(N);
+        ntt.ComputeInverse(exp.data(), input.data(), 1, 1);
+        for (size_t i = 0; i < N; ++i) {
+          exp[i] = MultiplyMod(exp[i], scalar, modulus);
+        }
+
+        for (NTT::Engine engine :
+             {NTT::Engine::Recursive, NTT::Engine::FourStep}) {
+          ntt.SetEngine(engine);
+          std::vector<uint64_t> out(N);
+          ntt.ComputeInverse(out.data(), input.data(), 1, 1, scalar);
+          ASSERT_EQ(out, exp) << "N " << N << " modulus_bits " << modulus_bits;
+
+          // In-place, with lazy output
+          out = input;
+          ntt.ComputeInverse(out.data(), out.data(), 1, 2, scalar);
+          for (size_t i = 0; i < N; ++i) {
+            ASSERT_LT(out[i], 2 * modulus);
+            out[i] %= modulus;
+          }
+          ASSERT_EQ(out, exp) << "N " << N << " modulus_bits " << modulus_bits;
+        }
+      }
+    }
+  }
+}
+
+TEST(NTT, ComputeInvNFactors) {
+  uint64_t n = 8;
+  uint64_t modulus = 769;
+  uint64_t inv_w = 123;
+  for (uint64_t scalar : {1, 2, 768}) {
+    for (uint64_t bit_shift : {32, 52, 64}) {
+      MultiplyFactor inv_n_factors[2];
+      ComputeInvNFactors(n, modulus, inv_w, scalar, bit_shift, inv_n_factors);
+
+      uint64_t inv_n = inv_n_factors[0].Operand();
+      EXPECT_EQ(MultiplyMod(inv_n, n, modulus), scalar);
+      EXPECT_EQ(inv_n_factors[0].BarrettFactor(),
+                MultiplyFactor(inv_n, bit_shift, modulus).BarrettFactor());
+
+      uint64_t inv_n_w = inv_n_factors[1].Operand();
+      EXPECT_EQ(inv_n_w, MultiplyMod(inv_n, inv_w, modulus));
+      EXPECT_EQ(inv_n_factors[1].BarrettFactor(),
+                MultiplyFactor(inv_n_w, bit_shift, modulus).BarrettFactor());
+
+      MultiplyFactor inv_n_factors64[2];
+      MultiplyFactor scaled_inv_n_factors[2];
+      ComputeInvNFactors(n, modulus, inv_w, 1, 64, inv_n_factors64);
+      ScaleInvNFactors(inv_n_factors64, scalar, modulus, bit_shift,
+                       scaled_inv_n_factors);
+      for (size_t i = 0; i < 2; ++i) {
+        EXPECT_EQ(scaled_inv_n_factors[i].Operand(),
+                  inv_n_factors[i].Operand());
+        EXPECT_EQ(scaled_inv_n_factors[i].BarrettFactor(),
+                  inv_n_factors[i].BarrettFactor());
+      }
+    }
+  }
+}
+
+TEST(NTT, FourStepNumRows) {
+  uint64_t l1_size = 48 * 1024;
+  uint64_t l2_size = 2 * 1024 * 1024;
+
+  // Fewest rows such that each row transform fits in the L2 cache
+  EXPECT_EQ(FourStepNumRows(1ULL << 16, l1_size, l2_size), 2ULL);
+  EXPECT_EQ(FourStepNumRows(1ULL << 20, l1_size, l2_size), 16ULL);
+  EXPECT_EQ(FourStepNumRows(1ULL << 22, l1_size, l2_size), 64ULL);
+
+  // Limited by the tile of columns fitting in half of the L1 cache
+  EXPECT_EQ(FourStepNumRows(1ULL << 24, l1_size, l2_size), 64ULL);
+
+  // Limited by the rows holding at least 16 elements
+  EXPECT_EQ(FourStepNumRows(64, l1_size, 0), 4ULL);
+}
 
 }  // namespace hexl
 }  // namespace intel
@@ -0,0 +1,90 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hexl/ntt/ntt.hpp"
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/numa-allocator.hpp"
+#include "test-util.hpp"
+
+namespace intel {
+namespace hexl {
+
+TEST(NumaAllocator, nodes) {
+  int num_nodes = NumaAllocator::NumNodes();
+  ASSERT_GE(num_nodes, 1);
+  int node = NumaAllocator::CurrentNode();
+  ASSERT_GE(node, 0);
+  ASSERT_LT(node, num_nodes);
+}
+
+TEST(NumaAllocator, alloc) {
+  std::vector<int> nodes{NumaAllocator::s_first_touch_node,
+                         NumaAllocator::CurrentNode()};
+  for (int node : nodes) {
+    NumaAllocator alloc(node);
+    ASSERT_EQ(alloc.Node(), node);
+    for (size_t bytes : {1, 100, 4096, 100000}) {
+      void* p = alloc.allocate(bytes);
+      ASSERT_NE(p, nullptr);
+      std::memset(p, 0xff, bytes);
+      alloc.deallocate(p, bytes);
+    }
+  }
+}
+
+#ifdef __linux__
+// Memory on a node which does not exist is still usable, and the failure to
+// bind it is counted
+TEST(NumaAllocator, bind_failure) {
+  NumaAllocator alloc(1000);
+  void* p = alloc.allocate(100000);
+  ASSERT_NE(p, nullptr);
+  std::memset(p, 0xff, 100000);
+  alloc.deallocate(p, 100000);
+  ASSERT_EQ(alloc.NumBindFailures(), 1);
+}
+#endif
+
+TEST(NumaAllocator, AlignedVector64) {
+  auto alloc = std::make_shared<NumaAllocator>(NumaAllocator::CurrentNode());
+  AlignedVector64<uint64_t> x({1, 2, 3, 4},
+                              AlignedAllocator<uint64_t, 64>(alloc));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(x.data()) % 64, 0);
+  ASSERT_EQ(x, (AlignedVector64<uint64_t>{1, 2, 3, 4}));
+}
+
+TEST(NumaAllocator, NTTReplicas) {
+  uint64_t N = 1024;
+  uint64_t modulus = GeneratePrimes(1, 50, N)[0];
+  std::vector<uint64_t> input(N);
+  for (size_t i = 0; i < N; ++i) {
+    input[i] = i;
+  }
+
+  NTT ntt(N, modulus);
+  std::vector<uint64_t> expected(N);
+  ntt.ComputeForward(expected.data(), input.data(), 1, 1);
+
+  NTT replicated_ntt(N, modulus);
+  replicated_ntt.ReplicateTablesPerNumaNode();
+  NTT& local = replicated_ntt.GetNumaLocalReplica();
+  ASSERT_EQ(local.GetRootOfUnityPowers(), ntt.GetRootOfUnityPowers());
+  if (NumaAllocator::NumNodes() == 1) {
+    ASSERT_EQ(&local, &replicated_ntt);
+  }
+
+  std::vector<uint64_t> output(N);
+  replicated_ntt.ComputeForward(output.data(), input.data(), 1, 1);
+  AssertEqual(output, expected);
+  replicated_ntt.ComputeInverse(output.data(), output.data(), 1, 1);
+  AssertEqual(output, input);
+}
+
+}  // namespace hexl
+}  // namespace intel
@@ -1,11 +1,15 @@
 // Copyright (C) 2020-2021 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "hexl/number-theory/number-theory.hpp"
 #include "hexl/util/compiler.hpp"
+#include "number-theory/number-theory-avx256.hpp"
+#include "number-theory/number-theory-avx512.hpp"
+#include "number-theory/number-theory-internal.hpp"
 
 namespace intel {
 namespace hexl {
@@ -117,6 +121,28 @@ TEST(NumberTheory, PowMod) {
   ASSERT_EQ(39418477653ULL, PowMod(2424242424, 16, modulus));
 }
 
+TEST(NumberTheory, PowModVector) {
+  std::vector<uint64_t> moduli{5, 0x1000000000000000ULL, 131313131313ULL,
+                               0xffffffffffc0001ULL, 0xffffffffffffffc5ULL};
+  std::vector<uint64_t> exps{0, 1, 2, 16, 12345, 0xFFFFFFFFFFFFFFFFULL};
+  for (uint64_t modulus : moduli) {
+    std::vector<uint64_t> base{0, 1, 2, 3, modulus / 2, modulus - 1};
+    for (uint64_t exp : exps) {
+      std::vector<uint64_t> result(base.size());
+      PowModVector(result.data(), base.data(), exp, base.size(), modulus);
+      for (size_t i = 0; i < base.size(); ++i) {
+        ASSERT_EQ(result[i], PowMod(base[i], exp, modulus));
+      }
+
+      // In-place
+      std::vector<uint64_t> in_place = base;
+      PowModVector(in_place.data(), in_place.data(), exp, in_place.size(),
+                   modulus);
+      ASSERT_EQ(in_place, result);
+    }
+  }
+}
+
 TEST(NumberTheory, IsPowerOfTwo) {
   std::vector<uint64_t> powers_of_two{1,   2,    4,    8,    16,    32,
                                       512, 1024, 2048, 4096, 16384, 32768};
@@ -166,6 +192,38 @@ TEST(NumberTheory, MinimalPrimitiveRoot) {
   ASSERT_EQ(249725733ULL, MinimalPrimitiveRoot(8, modulus));
 }
 
+TEST(NumberTheory, GeneratePrimitiveRoot) {
+  for (uint64_t degree = 2; degree <= 4096; degree *= 2) {
+    for (uint64_t modulus : GeneratePrimes(3, 50, degree)) {
+      uint64_t root = GeneratePrimitiveRoot(degree, modulus);
+      ASSERT_TRUE(IsPrimitiveRoot(root, degree, modulus));
+      ASSERT_EQ(root, GeneratePrimitiveRoot(degree, modulus));
+    }
+  }
+  // 2^64 - 59 == 2 * m + 1 with m odd
+  ASSERT_EQ(0xffffffffffffffc4ULL,
+            GeneratePrimitiveRoot(2, 0xffffffffffffffc5ULL));
+}
+
+TEST(NumberTheory, MinimalPrimitiveRootExhaustive) {
+  // Compare against the minimum over all odd powers of a primitive root
+  for (uint64_t degree = 2; degree <= 1024; degree *= 2) {
+    for (uint64_t modulus : GeneratePrimes(2, 40, degree)) {
+      uint64_t root = GeneratePrimitiveRoot(degree, modulus);
+      uint64_t root_sq = MultiplyMod(root, root, modulus);
+      uint64_t expected = root;
+      for (uint64_t i = 0, power = root; i < degree / 2; ++i) {
+        expected = std::min(expected, power);
+        power = MultiplyMod(power, root_sq, modulus);
+      }
+      ASSERT_EQ(expected, MinimalPrimitiveRoot(degree, modulus));
+    }
+  }
+  uint64_t modulus = GeneratePrimes(1, 62, 1024)[0];
+  ASSERT_TRUE(IsPrimitiveRoot(MinimalPrimitiveRoot(2048, modulus), 2048,
+                              modulus));
+}
+
 TEST(NumberTheory, InverseMod) {
   uint64_t input;
   uint64_t modulus;
@@ -197,6 +255,32 @@ TEST(NumberTheory, InverseMod) {
   ASSERT_EQ(5ULL, InverseMod(input, modulus));
 }
 
+TEST(NumberTheory, BatchInverseMod) {
+  std::vector<uint64_t> moduli{2, 19, 1024, 0xffffee001ULL,
+                               0xffffffffffc0001ULL, 0xffffffffffffffc5ULL};
+  for (uint64_t modulus : moduli) {
+    std::vector<uint64_t> operand;
+    for (uint64_t x = 1; x < 100 && x < modulus; ++x) {
+      if (modulus % 2 == 1 || x % 2 == 1) {
+        operand.push_back(modulus - x);
+        operand.push_back(x);
+      }
+    }
+    for (size_t n : {size_t(1), size_t(2), operand.size()}) {
+      std::vector<uint64_t> result(n);
+      BatchInverseMod(result.data(), operand.data(), n, modulus);
+      for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(result[i], InverseMod(operand[i], modulus));
+      }
+
+      // In-place
+      std::vector<uint64_t> in_place(operand.begin(), operand.begin() + n);
+      BatchInverseMod(in_place.data(), in_place.data(), n, modulus);
+      ASSERT_EQ(in_place, result);
+    }
+  }
+}
+
 TEST(NumberTheory, ReverseBits64) {
   ASSERT_EQ(0ULL, ReverseBits(0ULL, 0));
   ASSERT_EQ(0ULL, ReverseBits(0ULL, 1));
@@ -216,8 +300,51 @@ TEST(NumberTheory, ReverseBits64) {
 
   ASSERT_EQ(0x0000FFFFFFFF0000ULL, ReverseBits(0x0000FFFFFFFF0000ULL, 64));
   ASSERT_EQ(0x0000FFFF0000FFFFULL, ReverseBits(0xFFFF0000FFFF0000ULL, 64));
+
+  ASSERT_EQ(0xBULL, ReverseBits(0xDULL, 4));
+  ASSERT_EQ(0x34ULL, ReverseBits(0xBULL, 6));
+  ASSERT_EQ(0x18000ULL, ReverseBits(0x3ULL, 17));
+  ASSERT_EQ(0x1E6A2C48ULL, ReverseBits(0x12345678ULL, 32));
+}
+
+TEST(NumberTheory, BitReversePermutationIndices) {
+  for (uint64_t n = 1; n <= (1ULL << 12); n *= 2) {
+    std::vector<uint64_t> indices = BitReversePermutationIndices(n);
+    std::vector<uint64_t> native_indices(n, 0);
+    BitReversePermutationIndicesNative(native_indices.data(), n);
+
+    ASSERT_EQ(n, indices.size());
+    for (uint64_t i = 0; i < n; ++i) {
+      ASSERT_EQ(ReverseBits(i, Log2(n)), indices[i]) << "n " << n << " i " << i;
+      ASSERT_EQ(indices[i], native_indices[i]) << "n " << n << " i " << i;
+    }
+  }
 }
 
+#ifdef HEXL_HAS_AVX512DQ
+TEST(NumberTheory, BitReversePermutationIndicesAVX512) {
+  for (uint64_t n = 8; n <= (1ULL << 12); n *= 2) {
+    std::vector<uint64_t> avx512_indices(n, 0);
+    std::vector<uint64_t> native_indices(n, 0);
+    BitReversePermutationIndicesAVX512(avx512_indices.data(), n);
+    BitReversePermutationIndicesNative(native_indices.data(), n);
+    ASSERT_EQ(avx512_indices, native_indices) << "n " << n;
+  }
+}
+#endif
+
+#ifdef HEXL_HAS_AVX256
+TEST(NumberTheory, BitReversePermutationIndicesAVX256) {
+  for (uint64_t n = 4; n <= (1ULL << 12); n *= 2) {
+    std::vector<uint64_t> avx256_indices(n, 0);
+    std::vector<uint64_t> native_indices(n, 0);
+    BitReversePermutationIndicesAVX256(avx256_indices.data(), n);
+    BitReversePermutationIndicesNative(native_indices.data(), n);
+    ASSERT_EQ(avx256_indices, native_indices) << "n " << n;
+  }
+}
+#endif
+
 TEST(NumberTheory, MultiplyModLazy64) {
   uint64_t modulus = 2;
   uint64_t y = 0;
@@ -308,9 +435,51 @@ TEST(NumberTheory, IsPrime) {
   ASSERT_TRUE(IsPrime(0xffffffffffc0001ULL));
   ASSERT_TRUE(IsPrime(0xffffee001));
 
+  ASSERT_TRUE(IsPrime(0x1fffffffffffffffULL));
+  ASSERT_TRUE(IsPrime(0xffffffffffffffc5ULL));
+
+  ASSERT_FALSE(IsPrime(0));
+  ASSERT_FALSE(IsPrime(1));
+  ASSERT_FALSE(IsPrime(561));  // Carmichael number
   ASSERT_FALSE(IsPrime(72307ULL * 59399ULL));
   ASSERT_FALSE(IsPrime(2305843009211596802ULL));
   ASSERT_FALSE(IsPrime(36893488147419107ULL));
+  ASSERT_FALSE(IsPrime(0xffffffffffffffffULL));
+}
+
+TEST(NumberTheory, IsPrimeTrialDivision) {
+  auto trial_division = [](uint64_t n) {
+    if (n < 2) return false;
+    for (uint64_t d = 2; d * d <= n; ++d) {
+      if (n % d == 0) return false;
+    }
+    return true;
+  };
+  for (uint64_t n = 0; n < 20000; ++n) {
+    ASSERT_EQ(IsPrime(n), trial_division(n)) << n;
+  }
+}
+
+TEST(NumberTheory, MontgomeryModulus) {
+  std::vector<uint64_t> moduli{3, 769, 0xffffee001ULL, 0xffffffffffc0001ULL,
+                               0xffffffffffffffc5ULL};
+  for (uint64_t modulus : moduli) {
+    MontgomeryModulus mont(modulus);
+    ASSERT_EQ(mont.FromMontgomery(mont.One()), 1);
+    std::vector<uint64_t> xs{0, 1, 2, modulus / 3, modulus - 1};
+    std::vector<uint64_t> ys{1, 5, modulus / 2, modulus - 2};
+    for (uint64_t x : xs) {
+      for (uint64_t y : ys) {
+        uint64_t x_mont = mont.ToMontgomery(x);
+        uint64_t y_mont = mont.ToMontgomery(y);
+        ASSERT_EQ(mont.FromMontgomery(x_mont), x % modulus);
+        ASSERT_EQ(mont.FromMontgomery(mont.Multiply(x_mont, y_mont)),
+                  MultiplyMod(x % modulus, y % modulus, modulus));
+        ASSERT_EQ(mont.FromMontgomery(mont.Pow(x_mont, y)),
+                  PowMod(x, y, modulus));
+      }
+    }
+  }
 }
 
 TEST(NumberTheory, GeneratePrimes) {
@@ -326,6 +495,68 @@ TEST(NumberTheory, GeneratePrimes) {
   }
 }
 
+TEST(NumberTheory, GeneratePrimesDirection) {
+  size_t bit_size = 20;
+  size_t ntt_size = 16;
+  uint64_t lower = 1ULL << bit_size;
+  uint64_t upper = 1ULL << (bit_size + 1);
+
+  std::vector<uint64_t> all_primes;
+  for (uint64_t q = lower + 1; q < upper; q += 2 * ntt_size) {
+    if (IsPrime(q)) {
+      all_primes.push_back(q);
+    }
+  }
+  size_t num_primes = all_primes.size();
+
+  GeneratePrimesOptions options;
+  EXPECT_EQ(GeneratePrimes(num_primes, bit_size, ntt_size, options),
+            all_primes);
+
+  options.direction = PrimeSearchDirection::Downward;
+  std::vector<uint64_t> downward(all_primes.rbegin(), all_primes.rend());
+  EXPECT_EQ(GeneratePrimes(num_primes, bit_size, ntt_size, options), downward);
+
+  options.direction = PrimeSearchDirection::Nearest;
+  for (uint64_t target : {lower, lower + 12345, upper - 777, upper - 1}) {
+    options.target = target;
+    std::vector<uint64_t> nearest = all_primes;
+    std::stable_sort(nearest.begin(), nearest.end(),
+                     [target](uint64_t x, uint64_t y) {
+                       uint64_t dx = x > target ? x - target : target - x;
+                       uint64_t dy = y > target ? y - target : target - y;
+                       return dx < dy;
+                     });
+    EXPECT_EQ(GeneratePrimes(num_primes, bit_size, ntt_size, options),
+              nearest);
+  }
+}
+
+TEST(NumberTheory, GeneratePrimesThreads) {
+  for (auto direction :
+       {PrimeSearchDirection::Upward, PrimeSearchDirection::Downward,
+        PrimeSearchDirection::Nearest}) {
+    GeneratePrimesOptions options;
+    options.direction = direction;
+    options.target = (1ULL << 50) + (1ULL << 40);
+
+    std::vector<uint64_t> expected = GeneratePrimes(20, 50, 1024, options);
+    ASSERT_EQ(expected.size(), 20);
+    for (const auto& prime : expected) {
+      ASSERT_EQ(prime % 2048, 1);
+      ASSERT_TRUE(IsPrime(prime));
+    }
+    if (direction == PrimeSearchDirection::Upward) {
+      EXPECT_EQ(expected, GeneratePrimes(20, 50, 1024));
+    }
+
+    for (size_t num_threads : {0, 2, 3, 8}) {
+      options.num_threads = num_threads;
+      EXPECT_EQ(GeneratePrimes(20, 50, 1024, options), expected);
+    }
+  }
+}
+
 TEST(NumberTheory, AddUInt64) {
   uint64_t result;
   EXPECT_EQ(0, AddUInt64(1, 0, &result));
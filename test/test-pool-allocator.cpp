@@ -0,0 +1,180 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hexl/ntt/ntt.hpp"
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/aligned-allocator.hpp"
+#include "hexl/util/pool-allocator.hpp"
+#include "test-util.hpp"
+
+namespace intel {
+namespace hexl {
+
+TEST(PoolAllocator, alignment) {
+  PoolAllocator pool(4096);
+  std::vector<std::pair<void*, size_t>> blocks;
+  for (size_t bytes : {0, 1, 63, 64, 65, 1000, 4096, 10000}) {
+    void* p = pool.allocate(bytes);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+    blocks.emplace_back(p, bytes);
+  }
+  ASSERT_EQ(pool.NumOutstanding(), blocks.size());
+
+  for (const auto& block : blocks) {
+    pool.deallocate(block.first, block.second);
+  }
+  ASSERT_EQ(pool.NumOutstanding(), 0);
+}
+
+TEST(PoolAllocator, reuse) {
+  PoolAllocator pool;
+  void* p1 = pool.allocate(1000);
+  void* p2 = pool.allocate(2000);
+  ASSERT_NE(p1, p2);
+
+  // Blocks are recycled within their size class only
+  pool.deallocate(p1, 1000);
+  ASSERT_EQ(pool.allocate(990), p1);
+  pool.deallocate(p2, 2000);
+  ASSERT_NE(pool.allocate(1000), p2);
+  ASSERT_EQ(pool.allocate(2000), p2);
+}
+
+TEST(PoolAllocator, reset) {
+  PoolAllocator pool(1 << 16);
+  void* first = pool.allocate(100);
+  void* second = pool.allocate(100);
+  size_t reserved = pool.BytesReserved();
+  pool.deallocate(first, 100);
+  pool.deallocate(second, 100);
+
+  pool.Reset();
+  ASSERT_EQ(pool.allocate(100), first);
+  ASSERT_EQ(pool.allocate(100), second);
+  ASSERT_EQ(pool.BytesReserved(), reserved);
+  pool.deallocate(first, 100);
+  pool.deallocate(second, 100);
+
+  pool.Release();
+  ASSERT_EQ(pool.BytesReserved(), 0);
+}
+
+// Resetting or releasing with live blocks throws, in release builds too
+TEST(PoolAllocator, reset_outstanding) {
+  PoolAllocator pool(1 << 16);
+  void* block = pool.allocate(100);
+  EXPECT_THROW(pool.Reset(), std::runtime_error);
+  EXPECT_THROW(pool.Release(), std::runtime_error);
+  ASSERT_EQ(pool.NumOutstanding(), 1);
+  ASSERT_NE(pool.allocate(100), block);
+
+  pool.deallocate(block, 100);
+  ASSERT_EQ(pool.allocate(100), block);
+}
+
+TEST(PoolAllocator, large_block) {
+  PoolAllocator pool(4096);
+  void* small = pool.allocate(64);
+  void* large = pool.allocate(1 << 20);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0);
+  ASSERT_GE(pool.BytesReserved(), 4096 + (1 << 20));
+  pool.deallocate(small, 64);
+  pool.deallocate(large, 1 << 20);
+}
+
+// Space left in a chunk is used by later blocks, after larger blocks have
+// needed a new or dedicated chunk
+TEST(PoolAllocator, chunk_space_reuse) {
+  PoolAllocator pool(4096);
+  char* first = static_cast<char*>(pool.allocate(3000));
+  void* second = pool.allocate(2000);
+  void* large = pool.allocate(1 << 20);
+  ASSERT_EQ(pool.BytesReserved(), 2 * 4096 + (1 << 20));
+
+  void* third = pool.allocate(1000);
+  ASSERT_EQ(third, first + 3008);
+  ASSERT_EQ(pool.BytesReserved(), 2 * 4096 + (1 << 20));
+
+  pool.deallocate(first, 3000);
+  pool.deallocate(second, 2000);
+  pool.deallocate(large, 1 << 20);
+  pool.deallocate(third, 1000);
+}
+
+// Deallocating a block the pool cannot have allocated throws, in release
+// builds too
+TEST(PoolAllocator, deallocate_unknown) {
+  PoolAllocator pool(4096);
+  void* block = pool.allocate(100);
+  EXPECT_THROW(pool.deallocate(block, 1000), std::runtime_error);
+  ASSERT_EQ(pool.NumOutstanding(), 1);
+  pool.deallocate(block, 100);
+  EXPECT_THROW(pool.deallocate(block, 100), std::runtime_error);
+  ASSERT_EQ(pool.NumOutstanding(), 0);
+}
+
+TEST(PoolAllocator, thread_local_pool) {
+  std::shared_ptr<PoolAllocator> pool = PoolAllocator::ThreadLocal();
+  ASSERT_EQ(pool, PoolAllocator::ThreadLocal());
+
+  std::shared_ptr<PoolAllocator> other_pool;
+  std::thread thread(
+      [&other_pool]() { other_pool = PoolAllocator::ThreadLocal(); });
+  thread.join();
+  ASSERT_NE(other_pool, nullptr);
+  ASSERT_NE(pool, other_pool);
+}
+
+TEST(PoolAllocator, AlignedVector64) {
+  auto pool = std::make_shared<PoolAllocator>();
+  AlignedAllocator<uint64_t, 64> alloc(pool);
+  const uint64_t* data = nullptr;
+  {
+    AlignedVector64<uint64_t> x({1, 2, 3, 4}, alloc);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(x.data()) % 64, 0);
+    AlignedVector64<uint64_t> y = x;
+    ASSERT_EQ(x, y);
+    ASSERT_EQ(pool->NumOutstanding(), 2);
+    data = x.data();
+  }
+  ASSERT_EQ(pool->NumOutstanding(), 0);
+
+  // A vector of the same size reuses a block
+  AlignedVector64<uint64_t> z(4, 0, alloc);
+  ASSERT_EQ(pool->NumOutstanding(), 1);
+  ASSERT_EQ(z.data(), data);
+}
+
+TEST(PoolAllocator, NTT) {
+  uint64_t N = 1024;
+  uint64_t modulus = GeneratePrimes(1, 50, N)[0];
+  std::vector<uint64_t> input(N);
+  for (size_t i = 0; i < N; ++i) {
+    input[i] = i;
+  }
+  std::vector<uint64_t> expected = input;
+  NTT(N, modulus).ComputeForward(expected.data(), expected.data(), 1, 1);
+
+  auto pool = PoolAllocator::ThreadLocal();
+  for (size_t trial = 0; trial < 2; ++trial) {
+    {
+      NTT ntt(N, modulus, pool);
+      ASSERT_GT(pool->NumOutstanding(), 0);
+      std::vector<uint64_t> output(N);
+      ntt.ComputeForward(output.data(), input.data(), 1, 1);
+      AssertEqual(output, expected);
+    }
+    ASSERT_EQ(pool->NumOutstanding(), 0);
+    pool->Reset();
+  }
+}
+
+}  // namespace hexl
+}  // namespace intel
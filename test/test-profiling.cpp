@@ -0,0 +1,86 @@
+// Copyright (C) 2020-2021 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hexl/eltwise/eltwise-add-mod.hpp"
+#include "hexl/eltwise/eltwise-mult-mod.hpp"
+#include "hexl/ntt/ntt.hpp"
+#include "hexl/number-theory/number-theory.hpp"
+#include "hexl/util/profiling.hpp"
+
+namespace intel {
+namespace hexl {
+
+// Returns the counters of the first kernel variant whose name starts with
+// prefix, or zeroed counters if there is none
+profiling::KernelStats FindKernelStats(const std::string& prefix) {
+  profiling::KernelStats total;
+  for (const auto& stats : profiling::GetKernelStats()) {
+    if (stats.name.compare(0, prefix.size(), prefix) == 0) {
+      total = stats;
+      break;
+    }
+  }
+  return total;
+}
+
+TEST(Profiling, Disabled) {
+  if (profiling::IsEnabled()) {
+    GTEST_SKIP();
+  }
+  std::vector<uint64_t> op(8, 1);
+  EltwiseAddMod(op.data(), op.data(), op.data(), op.size(), 7);
+  EXPECT_TRUE(profiling::GetKernelStats().empty());
+  EXPECT_EQ(profiling::Report(profiling::ReportFormat::JSON), "[]\n");
+}
+
+TEST(Profiling, Counters) {
+  if (!profiling::IsEnabled()) {
+    GTEST_SKIP();
+  }
+  uint64_t N = 1024;
+  uint64_t modulus = GeneratePrimes(1, 50, N)[0];
+  NTT ntt(N, modulus);
+  std::vector<uint64_t> op(N, 1);
+  std::vector<uint64_t> multiplicand(N, 2);
+
+  profiling::Reset();
+  for (size_t i = 0; i < 3; ++i) {
+    ntt.ComputeForward(op.data(), op.data(), 1, 1);
+  }
+  // Records no EltwiseMultMod calls
+  ntt.ComputeForwardMultiply(op.data(), op.data(), multiplicand.data(), 1);
+  EltwiseMultMod(op.data(), op.data(), op.data(), N, modulus, 1);
+  EltwiseMultMod(op.data(), op.data(), op.data(), N / 2, modulus, 1);
+
+  profiling::KernelStats fwd_stats = FindKernelStats("NTT::ComputeForward/");
+  EXPECT_EQ(fwd_stats.num_calls, 3);
+  EXPECT_EQ(fwd_stats.num_elements, 3 * N);
+  EXPECT_GT(fwd_stats.num_cycles, 0);
+
+  profiling::KernelStats fwd_mult_stats =
+      FindKernelStats("NTT::ComputeForwardMultiply/");
+  EXPECT_EQ(fwd_mult_stats.num_calls, 1);
+  EXPECT_EQ(fwd_mult_stats.num_elements, N);
+
+  profiling::KernelStats mult_stats = FindKernelStats("EltwiseMultMod/");
+  EXPECT_EQ(mult_stats.num_calls, 2);
+  EXPECT_EQ(mult_stats.num_elements, N + N / 2);
+
+  EXPECT_EQ(FindKernelStats("NTT::ComputeInverse/").num_calls, 0);
+
+  std::string table = profiling::Report();
+  EXPECT_NE(table.find(fwd_stats.name), std::string::npos);
+  std::string json = profiling::Report(profiling::ReportFormat::JSON);
+  EXPECT_NE(json.find("\"name\": \"" + mult_stats.name + "\""),
+            std::string::npos);
+
+  profiling::Reset();
+  EXPECT_TRUE(profiling::GetKernelStats().empty());
+}
+
+}  // namespace hexl
+}  // namespace intel
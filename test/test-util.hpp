@@ -4,11 +4,14 @@
 #pragma once
 
 #include <limits>
+#include <random>
 #include <vector>
 
 #include "hexl/logging/logging.hpp"
+#include "hexl/util/aligned-allocator.hpp"
 #include "hexl/util/check.hpp"
 #include "util/avx512-util.hpp"
+#include "util/isa-target.hpp"
 
 namespace intel {
 namespace hexl {
@@ -33,7 +36,43 @@ inline void AssertEqual(const std::vector<T>& x, const std::vector<T>& y) {
   }
 }
 
+// Asserts that an AVX512 kernel matches its native counterpart for lengths 1
+// to 19 at offsets 0, 1 and 3 words from a 64-byte boundary, i.e. with
+// unaligned heads and masked tails, and writes no element beyond the length.
+// Each kernel is called as kernel(result, op1, op2, n), with op1 and op2
+// pointing to at least 28 random words in [0, max_input]. Kernels taking
+// scalar arguments may read them from op1 or op2
+template <typename NativeKernel, typename AVX512Kernel>
+inline void CheckUnalignedTail(uint64_t max_input, NativeKernel native,
+                               AVX512Kernel avx512) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<uint64_t> distrib(0, max_input);
+
+  const uint64_t sentinel = std::numeric_limits<uint64_t>::max();
+  AlignedVector64<uint64_t> op1(32, 0);
+  AlignedVector64<uint64_t> op2(32, 0);
+  for (size_t offset : {0, 1, 3}) {
+    for (uint64_t n = 1; n <= 19; ++n) {
+      for (size_t i = 0; i < op1.size(); ++i) {
+        op1[i] = distrib(gen);
+        op2[i] = distrib(gen);
+      }
+      AlignedVector64<uint64_t> expected(32, sentinel);
+      AlignedVector64<uint64_t> result(32, sentinel);
+
+      native(expected.data() + offset, op1.data() + offset,
+             op2.data() + offset, n);
+      avx512(result.data() + offset, op1.data() + offset, op2.data() + offset,
+             n);
+      ASSERT_EQ(result, expected) << "n " << n << " offset " << offset;
+    }
+  }
+}
+
 #ifdef HEXL_HAS_AVX512DQ
+HEXL_BEGIN_TARGET_AVX512
+
 inline void CheckEqual(const __m512i a, const __m512i b) {
   std::vector<uint64_t> as = ExtractValues(a);
   std::vector<uint64_t> bs = ExtractValues(b);
@@ -45,6 +84,8 @@ inline void AssertEqual(const __m512i a, const __m512i b) {
   std::vector<uint64_t> bs = ExtractValues(b);
   AssertEqual(as, bs);
 }
+
+HEXL_END_TARGET
 #endif
 
 }  // namespace hexl